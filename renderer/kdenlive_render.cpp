@@ -21,6 +21,7 @@
 #include <QCoreApplication>
 #include <QStringList>
 #include <QFileInfo>
+#include <QPoint>
 #include <QString>
 #include <QUrl>
 #include <QDebug>
@@ -58,6 +59,18 @@ int main(int argc, char **argv)
             locale = args.at(0).section(QLatin1Char(':'), 1);
             args.removeFirst();
         }
+        QString ffmpeg;
+        if (args.at(0).startsWith(QLatin1String("-ffmpeg:"))) {
+            // Everything after "-ffmpeg:", the path may contain ':' (drive letters)
+            ffmpeg = args.takeFirst().mid(8);
+        }
+        QList<QPoint> segments;
+        if (args.at(0).startsWith(QLatin1String("-segments:"))) {
+            const QStringList ranges = args.takeFirst().section(QLatin1Char(':'), 1).split(QLatin1Char(','), QString::SkipEmptyParts);
+            for (const QString &range : ranges) {
+                segments << QPoint(range.section(QLatin1Char('-'), 0, 0).toInt(), range.section(QLatin1Char('-'), 1, 1).toInt());
+            }
+        }
         if (args.at(0).startsWith(QLatin1String("in="))) {
             in = args.takeFirst().section(QLatin1Char('='), -1).toInt();
         }
@@ -124,6 +137,9 @@ int main(int argc, char **argv)
         if (!locale.isEmpty()) {
             job->setLocale(locale);
         }
+        if (!dualpass && segments.count() > 1 && !ffmpeg.isEmpty()) {
+            job->setSegments(segments, ffmpeg);
+        }
         job->start();
         RenderJob *dualjob = nullptr;
         if (dualpass) {
@@ -138,10 +154,12 @@ int main(int argc, char **argv)
         delete dualjob;
     } else {
         fprintf(stderr, "Kdenlive video renderer for MLT.\nUsage: "
-                "kdenlive_render [-erase] [-kuiserver] [-locale:LOCALE] [in=pos] [out=pos] [render] [profile] [rendermodule] [player] [src] [dest] [[arg1] [arg2] ...]\n"
+                "kdenlive_render [-erase] [-kuiserver] [-locale:LOCALE] [-ffmpeg:FFMPEG] [-segments:IN-OUT,...] [in=pos] [out=pos] [render] [profile] [rendermodule] [player] [src] [dest] [[arg1] [arg2] ...]\n"
                 "  -erase: if that parameter is present, src file will be erased at the end\n"
                 "  -kuiserver: if that parameter is present, use KDE job tracker\n"
                 "  -locale:LOCALE : set a locale for rendering. For example, -locale:fr_FR.UTF-8 will use a french locale (comma as numeric separator)\n"
+                "  -ffmpeg:FFMPEG : path to the ffmpeg program used to join the segments\n"
+                "  -segments:IN-OUT,... : render these frame ranges in parallel, then join them without re-encoding\n"
                 "  in=pos: start rendering at frame pos\n"
                 "  out=pos: end rendering at frame pos\n"
                 "  render: path to MLT melt renderer\n"
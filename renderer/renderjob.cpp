@@ -21,6 +21,7 @@
 
 #include <QtDBus>
 #include <QFile>
+#include <QFileInfo>
 #include <QThread>
 #include <QStringList>
 
@@ -50,7 +51,13 @@ RenderJob::RenderJob(bool erase, bool usekuiserver, int pid, const QString &rend
     m_seconds(0),
     m_frame(0),
     m_pid(pid),
-    m_dualpass(false)
+    m_dualpass(false),
+    m_profile(profile),
+    m_rendermodule(rendermodule),
+    m_preargs(preargs),
+    m_consumerArgs(args),
+    m_segmentDir(nullptr),
+    m_segmentsStopped(false)
 {
     m_renderProcess = new QProcess;
     m_renderProcess->setReadChannel(QProcess::StandardError);
@@ -59,21 +66,7 @@ RenderJob::RenderJob(bool erase, bool usekuiserver, int pid, const QString &rend
     // Disable VDPAU so that rendering will work even if there is a Kdenlive instance using VDPAU
     qputenv("MLT_NO_VDPAU", "1");
 
-    m_args << scenelist;
-    if (in != -1) {
-        m_args << QStringLiteral("in=") + QString::number(in);
-    }
-    if (out != -1) {
-        m_args << QStringLiteral("out=") + QString::number(out);
-    }
-
-    m_args << preargs;
-    if (scenelist.startsWith(QLatin1String("consumer:"))) {
-        // Use MLT's producer_consumer, safer to pass profile in an explicit way
-        m_args << QStringLiteral("profile=") + profile;
-    }
-    m_args << QStringLiteral("-profile") << profile;
-    m_args << QStringLiteral("-consumer") << rendermodule + QLatin1Char(':') + m_dest << QStringLiteral("progress=1") << args;
+    m_args = renderArgs(in, out, m_dest);
 
     m_dualpass = args.contains(QStringLiteral("pass=1"));
 
@@ -88,6 +81,7 @@ RenderJob::RenderJob(bool erase, bool usekuiserver, int pid, const QString &rend
 RenderJob::~RenderJob()
 {
     delete m_renderProcess;
+    delete m_segmentDir;
     m_logfile.close();
 }
 
@@ -96,6 +90,67 @@ void RenderJob::setLocale(const QString &locale)
     qputenv("LC_NUMERIC", locale.toUtf8().constData());
 }
 
+QStringList RenderJob::renderArgs(int in, int out, const QString &dest, const QStringList &extraArgs) const
+{
+    QStringList args;
+    args << m_scenelist;
+    if (in != -1) {
+        args << QStringLiteral("in=") + QString::number(in);
+    }
+    if (out != -1) {
+        args << QStringLiteral("out=") + QString::number(out);
+    }
+
+    args << m_preargs;
+    if (m_scenelist.startsWith(QLatin1String("consumer:"))) {
+        // Use MLT's producer_consumer, safer to pass profile in an explicit way
+        args << QStringLiteral("profile=") + m_profile;
+    }
+    args << QStringLiteral("-profile") << m_profile;
+    args << QStringLiteral("-consumer") << m_rendermodule + QLatin1Char(':') + dest << QStringLiteral("progress=1") << m_consumerArgs << extraArgs;
+    return args;
+}
+
+void RenderJob::setSegments(const QList<QPoint> &segments, const QString &ffmpeg)
+{
+    removeSegments();
+    m_segments.clear();
+    if (segments.isEmpty()) {
+        return;
+    }
+    m_ffmpeg = ffmpeg;
+    QFileInfo info(m_dest);
+    // Keep the segments on the destination's file system, in a folder of our own so that no user file is overwritten
+    m_segmentDir = new QTemporaryDir(info.absolutePath() + QStringLiteral("/.kdenlive-segments-XXXXXX"));
+    if (!m_segmentDir->isValid()) {
+        m_logstream << "Cannot create segment folder in " << info.absolutePath() << ", rendering in one process" << endl;
+        delete m_segmentDir;
+        m_segmentDir = nullptr;
+        return;
+    }
+    const QString suffix = QLatin1Char('.') + info.suffix();
+    for (int i = 0; i < segments.count(); ++i) {
+        Segment segment;
+        segment.in = segments.at(i).x();
+        segment.out = segments.at(i).y();
+        segment.dest = m_segmentDir->path() + QStringLiteral("/segment%1").arg(i) + suffix;
+        segment.process = nullptr;
+        segment.progress = 0;
+        segment.audio = false;
+        m_segments << segment;
+    }
+    if (!m_consumerArgs.contains(QStringLiteral("an=1"))) {
+        Segment segment;
+        segment.in = segments.first().x();
+        segment.out = segments.last().y();
+        segment.dest = m_segmentDir->path() + QStringLiteral("/audio") + suffix;
+        segment.process = nullptr;
+        segment.progress = 0;
+        segment.audio = true;
+        m_segments << segment;
+    }
+}
+
 void RenderJob::slotAbort(const QString &url)
 {
     if (m_dest == url) {
@@ -107,6 +162,8 @@ void RenderJob::slotAbort()
 {
     qWarning() << "Job aborted by user...";
     m_renderProcess->kill();
+    stopSegments();
+    removeSegments();
 
     if (m_kdenliveinterface) {
         m_dbusargs[1] = -3;
@@ -144,25 +201,64 @@ void RenderJob::receivedStderr()
             m_progress = 50 + m_progress / 2.0;
         }
         int frame = result.section(QLatin1Char(','), 1).section(QLatin1Char(' '), -1).toInt();
-        if (m_kdenliveinterface && m_kdenliveinterface->isValid()) {
-            m_dbusargs[1] = m_progress;
-            m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingProgress"), m_dbusargs);
+        sendProgress(frame);
+    }
+}
+
+void RenderJob::receivedSegmentStderr(int ix)
+{
+    Segment &segment = m_segments[ix];
+    QString result = QString::fromLocal8Bit(segment.process->readAllStandardError()).simplified();
+    if (!result.startsWith(QLatin1String("Current Frame"))) {
+        m_errorMessage.append(result + QStringLiteral("<br>"));
+        return;
+    }
+    m_logstream << "melt segment " << ix << ": " << result << endl;
+    int pro = result.section(QLatin1Char(' '), -1).toInt();
+    if (pro <= segment.progress || pro > 100) {
+        return;
+    }
+    segment.progress = pro;
+    // Weight the progress of each segment by its length
+    qint64 done = 0;
+    qint64 total = 0;
+    for (const Segment &current : m_segments) {
+        if (current.audio) {
+            // Audio encoding is fast compared to video, don't count it
+            continue;
         }
-        if (m_jobUiserver) {
-            m_jobUiserver->call(QStringLiteral("setPercent"), (uint) m_progress);
-            int seconds = m_startTime.secsTo(QTime::currentTime());
-            if (seconds == m_seconds) {
-                return;
-            }
-            if (seconds < 0) {
-                seconds += 24 * 60 * 60;
-            }
-            m_jobUiserver->call(QStringLiteral("setDescriptionField"), (uint) 0,
-                                QString(), tr("Remaining time: ") + QTime(0, 0, 0).addSecs((int)(seconds * (100 - m_progress) / m_progress)).toString(QStringLiteral("hh:mm:ss")));
-            //m_jobUiserver->call("setSpeed", (frame - m_frame) / (seconds - m_seconds));
-            m_frame = frame;
-            m_seconds = seconds;
+        const int length = current.out - current.in + 1;
+        done += (qint64) length * current.progress;
+        total += length;
+    }
+    const int progress = total > 0 ? (int)(done / total) : 0;
+    if (progress <= m_progress) {
+        return;
+    }
+    m_progress = progress;
+    sendProgress((int)(done / 100));
+}
+
+void RenderJob::sendProgress(int frame)
+{
+    if (m_kdenliveinterface && m_kdenliveinterface->isValid()) {
+        m_dbusargs[1] = m_progress;
+        m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingProgress"), m_dbusargs);
+    }
+    if (m_jobUiserver) {
+        m_jobUiserver->call(QStringLiteral("setPercent"), (uint) m_progress);
+        int seconds = m_startTime.secsTo(QTime::currentTime());
+        if (seconds == m_seconds) {
+            return;
         }
+        if (seconds < 0) {
+            seconds += 24 * 60 * 60;
+        }
+        m_jobUiserver->call(QStringLiteral("setDescriptionField"), (uint) 0,
+                            QString(), tr("Remaining time: ") + QTime(0, 0, 0).addSecs((int)(seconds * (100 - m_progress) / m_progress)).toString(QStringLiteral("hh:mm:ss")));
+        //m_jobUiserver->call("setSpeed", (frame - m_frame) / (seconds - m_seconds));
+        m_frame = frame;
+        m_seconds = seconds;
     }
 }
 
@@ -213,10 +309,117 @@ void RenderJob::start()
 
     // Because of the logging, we connect to stderr in all cases.
     connect(m_renderProcess, &QProcess::readyReadStandardError, this, &RenderJob::receivedStderr);
+    if (!m_segments.isEmpty()) {
+        startSegments();
+        return;
+    }
     m_renderProcess->start(m_prog, m_args);
     m_logstream << "Started render process: " << m_prog << ' ' << m_args.join(QLatin1Char(' ')) << endl;
 }
 
+void RenderJob::startSegments()
+{
+    // The segment processes run in parallel, share the requested threads between them
+    QStringList threadArgs;
+    const int count = m_segments.count();
+    for (const QString &arg : m_consumerArgs) {
+        if (arg.startsWith(QLatin1String("threads="))) {
+            const int threads = arg.section(QLatin1Char('='), 1).toInt();
+            threadArgs << QStringLiteral("threads=") + QString::number(qMax(1, threads / count));
+        } else if (arg.startsWith(QLatin1String("real_time="))) {
+            const int realTime = arg.section(QLatin1Char('='), 1).toInt();
+            if (realTime < -1) {
+                threadArgs << QStringLiteral("real_time=") + QString::number(-qMax(1, -realTime / count));
+            }
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        Segment &segment = m_segments[i];
+        segment.process = new QProcess(this);
+        segment.process->setReadChannel(QProcess::StandardError);
+        connect(segment.process, &QProcess::readyReadStandardError, this, [this, i]() {
+            receivedSegmentStderr(i);
+        });
+        connect(segment.process, &QProcess::stateChanged, this, [this, i](QProcess::ProcessState state) {
+            checkSegment(i, state);
+        });
+        const QStringList args = renderArgs(segment.in, segment.out, segment.dest, QStringList() << threadArgs << (segment.audio ? QStringLiteral("vn=1") : QStringLiteral("an=1")));
+        segment.process->start(m_prog, args);
+        m_logstream << "Started segment render process: " << m_prog << ' ' << args.join(QLatin1Char(' ')) << endl;
+    }
+}
+
+void RenderJob::checkSegment(int ix, QProcess::ProcessState state)
+{
+    if (state != QProcess::NotRunning || m_segmentsStopped) {
+        return;
+    }
+    QProcess *process = m_segments.at(ix).process;
+    if (process->exitStatus() == QProcess::CrashExit || process->error() != QProcess::UnknownError || process->exitCode() != 0) {
+        m_logstream << "Rendering of segment " << ix << " failed" << endl;
+        stopSegments();
+        slotIsOver(QProcess::CrashExit);
+        return;
+    }
+    for (const Segment &segment : m_segments) {
+        if (segment.process->state() != QProcess::NotRunning) {
+            return;
+        }
+    }
+    concatenateSegments();
+}
+
+void RenderJob::concatenateSegments()
+{
+    QFile list(m_segmentDir->path() + QStringLiteral("/segments.txt"));
+    if (!list.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_errorMessage.append(tr("Cannot write to %1, check permissions.").arg(list.fileName()));
+        slotIsOver(QProcess::CrashExit);
+        return;
+    }
+    QTextStream stream(&list);
+    QString audioPath;
+    for (const Segment &segment : m_segments) {
+        if (segment.audio) {
+            audioPath = segment.dest;
+            continue;
+        }
+        QString path = segment.dest;
+        path.replace(QLatin1Char('\''), QStringLiteral("'\\''"));
+        stream << "file '" << path << "'\n";
+    }
+    stream.flush();
+    list.close();
+    // The segments share the same encoding parameters, so the streams can be copied
+    QStringList args;
+    args << QStringLiteral("-y") << QStringLiteral("-v") << QStringLiteral("error") << QStringLiteral("-f") << QStringLiteral("concat") << QStringLiteral("-safe") << QStringLiteral("0")
+         << QStringLiteral("-i") << list.fileName();
+    if (!audioPath.isEmpty()) {
+        args << QStringLiteral("-i") << audioPath << QStringLiteral("-map") << QStringLiteral("0:v") << QStringLiteral("-map") << QStringLiteral("1:a");
+    }
+    args << QStringLiteral("-c") << QStringLiteral("copy") << m_dest;
+    m_renderProcess->start(m_ffmpeg, args);
+    m_logstream << "Started concat process: " << m_ffmpeg << ' ' << args.join(QLatin1Char(' ')) << endl;
+}
+
+void RenderJob::stopSegments()
+{
+    m_segmentsStopped = true;
+    for (const Segment &segment : m_segments) {
+        if (segment.process && segment.process->state() != QProcess::NotRunning) {
+            segment.process->kill();
+            segment.process->waitForFinished();
+        }
+    }
+}
+
+void RenderJob::removeSegments()
+{
+    // The temporary folder removes its content
+    delete m_segmentDir;
+    m_segmentDir = nullptr;
+}
+
 void RenderJob::initKdenliveDbusInterface()
 {
     QString kdenliveId;
@@ -283,6 +486,7 @@ void RenderJob::slotIsOver(QProcess::ExitStatus status, bool isWritable)
     if (m_erase) {
         QFile(m_scenelist).remove();
     }
+    removeSegments();
     if (status == QProcess::CrashExit || m_renderProcess->error() != QProcess::UnknownError || m_renderProcess->exitCode() != 0) {
         // rendering crashed
         if (m_kdenliveinterface) {
@@ -22,8 +22,10 @@
 
 #include <QProcess>
 #include <QObject>
+#include <QPoint>
 #include <QDBusInterface>
 #include <QTime>
+#include <QTemporaryDir>
 // Testing
 #include <QTemporaryFile>
 #include <QTextStream>
@@ -36,6 +38,9 @@ public:
     RenderJob(bool erase, bool usekuiserver, int pid, const QString &renderer, const QString &profile, const QString &rendermodule, const QString &player, const QString &scenelist, const QString &dest, const QStringList &preargs, const QStringList &args, int in = -1, int out = -1);
     ~RenderJob();
     void setLocale(const QString &locale);
+    /** @brief Render the video of the given in / out ranges in parallel melt processes, then join them with ffmpeg without re-encoding.
+     *  The audio is rendered once for the whole range and muxed in, so that the encoder delay of each segment does not create gaps. */
+    void setSegments(const QList<QPoint> &segments, const QString &ffmpeg);
 
 public slots:
     void start();
@@ -48,6 +53,15 @@ private slots:
     void slotCheckProcess(QProcess::ProcessState state);
 
 private:
+    struct Segment {
+        int in;
+        int out;
+        QString dest;
+        QProcess *process;
+        int progress;
+        /** @brief This process renders the audio of the whole range */
+        bool audio;
+    };
     QString m_scenelist;
     QString m_dest;
     int m_progress;
@@ -69,9 +83,32 @@ private:
     QList<QVariant> m_dbusargs;
     QTime m_startTime;
     QStringList m_args;
+    QString m_profile;
+    QString m_rendermodule;
+    QStringList m_preargs;
+    QStringList m_consumerArgs;
+    /** @brief The parts rendered in parallel, empty when rendering in one process. */
+    QList<Segment> m_segments;
+    /** @brief Folder created next to the destination holding the segment files, removed with them. */
+    QTemporaryDir *m_segmentDir;
+    QString m_ffmpeg;
+    /** @brief True once the segment processes were killed or one failed. */
+    bool m_segmentsStopped;
     /** @brief Used to write to the log file. */
     QTextStream m_logstream;
     void initKdenliveDbusInterface();
+    /** @brief Returns the melt arguments rendering the in / out range to dest, extraArgs override the consumer arguments. */
+    QStringList renderArgs(int in, int out, const QString &dest, const QStringList &extraArgs = QStringList()) const;
+    /** @brief Send m_progress to Kdenlive and the job tracker. */
+    void sendProgress(int frame);
+    void startSegments();
+    void receivedSegmentStderr(int ix);
+    void checkSegment(int ix, QProcess::ProcessState state);
+    void concatenateSegments();
+    /** @brief Kill the segment processes still running. */
+    void stopSegments();
+    /** @brief Delete the segment folder with the segment files and the concat list. */
+    void removeSegments();
 
 signals:
     void renderingFinished();
@@ -65,6 +65,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QMenu>
 #include "kdenlive_debug.h"
 #include <QtConcurrent>
+#include <QThread>
 #include <QUndoCommand>
 #include <QCryptographicHash>
 
@@ -534,6 +535,7 @@ Bin::Bin(QWidget *parent) :
     , m_gainedFocus(false)
     , m_audioDuration(0)
     , m_processedAudio(0)
+    , m_audioThumbWorkers(0)
 {
     m_layout = new QVBoxLayout(this);
 
@@ -711,9 +713,6 @@ QDockWidget *Bin::clipPropertiesDock()
 
 void Bin::slotAbortAudioThumb(const QString &id, long duration)
 {
-    if (!m_audioThumbsThread.isRunning()) {
-        return;
-    }
     QMutexLocker aMutex(&m_audioThumbMutex);
     if (m_audioThumbsList.removeAll(id) > 0) {
         m_audioDuration -= duration;
@@ -722,27 +721,57 @@ void Bin::slotAbortAudioThumb(const QString &id, long duration)
 
 void Bin::requestAudioThumbs(const QString &id, long duration)
 {
-    if (!m_audioThumbsList.contains(id) && m_processingAudioThumb != id) {
-        m_audioThumbMutex.lock();
+    m_audioThumbMutex.lock();
+    if (!m_audioThumbsList.contains(id) && !m_processingAudioThumbs.contains(id)) {
         m_audioThumbsList.append(id);
         m_audioDuration += duration;
         m_audioThumbMutex.unlock();
         processAudioThumbs();
+        return;
+    }
+    m_audioThumbMutex.unlock();
+}
+
+bool Bin::prioritizeAudioThumb(const QString &id)
+{
+    QMutexLocker aMutex(&m_audioThumbMutex);
+    int ix = m_audioThumbsList.indexOf(id);
+    if (ix > 0) {
+        m_audioThumbsList.move(ix, 0);
     }
+    return ix >= 0 || m_processingAudioThumbs.contains(id);
 }
 
 void Bin::doUpdateThumbsProgress(long ms)
 {
-    int progress = (m_processedAudio + ms) * 100 / m_audioDuration;
+    ProjectClip *clip = qobject_cast<ProjectClip *>(sender());
+    m_audioThumbMutex.lock();
+    if (clip && m_processingAudioThumbs.contains(clip->clipId())) {
+        m_processingAudioThumbs.insert(clip->clipId(), ms);
+    }
+    if (m_audioDuration <= 0) {
+        m_audioThumbMutex.unlock();
+        return;
+    }
+    long processed = m_processedAudio;
+    for (long clipProgress : m_processingAudioThumbs) {
+        processed += clipProgress;
+    }
+    int progress = processed * 100 / m_audioDuration;
+    m_audioThumbMutex.unlock();
     emitMessage(i18n("Creating audio thumbnails"), progress, ProcessingJobMessage);
 }
 
 void Bin::processAudioThumbs()
 {
-    if (m_audioThumbsThread.isRunning()) {
-        return;
+    // Start one worker per waiting clip, up to half of the available cores
+    int maxWorkers = qMax(1, QThread::idealThreadCount() / 2);
+    m_audioThumbsPool.setMaxThreadCount(maxWorkers);
+    QMutexLocker aMutex(&m_audioThumbMutex);
+    while (m_audioThumbWorkers < maxWorkers && m_audioThumbWorkers < m_audioThumbsList.count() + m_processingAudioThumbs.count()) {
+        m_audioThumbWorkers++;
+        QtConcurrent::run(&m_audioThumbsPool, this, &Bin::slotCreateAudioThumbs);
     }
-    m_audioThumbsThread = QtConcurrent::run(this, &Bin::slotCreateAudioThumbs);
 }
 
 void Bin::abortOperations()
@@ -772,50 +801,59 @@ void Bin::abortOperations()
 
 void Bin::abortAudioThumbs()
 {
-    if (!m_audioThumbsThread.isRunning()) {
+    m_audioThumbMutex.lock();
+    if (m_audioThumbWorkers == 0) {
+        m_audioThumbMutex.unlock();
         return;
     }
-    if (!m_processingAudioThumb.isEmpty()) {
-        ProjectClip *clip = m_rootFolder->clip(m_processingAudioThumb);
+    foreach (const QString &id, m_processingAudioThumbs.keys()) {
+        ProjectClip *clip = m_itemModel->getClipByBinID(id);
         if (clip) {
             clip->abortAudioThumbs();
         }
     }
-    m_audioThumbMutex.lock();
     foreach (const QString &id, m_audioThumbsList) {
-        ProjectClip *clip = m_rootFolder->clip(id);
+        ProjectClip *clip = m_itemModel->getClipByBinID(id);
         if (clip) {
             clip->setJobStatus(AbstractClipJob::THUMBJOB, JobDone, 0);
         }
     }
     m_audioThumbsList.clear();
     m_audioThumbMutex.unlock();
-    m_audioThumbsThread.waitForFinished();
+    m_audioThumbsPool.waitForDone();
 }
 
 void Bin::slotCreateAudioThumbs()
 {
-    int max = m_audioThumbsList.count();
-    int count = 0;
-    m_processedAudio = 0;
-    while (!m_audioThumbsList.isEmpty()) {
+    while (true) {
         m_audioThumbMutex.lock();
-        max = qMax(max, m_audioThumbsList.count());
-        m_processingAudioThumb = m_audioThumbsList.takeFirst();
-        count++;
+        if (m_audioThumbsList.isEmpty()) {
+            m_audioThumbWorkers--;
+            bool finished = m_audioThumbWorkers == 0;
+            if (finished) {
+                m_processedAudio = 0;
+                m_audioDuration = 0;
+            }
+            m_audioThumbMutex.unlock();
+            if (finished) {
+                emitMessage(i18n("Audio thumbnails done"), 100, OperationCompletedMessage);
+            }
+            return;
+        }
+        const QString id = m_audioThumbsList.takeFirst();
+        m_processingAudioThumbs.insert(id, 0);
         m_audioThumbMutex.unlock();
-        ProjectClip *clip = m_rootFolder->clip(m_processingAudioThumb);
+        ProjectClip *clip = m_itemModel->getClipByBinID(id);
+        long duration = 0;
         if (clip) {
             clip->slotCreateAudioThumbs();
-            m_processedAudio += clip->duration().ms();
+            duration = clip->duration().ms();
         }
+        m_audioThumbMutex.lock();
+        m_processingAudioThumbs.remove(id);
+        m_processedAudio += duration;
+        m_audioThumbMutex.unlock();
     }
-    m_audioThumbMutex.lock();
-    m_processingAudioThumb.clear();
-    m_processedAudio = 0;
-    m_audioDuration = 0;
-    m_audioThumbMutex.unlock();
-    emitMessage(i18n("Audio thumbnails done"), 100, OperationCompletedMessage);
 }
 
 bool Bin::eventFilter(QObject *obj, QEvent *event)
@@ -970,7 +1008,7 @@ void Bin::deleteClip(const QString &id)
     if (m_monitor->activeClipId() == id) {
         emit openClip(nullptr);
     }
-    ProjectClip *clip = m_rootFolder->clip(id);
+    ProjectClip *clip = m_itemModel->getClipByBinID(id);
     if (!clip) {
         qCWarning(KDENLIVE_LOG) << "Cannot bin find clip to delete: " << id;
         return;
@@ -2086,7 +2124,7 @@ void Bin::slotEditClipCommand(const QString &id, const QMap<QString, QString> &o
 
 void Bin::reloadClip(const QString &id)
 {
-    ProjectClip *clip = m_rootFolder->clip(id);
+    ProjectClip *clip = m_itemModel->getClipByBinID(id);
     if (!clip) {
         return;
     }
@@ -2099,7 +2137,7 @@ void Bin::reloadClip(const QString &id)
 
 void Bin::slotThumbnailReady(const QString &id, const QImage &img, bool fromFile)
 {
-    ProjectClip *clip = m_rootFolder->clip(id);
+    ProjectClip *clip = m_itemModel->getClipByBinID(id);
     if (clip) {
         clip->setThumbnail(img);
         // Save thumbnail for later reuse
@@ -2129,16 +2167,16 @@ ProjectClip *Bin::getBinClip(const QString &id)
 {
     ProjectClip *clip = nullptr;
     if (id.contains(QLatin1Char('_'))) {
-        clip = m_rootFolder->clip(id.section(QLatin1Char('_'), 0, 0));
+        clip = m_itemModel->getClipByBinID(id.section(QLatin1Char('_'), 0, 0));
     } else if (!id.isEmpty()) {
-        clip = m_rootFolder->clip(id);
+        clip = m_itemModel->getClipByBinID(id);
     }
     return clip;
 }
 
 void Bin::setWaitingStatus(const QString &id)
 {
-    ProjectClip *clip = m_rootFolder->clip(id);
+    ProjectClip *clip = m_itemModel->getClipByBinID(id);
     if (clip) {
         clip->setClipStatus(AbstractProjectItem::StatusWaiting);
     }
@@ -2148,7 +2186,7 @@ void Bin::slotRemoveInvalidClip(const QString &id, bool replace, const QString &
 {
     Q_UNUSED(replace)
 
-    ProjectClip *clip = m_rootFolder->clip(id);
+    ProjectClip *clip = m_itemModel->getClipByBinID(id);
     if (!clip) {
         return;
     }
@@ -2157,7 +2195,7 @@ void Bin::slotRemoveInvalidClip(const QString &id, bool replace, const QString &
 
 void Bin::slotProducerReady(const requestClipInfo &info, ClipController *controller)
 {
-    ProjectClip *clip = m_rootFolder->clip(info.clipId);
+    ProjectClip *clip = m_itemModel->getClipByBinID(info.clipId);
     if (clip) {
         if (clip->setProducer(controller, info.replaceProducer) && !clip->hasProxy()) {
             emit producerReady(info.clipId);
@@ -2369,7 +2407,7 @@ const QSize Bin::getRenderSize()
 
 void Bin::slotUpdateJobStatus(const QString &id, int jobType, int status, const QString &label, const QString &actionName, const QString &details)
 {
-    ProjectClip *clip = m_rootFolder->clip(id);
+    ProjectClip *clip = m_itemModel->getClipByBinID(id);
     if (clip) {
         clip->setJobStatus((AbstractClipJob::JOBTYPE) jobType, (ClipJobStatus) status);
     }
@@ -2455,7 +2493,7 @@ void Bin::slotShowJobLog()
 
 void Bin::gotProxy(const QString &id, const QString &path)
 {
-    ProjectClip *clip = m_rootFolder->clip(id);
+    ProjectClip *clip = m_itemModel->getClipByBinID(id);
     if (clip) {
         QDomDocument doc;
         clip->setProducerProperty(QStringLiteral("kdenlive:proxy"), path);
@@ -2584,7 +2622,7 @@ void Bin::slotItemDropped(const QStringList &ids, const QModelIndex &parent)
             folderIds << id;
             continue;
         }
-        ProjectClip *currentItem = m_rootFolder->clip(id);
+        ProjectClip *currentItem = m_itemModel->getClipByBinID(id);
         AbstractProjectItem *currentParent = currentItem->parent();
         if (currentParent != parentItem) {
             // Item was dropped on a different folder
@@ -2680,7 +2718,7 @@ void Bin::slotMoveEffect(const QString &id, const QList<int> &currentPos, int ne
 
 void Bin::moveEffect(const QString &id, const QList<int> &oldPos, const QList<int> &newPos)
 {
-    ProjectClip *clip = m_rootFolder->clip(id);
+    ProjectClip *clip = m_itemModel->getClipByBinID(id);
     if (!clip) {
         return;
     }
@@ -2710,7 +2748,7 @@ void Bin::removeEffect(const QString &id, const QDomElement &effect)
         qCWarning(KDENLIVE_LOG) << " / /ERROR, trying to remove empty effect";
         return;
     }
-    ProjectClip *currentItem = m_rootFolder->clip(id);
+    ProjectClip *currentItem = m_itemModel->getClipByBinID(id);
     if (!currentItem) {
         return;
     }
@@ -2720,7 +2758,7 @@ void Bin::removeEffect(const QString &id, const QDomElement &effect)
 
 void Bin::addEffect(const QString &id, QDomElement &effect)
 {
-    ProjectClip *currentItem = m_rootFolder->clip(id);
+    ProjectClip *currentItem = m_itemModel->getClipByBinID(id);
     if (!currentItem) {
         return;
     }
@@ -2730,7 +2768,7 @@ void Bin::addEffect(const QString &id, QDomElement &effect)
 
 void Bin::updateEffect(const QString &id, QDomElement &effect, int ix, bool refreshStackWidget)
 {
-    ProjectClip *currentItem = m_rootFolder->clip(id);
+    ProjectClip *currentItem = m_itemModel->getClipByBinID(id);
     if (!currentItem) {
         return;
     }
@@ -2740,7 +2778,7 @@ void Bin::updateEffect(const QString &id, QDomElement &effect, int ix, bool refr
 
 void Bin::changeEffectState(const QString &id, const QList<int> &indexes, bool disable, bool refreshStack)
 {
-    ProjectClip *currentItem = m_rootFolder->clip(id);
+    ProjectClip *currentItem = m_itemModel->getClipByBinID(id);
     if (!currentItem) {
         return;
     }
@@ -2780,7 +2818,7 @@ void Bin::slotGotFocus()
 
 void Bin::doMoveClip(const QString &id, const QString &newParentId)
 {
-    ProjectClip *currentItem = m_rootFolder->clip(id);
+    ProjectClip *currentItem = m_itemModel->getClipByBinID(id);
     if (!currentItem) {
         return;
     }
@@ -3016,7 +3054,7 @@ void Bin::renameSubClipCommand(const QString &id, const QString &newName, const
 
 void Bin::renameSubClip(const QString &id, const QString &newName, const QString &oldName, int in, int out)
 {
-    ProjectClip *clip = m_rootFolder->clip(id);
+    ProjectClip *clip = m_itemModel->getClipByBinID(id);
     if (!clip) {
         return;
     }
@@ -3242,7 +3280,7 @@ void Bin::slotGotFilterJobResults(const QString &id, int startPos, int track, co
         }
         if (startPos == -1) {
             // Processing bin clip
-            ProjectClip *currentItem = m_rootFolder->clip(id);
+            ProjectClip *currentItem = m_itemModel->getClipByBinID(id);
             if (!currentItem) {
                 return;
             }
@@ -3643,7 +3681,7 @@ void Bin::emitMessage(const QString &text, int progress, MessageType type)
 
 void Bin::slotCreateAudioThumb(const QString &id)
 {
-    ProjectClip *clip = m_rootFolder->clip(id);
+    ProjectClip *clip = m_itemModel->getClipByBinID(id);
     if (!clip) {
         return;
     }
@@ -3702,7 +3740,7 @@ void Bin::slotQueryRemoval(const QString &id, const QString &url, const QString
 
 void Bin::slotRefreshClipThumbnail(const QString &id)
 {
-    ProjectClip *clip = m_rootFolder->clip(id);
+    ProjectClip *clip = m_itemModel->getClipByBinID(id);
     if (!clip) {
         return;
     }
@@ -3711,7 +3749,7 @@ void Bin::slotRefreshClipThumbnail(const QString &id)
 
 void Bin::slotAddClipExtraData(const QString &id, const QString &key, const QString &data, QUndoCommand *groupCommand)
 {
-    ProjectClip *clip = m_rootFolder->clip(id);
+    ProjectClip *clip = m_itemModel->getClipByBinID(id);
     if (!clip) {
         return;
     }
@@ -3728,7 +3766,7 @@ void Bin::slotAddClipExtraData(const QString &id, const QString &key, const QStr
 
 void Bin::slotUpdateClipProperties(const QString &id, const QMap<QString, QString> &properties, bool refreshPropertiesPanel)
 {
-    ProjectClip *clip = m_rootFolder->clip(id);
+    ProjectClip *clip = m_itemModel->getClipByBinID(id);
     if (clip) {
         clip->setProperties(properties, refreshPropertiesPanel);
     }
@@ -3863,12 +3901,11 @@ QStringList Bin::getProxyHashList()
 
 void Bin::slotSendAudioThumb(const QString &id)
 {
-    ProjectClip *clip = m_rootFolder->clip(id);
+    ProjectClip *clip = m_itemModel->getClipByBinID(id);
     if (clip && clip->audioThumbCreated()) {
-        m_monitor->prepareAudioThumb(clip->audioChannels(), clip->audioFrameCache);
+        m_monitor->prepareAudioThumb(clip->audioFrameCache);
     } else {
-        QVariantList list;
-        m_monitor->prepareAudioThumb(0, list);
+        m_monitor->prepareAudioThumb();
     }
 }
 
@@ -38,6 +38,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QListView>
 #include <QFuture>
 #include <QMutex>
+#include <QThreadPool>
 #include <QLineEdit>
 #include <QDir>
 
@@ -315,6 +316,9 @@ public:
     void setBinEffectsDisabledStatus(bool disabled);
 
     void requestAudioThumbs(const QString &id, long duration);
+    /** @brief Move clip with @param id to the front of the audio thumbnails queue (for example when it is visible in timeline).
+     *  @returns false if the clip is neither queued nor being processed yet */
+    bool prioritizeAudioThumb(const QString &id);
     /** @brief Proxy status for the project changed, update. */
     void refreshProxySettings();
     /** @brief A clip is ready, update its info panel if displayed. */
@@ -535,14 +539,17 @@ private:
     bool m_gainedFocus;
     /** @brief List of Clip Ids that want an audio thumb. */
     QStringList m_audioThumbsList;
-    QString m_processingAudioThumb;
+    /** @brief Clip Ids currently processed, with the number of milliseconds already processed for each one. */
+    QHash<QString, long> m_processingAudioThumbs;
     QMutex m_audioThumbMutex;
     /** @brief Total number of milliseconds to process for audio thumbnails */
     long m_audioDuration;
     /** @brief Total number of milliseconds already processed for audio thumbnails */
     long m_processedAudio;
-    /** @brief Indicates whether audio thumbnail creation is running. */
-    QFuture<void> m_audioThumbsThread;
+    /** @brief Number of running audio thumbnail workers. */
+    int m_audioThumbWorkers;
+    /** @brief Threads running audio thumbnail creation. */
+    QThreadPool m_audioThumbsPool;
     void showClipProperties(ProjectClip *clip, bool forceRefresh = false);
     /** @brief Get the QModelIndex value for an item in the Bin. */
     QModelIndex getIndexForId(const QString &id, bool folderWanted) const;
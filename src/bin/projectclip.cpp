@@ -137,7 +137,7 @@ QString ProjectClip::getXmlProperty(const QDomElement &producer, const QString &
     return value;
 }
 
-void ProjectClip::updateAudioThumbnail(const QVariantList &audioLevels)
+void ProjectClip::updateAudioThumbnail(const AudioLevels &audioLevels)
 {
     audioFrameCache = audioLevels;
     m_controller->audioThumbCreated = true;
@@ -389,6 +389,11 @@ void ProjectClip::createAudioThumbs()
     }
 }
 
+bool ProjectClip::prioritizeAudioThumbs()
+{
+    return bin()->prioritizeAudioThumb(m_id);
+}
+
 Mlt::Producer *ProjectClip::originalProducer()
 {
     if (!m_controller) {
@@ -1017,7 +1022,7 @@ const QString ProjectClip::getAudioThumbPath(AudioStreamInfo *audioInfo)
         audioPath.append(QLatin1Char('_') + QString::number(audioInfo->audio_index()));
     }
     int roundedFps = (int) m_controller->profile()->fps();
-    audioPath.append(QStringLiteral("_%1_audio.png").arg(roundedFps));
+    audioPath.append(QStringLiteral("_%1_audio.peaks").arg(roundedFps));
     return audioPath;
 }
 
@@ -1043,17 +1048,35 @@ void ProjectClip::slotCreateAudioThumbs()
     if (channels <= 0) {
         channels = 2;
     }
-    QVariantList audioLevels;
-    QImage image(audioPath);
-    if (!image.isNull()) {
-        // convert cached image
-        int n = image.width() * image.height();
-        for (int i = 0; i < n; i++) {
-            QRgb p = image.pixel(i / channels, i % channels);
-            audioLevels << qRed(p);
-            audioLevels << qGreen(p);
-            audioLevels << qBlue(p);
-            audioLevels << qAlpha(p);
+    AudioLevels audioLevels = AudioLevels::load(audioPath);
+    if (audioLevels.isEmpty()) {
+        // Convert image cache from older versions, values are stored interleaved by channel, 4 per pixel
+        QString imagePath = audioPath.section(QLatin1Char('.'), 0, -2) + QStringLiteral(".png");
+        QImage image(imagePath);
+        if (!image.isNull() && image.height() == channels) {
+            image = image.convertToFormat(QImage::Format_ARGB32);
+            int n = image.width() * image.height();
+            audioLevels = AudioLevels(channels, n * 4 / channels);
+            QVector<const QRgb *> rows;
+            rows.reserve(channels);
+            for (int y = 0; y < channels; y++) {
+                rows << reinterpret_cast<const QRgb *>(image.constScanLine(y));
+            }
+            for (int i = 0; i < n; i++) {
+                QRgb p = rows.at(i % channels)[i / channels];
+                int ix = 4 * i;
+                audioLevels.setLevel(ix / channels, ix % channels, qRed(p));
+                ix++;
+                audioLevels.setLevel(ix / channels, ix % channels, qGreen(p));
+                ix++;
+                audioLevels.setLevel(ix / channels, ix % channels, qBlue(p));
+                ix++;
+                audioLevels.setLevel(ix / channels, ix % channels, qAlpha(p));
+            }
+            audioLevels.buildPyramid();
+            if (audioLevels.save(audioPath)) {
+                QFile::remove(imagePath);
+            }
         }
     }
     if (!audioLevels.isEmpty()) {
@@ -1063,147 +1086,100 @@ void ProjectClip::slotCreateAudioThumbs()
     }
     bool jobFinished = false;
     if (KdenliveSettings::ffmpegaudiothumbnails() && m_type != Playlist) {
+        // Decode all channels of the audio stream as interleaved raw samples on ffmpeg's standard output
+        // and reduce them to one level per frame as they arrive, so memory use does not depend on clip length
         QStringList args;
-        QList<QTemporaryFile *> channelFiles;
-        for (int i = 0; i < channels; i++) {
-            QTemporaryFile *channelTmpfile = new QTemporaryFile;
-            if (!channelTmpfile->open()) {
-                delete channelTmpfile;
-                bin()->emitMessage(i18n("Cannot create temporary file, check disk space and permissions"), 100, ErrorMessage);
-                return;
-            }
-            channelTmpfile->close();
-            channelFiles << channelTmpfile;
-        }
+        args << QStringLiteral("-loglevel") << QStringLiteral("error");
         args << QStringLiteral("-i") << QUrl::fromLocalFile(prod->get("resource")).toLocalFile();
-        // Output progress info
-        args << QStringLiteral("-progress");
-#ifdef Q_OS_WIN
-        args << QStringLiteral("-");
-#else
-        args << QStringLiteral("/dev/stdout");
-#endif
-        bool isFFmpeg = KdenliveSettings::ffmpegpath().contains(QLatin1String("ffmpeg"));
-
-        if (channels == 1) {
-            if (isFFmpeg) {
-                args << QStringLiteral("-filter_complex:a") << QStringLiteral("aformat=channel_layouts=mono,aresample=async=100");
-                args << QStringLiteral("-map") << QStringLiteral("0:a%1").arg(audioStream > 0 ? ":" + QString::number(audioStream) : QString()) << QStringLiteral("-c:a") << QStringLiteral("pcm_s16le") << QStringLiteral("-y") << QStringLiteral("-f") << QStringLiteral("data") << channelFiles[0]->fileName();
-            } else {
-                args << QStringLiteral("-filter_complex:a") << QStringLiteral("aformat=channel_layouts=mono:sample_rates=100");
-                args << QStringLiteral("-map") << QStringLiteral("0:a%1").arg(audioStream > 0 ? ":" + QString::number(audioStream) : QString()) << QStringLiteral("-c:a") << QStringLiteral("pcm_s16le") << QStringLiteral("-y") << QStringLiteral("-f") << QStringLiteral("s16le") << channelFiles[0]->fileName();
-            }
-        } else if (channels == 2) {
-            if (isFFmpeg) {
-                args << QStringLiteral("-filter_complex:a") << QStringLiteral("[0:a%1]aresample=async=100,channelsplit=channel_layout=stereo[0:0][0:1]").arg(audioStream > 0 ? ":" + QString::number(audioStream) : QString());
-                // Channel 1
-                args << QStringLiteral("-map") << QStringLiteral("[0:1]") << QStringLiteral("-c:a") << QStringLiteral("pcm_s16le") << QStringLiteral("-y") << QStringLiteral("-f") << QStringLiteral("data") << channelFiles[0]->fileName();
-                // Channel 2
-                args << QStringLiteral("-map") << QStringLiteral("[0:0]") << QStringLiteral("-c:a") << QStringLiteral("pcm_s16le") << QStringLiteral("-y") << QStringLiteral("-f") << QStringLiteral("data") << channelFiles[1]->fileName();
-            } else {
-                args << QStringLiteral("-filter_complex:a") << QStringLiteral("[0:a%1]aformat=sample_rates=100,channelsplit=channel_layout=stereo[0:0][0:1]").arg(audioStream > 0 ? ":" + QString::number(audioStream) : QString());
-                // Channel 1
-                args << QStringLiteral("-map") << QStringLiteral("[0:1]") << QStringLiteral("-c:a") << QStringLiteral("pcm_s16le") << QStringLiteral("-y") << QStringLiteral("-f") << QStringLiteral("s16le") << channelFiles[0]->fileName();
-                // Channel 2
-                args << QStringLiteral("-map") << QStringLiteral("[0:0]") << QStringLiteral("-c:a") << QStringLiteral("pcm_s16le") << QStringLiteral("-y") << QStringLiteral("-f") << QStringLiteral("s16le") << channelFiles[1]->fileName();
-            }
-        } else if (channels == 6) {
-            args << QStringLiteral("-filter_complex:a") << QStringLiteral("[0:a%1]aresample=async=100,channelsplit=channel_layout=5.1[0:0][0:1][0:2][0:3][0:4][0:5]").arg(audioStream > 0 ? ":" + QString::number(audioStream) : QString());
-            for (int i = 0; i < channels; i++) {
-                // Channel 1
-                args << QStringLiteral("-map") << QStringLiteral("[0:%1]").arg(i) << QStringLiteral("-c:a") << QStringLiteral("pcm_s16le") << QStringLiteral("-y") << QStringLiteral("-f") << QStringLiteral("data") << channelFiles[i]->fileName();
-            }
+        args << QStringLiteral("-vn") << QStringLiteral("-map") << QStringLiteral("0:a%1").arg(audioStream > 0 ? ":" + QString::number(audioStream) : QString());
+        if (KdenliveSettings::ffmpegpath().contains(QLatin1String("ffmpeg"))) {
+            args << QStringLiteral("-af") << QStringLiteral("aresample=async=100");
         }
+        args << QStringLiteral("-ac") << QString::number(channels) << QStringLiteral("-c:a") << QStringLiteral("pcm_s16le") << QStringLiteral("-f") << QStringLiteral("s16le") << QStringLiteral("-");
         QProcess audioThumbsProcess;
         connect(this, &ProjectClip::doAbortAudioThumbs, &audioThumbsProcess, &QProcess::kill, Qt::DirectConnection);
-        connect(&audioThumbsProcess, &QProcess::readyReadStandardOutput, this, &ProjectClip::updateFfmpegProgress);
         audioThumbsProcess.start(KdenliveSettings::ffmpegpath(), args);
-        bool ffmpegError = false;
-        if (!audioThumbsProcess.waitForStarted()) {
-            ffmpegError = true;
-        }
-        audioThumbsProcess.waitForFinished(-1);
-        if (m_abortAudioThumb) {
-            // Cleanup temporary ffmpeg audio thumb file
-            while (!channelFiles.isEmpty()) {
-                delete channelFiles.takeFirst();
-            }
-            emit updateJobStatus(AbstractClipJob::THUMBJOB, JobDone, 0);
-            m_abortAudioThumb = false;
-            return;
-        }
-
-        if (!ffmpegError && audioThumbsProcess.exitStatus() != QProcess::CrashExit) {
-            int dataSize = 0;
-            QList<const qint16 *> rawChannels;
-            QList<QByteArray> sourceChannels;
-            for (int i = 0; i < channelFiles.count(); i++) {
-                channelFiles[i]->open();
-                QByteArray res = channelFiles[i]->readAll();
-                channelFiles[i]->close();
-                if (dataSize == 0) {
-                    dataSize = res.size();
-                }
-                if (res.isEmpty() || res.size() != dataSize) {
-                    // Something went wrong, abort
-                    // Cleanup temporary ffmpeg audio thumb file
-                    while (!channelFiles.isEmpty()) {
-                        delete channelFiles.takeFirst();
-                    }
-                    emit updateJobStatus(AbstractClipJob::THUMBJOB, JobDone, 0);
-                    bin()->emitMessage(i18n("Error reading audio thumbnail"), 100, ErrorMessage);
-                    return;
-                }
-                rawChannels << (const qint16 *) res.constData();
-                // We need to keep res2 alive or rawChannels data will die
-                sourceChannels << res;
+        bool ffmpegError = !audioThumbsProcess.waitForStarted();
+        int frame = 0;
+        if (!ffmpegError) {
+            double fps = prod->get_fps();
+            if (fps <= 0) {
+                fps = 25.0;
             }
-            int progress = 0;
-            QList<long> channelsData;
-            double offset = (double) dataSize / (2.0 * lengthInFrames);
+            double samplesPerFrame = frequency / fps;
             int intraOffset = 1;
-            if (offset > 1000) {
-                intraOffset = offset / 60;
-            } else if (offset > 250) {
-                intraOffset = offset / 10;
+            if (samplesPerFrame > 1000) {
+                intraOffset = samplesPerFrame / 60;
+            } else if (samplesPerFrame > 250) {
+                intraOffset = samplesPerFrame / 10;
             }
             double factor = 800.0 / 32768;
-            for (int i = 0; i < lengthInFrames; i++) {
-                channelsData.clear();
-                for (int k = 0; k < rawChannels.count(); k++) {
-                    channelsData << 0;
+            const int sampleSize = 2 * channels;
+            audioLevels = AudioLevels(channels, lengthInFrames);
+            QVector<long> channelsData(channels, 0);
+            int steps = 0;
+            qint64 sampleIndex = 0;
+            qint64 frameEnd = (qint64) samplesPerFrame;
+            int progress = 0;
+            QByteArray pending;
+            while (frame < lengthInFrames && !m_abortAudioThumb) {
+                if (audioThumbsProcess.bytesAvailable() == 0 && !audioThumbsProcess.waitForReadyRead(-1)) {
+                    break;
                 }
-                int pos = (int)(i * offset);
-                int steps = 0;
-                for (int j = 0; j < (int) offset && (pos + j < dataSize); j += intraOffset) {
-                    steps ++;
-                    for (int k = 0; k < rawChannels.count(); k++) {
-                        channelsData[k] += abs(rawChannels[k][pos + j]);
+                pending.append(audioThumbsProcess.readAllStandardOutput());
+                int sampleCount = pending.size() / sampleSize;
+                const qint16 *samples = (const qint16 *) pending.constData();
+                for (int i = 0; i < sampleCount && frame < lengthInFrames; i++, sampleIndex++) {
+                    if (sampleIndex % intraOffset == 0) {
+                        steps++;
+                        for (int k = 0; k < channels; k++) {
+                            channelsData[k] += abs(samples[i * channels + k]);
+                        }
                     }
-                }
-                for (int k = 0; k < channelsData.count(); k++) {
-                    if (steps) {
-                        channelsData[k] /= steps;
+                    if (sampleIndex + 1 >= frameEnd) {
+                        // Frame is complete
+                        for (int k = 0; k < channels; k++) {
+                            audioLevels.setLevel(frame, k, (int)(channelsData.at(k) / qMax(1, steps) * factor));
+                            channelsData[k] = 0;
+                        }
+                        steps = 0;
+                        frame++;
+                        frameEnd = (qint64)((frame + 1) * samplesPerFrame);
                     }
-                    audioLevels << channelsData[k] * factor;
                 }
-                int p = 80 + (i * 20 / lengthInFrames);
+                pending.remove(0, sampleCount * sampleSize);
+                int p = frame * 100 / lengthInFrames;
                 if (p != progress) {
                     emit updateJobStatus(AbstractClipJob::THUMBJOB, JobWorking, p);
+                    // Update general statusbar progressbar
+                    emit updateThumbProgress((long)(frame / fps * 1000));
                     progress = p;
                 }
-                if (m_abortAudioThumb) {
-                    break;
+            }
+            if (steps > 0 && frame < lengthInFrames) {
+                // Last incomplete frame
+                for (int k = 0; k < channels; k++) {
+                    audioLevels.setLevel(frame, k, (int)(channelsData.at(k) / steps * factor));
                 }
+                frame++;
+            }
+            if (frame >= lengthInFrames) {
+                // We have all our data, no need to decode the rest
+                audioThumbsProcess.kill();
             }
+            audioThumbsProcess.waitForFinished(-1);
+        }
+        if (m_abortAudioThumb) {
+            emit updateJobStatus(AbstractClipJob::THUMBJOB, JobDone, 0);
+            m_abortAudioThumb = false;
+            return;
+        }
+        if (!ffmpegError && frame > 0 && (frame >= lengthInFrames || audioThumbsProcess.exitStatus() != QProcess::CrashExit)) {
             jobFinished = true;
         } else {
+            audioLevels = AudioLevels();
             bin()->emitMessage(i18n("Failed to create FFmpeg audio thumbnails, using MLT"), 100, ErrorMessage);
         }
-        // Cleanup temporary ffmpeg audio thumb file
-        while (!channelFiles.isEmpty()) {
-            delete channelFiles.takeFirst();
-        }
     }
     if (!jobFinished && !m_abortAudioThumb) {
         // MLT audio thumbs: slower but safer
@@ -1235,6 +1211,7 @@ void ProjectClip::slotCreateAudioThumbs()
             keys << "meta.media.audio_level." + QString::number(i);
         }
 
+        audioLevels = AudioLevels(channels, lengthInFrames);
         for (int z = 0; z < lengthInFrames && !m_abortAudioThumb; ++z) {
             int val = (int)(100.0 * z / lengthInFrames);
             if (last_val != val) {
@@ -1247,11 +1224,11 @@ void ProjectClip::slotCreateAudioThumbs()
                 mlt_frame->get_audio(audioFormat, frequency, channels, samples);
                 for (int channel = 0; channel < channels; ++channel) {
                     double level = 256 * qMin(mlt_frame->get_double(keys.at(channel).toUtf8().constData()) * 0.9, 1.0);
-                    audioLevels << level;
+                    audioLevels.setLevel(z, channel, (int) level);
                 }
-            } else if (!audioLevels.isEmpty()) {
+            } else if (z > 0) {
                 for (int channel = 0; channel < channels; channel++) {
-                    audioLevels << audioLevels.last();
+                    audioLevels.setLevel(z, channel, audioLevels.level(z - 1, channel));
                 }
             }
             if (m_abortAudioThumb) {
@@ -1262,53 +1239,17 @@ void ProjectClip::slotCreateAudioThumbs()
 
     emit updateJobStatus(AbstractClipJob::THUMBJOB, JobDone, 0);
     if (!m_abortAudioThumb) {
+        audioLevels.buildPyramid();
         updateAudioThumbnail(audioLevels);
     }
 
     if (!m_abortAudioThumb && !audioLevels.isEmpty()) {
-        // Put into an image for caching.
-        int count = audioLevels.size();
-        QImage image(lrint((count + 3) / 4.0 / channels), channels, QImage::Format_ARGB32);
-        int n = image.width() * image.height();
-        for (int i = 0; i < n; i ++) {
-            QRgb p;
-            if ((4 * i + 3) < count) {
-                p = qRgba(audioLevels.at(4 * i).toInt(), audioLevels.at(4 * i + 1).toInt(), audioLevels.at(4 * i + 2).toInt(), audioLevels.at(4 * i + 3).toInt());
-            } else {
-                int last = audioLevels.last().toInt();
-                int r = (4 * i + 0) < count ? audioLevels.at(4 * i + 0).toInt() : last;
-                int g = (4 * i + 1) < count ? audioLevels.at(4 * i + 1).toInt() : last;
-                int b = (4 * i + 2) < count ? audioLevels.at(4 * i + 2).toInt() : last;
-                int a = last;
-                p = qRgba(r, g, b, a);
-            }
-            image.setPixel(i / channels, i % channels, p);
-        }
-        image.save(audioPath);
+        // Write peak file for caching
+        audioLevels.save(audioPath);
     }
     m_abortAudioThumb = false;
 }
 
-void ProjectClip::updateFfmpegProgress()
-{
-    QProcess *callerProcess = qobject_cast<QProcess *> (QObject::sender());
-    if (!callerProcess) {
-        return;
-    }
-    QString result = callerProcess->readAllStandardOutput();
-    const QStringList lines = result.split(QLatin1Char('\n'));
-    for (const QString &data : lines) {
-        if (data.startsWith(QStringLiteral("out_time_ms"))) {
-            long ms = data.section(QLatin1Char('='), 1).toLong();
-            // Update clip progressbar
-            emit updateJobStatus(AbstractClipJob::THUMBJOB, JobWorking, ms / duration().ms() * 0.08);
-            // Update general statusbar progressbar
-            emit updateThumbProgress(ms / 1000);
-            break;
-        }
-    }
-}
-
 bool ProjectClip::isTransparent() const
 {
     if (m_type == Text) {
@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "abstractprojectitem.h"
 #include "definitions.h"
+#include "lib/audio/audioLevels.h"
 
 #include <QUrl>
 #include <QMutex>
@@ -176,7 +177,7 @@ public:
 
     /** Cache for every audio Frame with 10 Bytes */
     /** format is frame -> channel ->bytes */
-    QVariantList audioFrameCache;
+    AudioLevels audioFrameCache;
     bool audioThumbCreated() const;
 
     void updateParentInfo(const QString &folderid, const QString &foldername);
@@ -197,6 +198,8 @@ public:
     void removeEffect(int ix);
     /** @brief Create audio thumbnail for this clip. */
     void createAudioThumbs();
+    /** @brief Ask the bin to create our audio thumbnail before other waiting clips, returns false if it was not requested yet. */
+    bool prioritizeAudioThumbs();
     /** @brief Returns the number of audio channels. */
     int audioChannels() const;
     /** @brief get data analysis value. */
@@ -217,7 +220,7 @@ public:
     bool isSplittable() const;
 
 public slots:
-    void updateAudioThumbnail(const QVariantList &audioLevels);
+    void updateAudioThumbnail(const AudioLevels &audioLevels);
     /** @brief Extract image thumbnails for timeline. */
     void slotExtractImage(const QList<int> &frames);
     void slotCreateAudioThumbs();
@@ -250,9 +253,6 @@ private:
     void doExtractImage();
     void doExtractIntra();
 
-private slots:
-    void updateFfmpegProgress();
-
 signals:
     void gotAudioData();
     void refreshPropertiesPanel();
@@ -301,12 +301,13 @@ void ProjectItemModel::onAboutToAddItem(AbstractProjectItem *item)
 
 void ProjectItemModel::onItemAdded(AbstractProjectItem *item)
 {
-    Q_UNUSED(item)
+    indexClips(item);
     endInsertRows();
 }
 
 void ProjectItemModel::onAboutToRemoveItem(AbstractProjectItem *item)
 {
+    unindexClips(item);
     AbstractProjectItem *parentItem = item->parent();
     if (parentItem == nullptr) {
         return;
@@ -325,6 +326,37 @@ void ProjectItemModel::onItemRemoved(AbstractProjectItem *item)
     endRemoveRows();
 }
 
+ProjectClip *ProjectItemModel::getClipByBinID(const QString &id) const
+{
+    return m_clips.value(id);
+}
+
+void ProjectItemModel::indexClips(AbstractProjectItem *item)
+{
+    if (item->itemType() == AbstractProjectItem::ClipItem) {
+        m_clips.insert(item->clipId(), static_cast<ProjectClip *>(item));
+    } else if (item->itemType() == AbstractProjectItem::FolderItem) {
+        // A folder moved with its content
+        for (int i = 0; i < item->count(); ++i) {
+            indexClips(item->at(i));
+        }
+    }
+}
+
+void ProjectItemModel::unindexClips(AbstractProjectItem *item)
+{
+    if (item->itemType() == AbstractProjectItem::ClipItem) {
+        QHash<QString, ProjectClip *>::iterator it = m_clips.find(item->clipId());
+        if (it != m_clips.end() && it.value() == item) {
+            m_clips.erase(it);
+        }
+    } else if (item->itemType() == AbstractProjectItem::FolderItem) {
+        for (int i = 0; i < item->count(); ++i) {
+            unindexClips(item->at(i));
+        }
+    }
+}
+
 void ProjectItemModel::onItemUpdated(AbstractProjectItem *item)
 {
     if (!item || item->clipStatus() == AbstractProjectItem::StatusDeleting) {
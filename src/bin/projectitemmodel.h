@@ -24,10 +24,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define PROJECTITEMMODEL_H
 
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QSize>
 
 class AbstractProjectItem;
 class Bin;
+class ProjectClip;
 
 /**
  * @class ProjectItemModel
@@ -74,6 +76,8 @@ public:
     void onItemRemoved(AbstractProjectItem *item);
     bool dropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent) Q_DECL_OVERRIDE;
     Qt::DropActions supportedDropActions() const Q_DECL_OVERRIDE;
+    /** @brief Returns the clip with bin id, wherever it is in the folders, or nullptr. */
+    ProjectClip *getClipByBinID(const QString &id) const;
 
 public slots:
     /** @brief An item in the list was modified, notify */
@@ -82,8 +86,14 @@ public slots:
 private:
     /** @brief Reference to the project bin */
     Bin *m_bin;
+    /** @brief The clips of the bin folders by id, updated when items are added to or removed from a folder */
+    QHash<QString, ProjectClip *> m_clips;
     /** @brief Return reference to column specific data */
     int mapToColumn(int column) const;
+    /** @brief Add the clips of item, or item itself, to the clip index */
+    void indexClips(AbstractProjectItem *item);
+    /** @brief Remove the clips of item, or item itself, from the clip index */
+    void unindexClips(AbstractProjectItem *item);
 
 signals:
     //TODO
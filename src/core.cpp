@@ -19,6 +19,7 @@ the Free Software Foundation, either version 3 of the License, or
 #include "mltcontroller/producerqueue.h"
 #include "bin/bin.h"
 #include "library/librarywidget.h"
+#include "effectslist/initeffects.h"
 #include "kdenlive_debug.h"
 
 #include <QCoreApplication>
@@ -48,6 +49,8 @@ Core::Core() :
 
 Core::~Core()
 {
+    // The effect catalog refresh uses the MLT repository
+    initEffects::waitForCatalogRefresh();
     m_monitorManager->stopActiveMonitor();
     delete m_producerQueue;
     delete m_binWidget;
@@ -228,3 +231,8 @@ std::unique_ptr<Mlt::Repository>& Core::getMltRepository()
 {
     return m_mltConnection->getMltRepository();
 }
+
+QMutex *Core::getMltRepositoryMutex()
+{
+    return m_mltConnection->getMltRepositoryMutex();
+}
@@ -24,6 +24,7 @@ class Bin;
 class LibraryWidget;
 class ProducerQueue;
 class MltConnection;
+class QMutex;
 
 namespace Mlt
 {
@@ -85,6 +86,9 @@ public:
 
     /** @brief Returns a pointer to MLT's repository */
     std::unique_ptr<Mlt::Repository>& getMltRepository();
+    /** @brief Returns the lock serializing metadata queries on MLT's repository,
+     *  also made by the effect catalog refresh thread */
+    QMutex *getMltRepositoryMutex();
 
 private:
     explicit Core();
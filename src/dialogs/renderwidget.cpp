@@ -234,6 +234,9 @@ RenderWidget::RenderWidget(const QString &projectfolder, bool enableProxy, const
     m_view.encoder_threads->setMaximum(QThread::idealThreadCount());
     m_view.encoder_threads->setValue(KdenliveSettings::encodethreads());
     connect(m_view.encoder_threads, SIGNAL(valueChanged(int)), this, SLOT(slotUpdateEncodeThreads(int)));
+    m_view.render_segments->setMaximum(QThread::idealThreadCount());
+    m_view.render_segments->setValue(KdenliveSettings::rendersegments());
+    connect(m_view.render_segments, SIGNAL(valueChanged(int)), this, SLOT(slotUpdateRenderSegments(int)));
 
     m_view.rescale_keep->setChecked(KdenliveSettings::rescalekeepratio());
     connect(m_view.rescale_width, SIGNAL(valueChanged(int)), this, SLOT(slotUpdateRescaleWidth(int)));
@@ -1160,23 +1163,40 @@ void RenderWidget::slotExport(bool scriptExport, int zoneIn, int zoneOut,
         }
 
         // If there is an fps change, we need to use the producer consumer AND update the in/out points
+        bool fpsChanged = false;
         if (forcedfps > 0 && qAbs((int) 100 * forcedfps - ((int) 100 * profile->frame_rate_num() / profile->frame_rate_den())) > 2) {
             resizeProfile = true;
+            fpsChanged = true;
             double ratio = profile->frame_rate_num() / profile->frame_rate_den() / forcedfps;
             if (ratio > 0) {
                 zoneIn /= ratio;
                 zoneOut /= ratio;
             }
         }
+        int renderIn = zoneIn;
+        int renderOut = zoneOut;
         if (m_view.render_guide->isChecked()) {
             double fps = profile->fps();
             double guideStart = m_view.guide_start->itemData(m_view.guide_start->currentIndex()).toDouble();
             double guideEnd = m_view.guide_end->itemData(m_view.guide_end->currentIndex()).toDouble();
-            render_process_args << "in=" + QString::number((int) GenTime(guideStart).frames(fps)) << "out=" + QString::number((int) GenTime(guideEnd).frames(fps));
-        } else {
-            render_process_args << "in=" + QString::number(zoneIn) << "out=" + QString::number(zoneOut);
+            renderIn = (int) GenTime(guideStart).frames(fps);
+            renderOut = (int) GenTime(guideEnd).frames(fps);
         }
 
+        // Segments are joined with ffmpeg's concat demuxer, which needs the same stream layout in all of them
+        QStringList segmentContainers;
+        segmentContainers << QStringLiteral("mp4") << QStringLiteral("m4v") << QStringLiteral("mov") << QStringLiteral("mkv") << QStringLiteral("webm")
+                          << QStringLiteral("ts") << QStringLiteral("mpg") << QStringLiteral("avi");
+        if (KdenliveSettings::rendersegments() > 1 && !m_view.checkTwoPass->isChecked() && segmentContainers.contains(extension)
+                && QFile::exists(KdenliveSettings::ffmpegpath())) {
+            const QStringList segments = renderSegments(renderIn, renderOut, profile->fps(), !fpsChanged);
+            if (segments.count() > 1) {
+                render_process_args << QStringLiteral("-ffmpeg:%1").arg(KdenliveSettings::ffmpegpath());
+                render_process_args << QStringLiteral("-segments:%1").arg(segments.join(QLatin1Char(',')));
+            }
+        }
+        render_process_args << "in=" + QString::number(renderIn) << "out=" + QString::number(renderOut);
+
         if (!overlayargs.isEmpty()) {
             render_process_args << "preargs=" + overlayargs.join(QLatin1Char(' '));
         }
@@ -2620,6 +2640,50 @@ void RenderWidget::slotUpdateEncodeThreads(int val)
     KdenliveSettings::setEncodethreads(val);
 }
 
+void RenderWidget::slotUpdateRenderSegments(int val)
+{
+    KdenliveSettings::setRendersegments(val);
+}
+
+QStringList RenderWidget::renderSegments(int in, int out, double fps, bool useGuides) const
+{
+    QStringList segments;
+    // Each segment reloads the project in its own melt process, don't make them too short
+    const int minLength = (int)(10 * fps);
+    const int count = qMin(KdenliveSettings::rendersegments(), (out - in + 1) / qMax(1, minLength));
+    if (count < 2) {
+        return segments;
+    }
+    QList<int> guides;
+    if (useGuides) {
+        // First item is the project start
+        for (int i = 1; i < m_view.guide_start->count(); ++i) {
+            int pos = (int) GenTime(m_view.guide_start->itemData(i).toDouble()).frames(fps);
+            if (pos > in && pos <= out) {
+                guides << pos;
+            }
+        }
+    }
+    // Every segment is a separate encode starting with a key frame, so it can start at any
+    // frame. Prefer a guide close to the even split, where a cut is likely.
+    const double length = (double)(out - in + 1) / count;
+    int start = in;
+    for (int i = 1; i < count; ++i) {
+        int cut = in + (int)(i * length);
+        int bestDistance = (int)(length / 4);
+        for (int guide : guides) {
+            if (guide > start + minLength / 2 && guide < out - minLength / 2 && qAbs(guide - cut) < bestDistance) {
+                bestDistance = qAbs(guide - cut);
+                cut = guide;
+            }
+        }
+        segments << QStringLiteral("%1-%2").arg(start).arg(cut - 1);
+        start = cut;
+    }
+    segments << QStringLiteral("%1-%2").arg(start).arg(out);
+    return segments;
+}
+
 void RenderWidget::slotUpdateRescaleWidth(int val)
 {
     KdenliveSettings::setDefaultrescalewidth(val);
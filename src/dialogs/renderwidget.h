@@ -183,6 +183,7 @@ private slots:
     void slotStartCurrentJob();
     void slotCopyToFavorites();
     void slotUpdateEncodeThreads(int);
+    void slotUpdateRenderSegments(int);
     void slotUpdateRescaleHeight(int);
     void slotUpdateRescaleWidth(int);
     void slotSwitchAspectRatio();
@@ -222,6 +223,10 @@ private:
     /** @brief Create a rendering profile from MLT preset. */
     QTreeWidgetItem *loadFromMltPreset(const QString &groupName, const QString &path, const QString &profileName);
     void checkCodecs();
+    /** @brief Split the in / out range in parts rendered in parallel, preferably at guides.
+     *  @param useGuides false if the range is not in project frames, so that guides cannot be used
+     *  @return the segments as "in-out" strings, less than two if the range should be rendered at once */
+    QStringList renderSegments(int in, int out, double fps, bool useGuides) const;
 
 signals:
     void abortProcess(const QString &url);
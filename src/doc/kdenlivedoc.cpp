@@ -57,6 +57,11 @@
 #include <QUndoGroup>
 #include <QTimer>
 #include <QUndoStack>
+#include <QSaveFile>
+#include <QBuffer>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QtConcurrent>
 
 #include <mlt++/Mlt.h>
 #include <KJobWidgets/KJobWidgets>
@@ -91,8 +96,13 @@ KdenliveDoc::KdenliveDoc(const QUrl &url, const QString &projectFolder, QUndoGro
     m_render(render),
     m_notesWidget(notes->widget()),
     m_modified(false),
-    m_projectFolder(projectFolder)
+    m_projectFolder(projectFolder),
+    m_revision(0),
+    m_autoSaveRevision(0),
+    m_autoSavedRevision(0),
+    m_autoSavePending(false)
 {
+    connect(&m_autoSaveWatcher, &QFutureWatcherBase::finished, this, &KdenliveDoc::slotAutoSaveFinished);
     // init m_profile struct
     m_commandStack = new DocUndoStack(undoGroup);
     m_profile.frame_rate_num = 0;
@@ -302,6 +312,8 @@ KdenliveDoc::~KdenliveDoc()
             }
         }
     }
+    // Don't let the autosave worker recreate the file we are about to remove
+    m_autoSaveWatcher.waitForFinished();
     delete m_commandStack;
     //qCDebug(KDENLIVE_LOG) << "// DEL CLP MAN";
     delete m_clipManager;
@@ -559,20 +571,76 @@ bool KdenliveDoc::autoGenerateImageProxy(int width) const
 void KdenliveDoc::slotAutoSave()
 {
     if (m_render && m_autosave) {
+        if (m_autoSaveWatcher.isRunning()) {
+            // Write again once the current autosave is done
+            m_autoSavePending = true;
+            return;
+        }
+        if (!needsAutoSave()) {
+            return;
+        }
+        // Opening the file creates it and takes its lock, the worker then replaces it
         if (!m_autosave->isOpen() && !m_autosave->open(QIODevice::ReadWrite)) {
             // show error: could not open the autosave file
             qCDebug(KDENLIVE_LOG) << "ERROR; CANNOT CREATE AUTOSAVE FILE";
-        }
-        //qCDebug(KDENLIVE_LOG) << "// AUTOSAVE FILE: " << m_autosave->fileName();
-        QDomDocument sceneList = xmlSceneList(m_render->sceneList(m_url.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash).toLocalFile()));
-        if (sceneList.isNull()) {
-            //Make sure we don't save if scenelist is corrupted
-            KMessageBox::error(QApplication::activeWindow(), i18n("Cannot write to file %1, scene list is corrupted.", m_autosave->fileName()));
             return;
         }
-        m_autosave->resize(0);
-        m_autosave->write(sceneList.toString().toUtf8());
-        m_autosave->flush();
+        m_autosave->close();
+        //qCDebug(KDENLIVE_LOG) << "// AUTOSAVE FILE: " << m_autosave->fileName();
+        // The MLT scene must be serialized here since it is modified by the GUI thread, the rest is done in the worker
+        const QString scene = m_render->sceneList(m_url.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash).toLocalFile());
+        EffectsList customEffects;
+        customEffects.clone(MainWindow::customEffects);
+        m_autoSaveRevision = m_revision;
+        m_autoSaveWatcher.setFuture(QtConcurrent::run(&KdenliveDoc::writeAutoSave, m_autosave->fileName(), scene, pCore->binController()->binPlaylistId(), customEffects));
+    }
+}
+
+bool KdenliveDoc::needsAutoSave() const
+{
+    return m_autosave != nullptr && m_revision != m_autoSavedRevision;
+}
+
+void KdenliveDoc::waitForAutoSave()
+{
+    m_autoSaveWatcher.waitForFinished();
+}
+
+int KdenliveDoc::writeAutoSave(const QString &path, const QString &scene, const QString &binPlaylistId, const EffectsList &customEffects)
+{
+    bool ok;
+    const QString usedEffects = usedCustomEffects(scene, customEffects, &ok);
+    if (!ok) {
+        return AutoSaveCorrupted;
+    }
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return AutoSaveFailed;
+    }
+    // An uncommitted file is discarded, leaving the previous autosave in place
+    if (!streamSceneList(scene, binPlaylistId, usedEffects, &file) || !file.commit()) {
+        return AutoSaveFailed;
+    }
+    return AutoSaveOk;
+}
+
+void KdenliveDoc::slotAutoSaveFinished()
+{
+    switch (m_autoSaveWatcher.result()) {
+    case AutoSaveOk:
+        m_autoSavedRevision = m_autoSaveRevision;
+        break;
+    case AutoSaveCorrupted:
+        //Make sure we don't save if scenelist is corrupted
+        KMessageBox::error(QApplication::activeWindow(), i18n("Cannot write to file %1, scene list is corrupted.", m_autosave->fileName()));
+        break;
+    default:
+        qCWarning(KDENLIVE_LOG) << "//////  ERROR writing autosave file: " << m_autosave->fileName();
+        break;
+    }
+    if (m_autoSavePending) {
+        m_autoSavePending = false;
+        emit startAutoSave();
     }
 }
 
@@ -601,73 +669,124 @@ QPoint KdenliveDoc::zone() const
 QDomDocument KdenliveDoc::xmlSceneList(const QString &scene)
 {
     QDomDocument sceneList;
-    sceneList.setContent(scene, true);
-    QDomElement mlt = sceneList.firstChildElement(QStringLiteral("mlt"));
-    if (mlt.isNull() || !mlt.hasChildNodes()) {
+    bool ok;
+    const QString customEffects = usedCustomEffects(scene, MainWindow::customEffects, &ok);
+    if (!ok) {
         //scenelist is corrupted
         return sceneList;
     }
-
-    // Set playlist audio volume to 100%
-    QDomElement tractor = mlt.firstChildElement(QStringLiteral("tractor"));
-    if (!tractor.isNull()) {
-        QDomNodeList props = tractor.elementsByTagName(QStringLiteral("property"));
-        for (int i = 0; i < props.count(); ++i) {
-            if (props.at(i).toElement().attribute(QStringLiteral("name")) == QLatin1String("meta.volume")) {
-                props.at(i).firstChild().setNodeValue(QStringLiteral("1"));
-                break;
-            }
-        }
-    }
-    QDomNodeList pls = mlt.elementsByTagName(QStringLiteral("playlist"));
-    QDomElement mainPlaylist;
-    for (int i = 0; i < pls.count(); ++i) {
-        if (pls.at(i).toElement().attribute(QStringLiteral("id")) == pCore->binController()->binPlaylistId()) {
-            mainPlaylist = pls.at(i).toElement();
-            break;
-        }
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    if (streamSceneList(scene, pCore->binController()->binPlaylistId(), customEffects, &buffer)) {
+        sceneList.setContent(data, true);
     }
+    return sceneList;
+}
 
+QString KdenliveDoc::usedCustomEffects(const QString &scene, const EffectsList &customEffects, bool *ok)
+{
     // check if project contains custom effects to embed them in project file
-    QDomNodeList effects = mlt.elementsByTagName(QStringLiteral("filter"));
-    int maxEffects = effects.count();
-    //qCDebug(KDENLIVE_LOG) << "// FOUD " << maxEffects << " EFFECTS+++++++++++++++++++++";
     QMap<QString, QString> effectIds;
-    for (int i = 0; i < maxEffects; ++i) {
-        QDomNode m = effects.at(i);
-        QDomNodeList params = m.childNodes();
-        QString id;
-        QString tag;
-        for (int j = 0; j < params.count(); ++j) {
-            QDomElement e = params.item(j).toElement();
-            if (e.attribute(QStringLiteral("name")) == QLatin1String("kdenlive_id")) {
-                id = e.firstChild().nodeValue();
-            }
-            if (e.attribute(QStringLiteral("name")) == QLatin1String("tag")) {
-                tag = e.firstChild().nodeValue();
-            }
-            if (!id.isEmpty() && !tag.isEmpty()) {
-                effectIds.insert(id, tag);
+    QXmlStreamReader reader(scene);
+    bool inFilter = false;
+    bool hasRoot = false;
+    QString id;
+    QString tag;
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (reader.isStartElement()) {
+            hasRoot = true;
+            if (reader.name() == QLatin1String("filter")) {
+                inFilter = true;
+                id.clear();
+                tag.clear();
+            } else if (inFilter && reader.name() == QLatin1String("property")) {
+                const QStringRef name = reader.attributes().value(QStringLiteral("name"));
+                if (name == QLatin1String("kdenlive_id")) {
+                    id = reader.readElementText();
+                } else if (name == QLatin1String("tag")) {
+                    tag = reader.readElementText();
+                }
+                if (!id.isEmpty() && !tag.isEmpty()) {
+                    effectIds.insert(id, tag);
+                }
             }
+        } else if (reader.isEndElement() && reader.name() == QLatin1String("filter")) {
+            inFilter = false;
         }
     }
-    //TODO: find a way to process this before rendering MLT scenelist to xml
-    QDomDocument customeffects = initEffects::getUsedCustomEffects(effectIds);
-    if (!customeffects.documentElement().childNodes().isEmpty()) {
-        EffectsList::setProperty(mainPlaylist, QStringLiteral("kdenlive:customeffects"), customeffects.toString());
+    *ok = hasRoot && !reader.hasError();
+    if (!*ok || effectIds.isEmpty()) {
+        return QString();
     }
-    //addedXml.appendChild(sceneList.importNode(customeffects.documentElement(), true));
-
-    //TODO: move metadata to previous step in saving process
-    QDomElement docmetadata = sceneList.createElement(QStringLiteral("documentmetadata"));
-    QMapIterator<QString, QString> j(m_documentMetadata);
-    while (j.hasNext()) {
-        j.next();
-        docmetadata.setAttribute(j.key(), j.value());
+    QDomDocument customeffects = initEffects::getUsedCustomEffects(effectIds, customEffects);
+    if (customeffects.documentElement().childNodes().isEmpty()) {
+        return QString();
     }
-    //addedXml.appendChild(docmetadata);
-
-    return sceneList;
+    return customeffects.toString();
+}
+
+bool KdenliveDoc::streamSceneList(const QString &scene, const QString &binPlaylistId, const QString &customEffects, QIODevice *device)
+{
+    QXmlStreamReader reader(scene);
+    QXmlStreamWriter writer(device);
+    int depth = 0;
+    // The playlist volume is reset in the first tractor, the custom effects go in the bin playlist
+    int tractorDepth = -1;
+    bool tractorDone = false;
+    bool volumeDone = false;
+    int playlistDepth = -1;
+    bool playlistDone = false;
+    bool effectsDone = customEffects.isEmpty();
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (reader.isStartElement()) {
+            depth++;
+            if (reader.name() == QLatin1String("property")) {
+                const QStringRef name = reader.attributes().value(QStringLiteral("name"));
+                QString value;
+                if (tractorDepth >= 0 && !volumeDone && name == QLatin1String("meta.volume")) {
+                    // Set playlist audio volume to 100%
+                    value = QStringLiteral("1");
+                    volumeDone = true;
+                } else if (playlistDepth >= 0 && !effectsDone && name == QLatin1String("kdenlive:customeffects")) {
+                    value = customEffects;
+                    effectsDone = true;
+                }
+                if (!value.isNull()) {
+                    writer.writeCurrentToken(reader);
+                    reader.readElementText(QXmlStreamReader::IncludeChildElements);
+                    writer.writeCharacters(value);
+                    writer.writeEndElement();
+                    depth--;
+                    continue;
+                }
+            } else if (depth == 2 && !tractorDone && reader.name() == QLatin1String("tractor")) {
+                tractorDepth = depth;
+                tractorDone = true;
+            } else if (!playlistDone && reader.name() == QLatin1String("playlist") && reader.attributes().value(QStringLiteral("id")) == binPlaylistId) {
+                playlistDepth = depth;
+                playlistDone = true;
+            }
+        } else if (reader.isEndElement()) {
+            if (depth == playlistDepth) {
+                if (!effectsDone) {
+                    writer.writeStartElement(QStringLiteral("property"));
+                    writer.writeAttribute(QStringLiteral("name"), QStringLiteral("kdenlive:customeffects"));
+                    writer.writeCharacters(customEffects);
+                    writer.writeEndElement();
+                    effectsDone = true;
+                }
+                playlistDepth = -1;
+            } else if (depth == tractorDepth) {
+                tractorDepth = -1;
+            }
+            depth--;
+        }
+        writer.writeCurrentToken(reader);
+    }
+    return !reader.hasError() && !writer.hasError();
 }
 
 QString KdenliveDoc::documentNotes() const
@@ -681,8 +800,9 @@ QString KdenliveDoc::documentNotes() const
 
 bool KdenliveDoc::saveSceneList(const QString &path, const QString &scene)
 {
-    QDomDocument sceneList = xmlSceneList(scene);
-    if (sceneList.isNull()) {
+    bool ok;
+    const QString customEffects = usedCustomEffects(scene, MainWindow::customEffects, &ok);
+    if (!ok) {
         //Make sure we don't save if scenelist is corrupted
         KMessageBox::error(QApplication::activeWindow(), i18n("Cannot write to file %1, scene list is corrupted.", path));
         return false;
@@ -690,23 +810,21 @@ bool KdenliveDoc::saveSceneList(const QString &path, const QString &scene)
 
     // Backup current version
     backupLastSavedVersion(path);
-    QFile file(path);
+    // The project xml is streamed to the file, which is only replaced once completely written
+    QSaveFile file(path);
 
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    if (!file.open(QIODevice::WriteOnly)) {
         qCWarning(KDENLIVE_LOG) << "//////  ERROR writing to file: " << path;
         KMessageBox::error(QApplication::activeWindow(), i18n("Cannot write to file %1", path));
         return false;
     }
 
-    file.write(sceneList.toString().toUtf8());
-    if (file.error() != QFile::NoError) {
+    if (!streamSceneList(scene, pCore->binController()->binPlaylistId(), customEffects, &file) || !file.commit()) {
         KMessageBox::error(QApplication::activeWindow(), i18n("Cannot write to file %1", path));
-        file.close();
         return false;
     }
-    file.close();
     cleanupBackupFiles();
-    QFileInfo info(file);
+    QFileInfo info(path);
     QString fileName = QUrl::fromLocalFile(path).fileName().section(QLatin1Char('.'), 0, -2);
     fileName.append(QLatin1Char('-') + m_documentProperties.value(QStringLiteral("documentid")));
     fileName.append(info.lastModified().toString(QStringLiteral("-yyyy-MM-dd-hh-mm")));
@@ -898,6 +1016,9 @@ void KdenliveDoc::slotModified()
 void KdenliveDoc::setModified(bool mod)
 {
     // fix mantis#3160: The document may have an empty URL if not saved yet, but should have a m_autosave in any case
+    if (mod) {
+        m_revision++;
+    }
     if (m_autosave && mod) {
         emit startAutoSave();
     }
@@ -30,6 +30,7 @@
 #include <QList>
 #include <QDir>
 #include <QObject>
+#include <QFutureWatcher>
 #include <QTimer>
 #include <QUrl>
 
@@ -50,6 +51,7 @@ class TrackInfo;
 class NotesPlugin;
 class ProjectClip;
 class ClipController;
+class EffectsList;
 
 class QTextEdit;
 class QUndoGroup;
@@ -119,6 +121,10 @@ public:
     double projectDuration() const;
     /** @brief Returns the project file xml. */
     QDomDocument xmlSceneList(const QString &scene);
+    /** @brief Returns true if the document changed since the last autosave. */
+    bool needsAutoSave() const;
+    /** @brief Blocks until the autosave being written, if any, is on disk. */
+    void waitForAutoSave();
     /** @brief Saves the project file xml to a file. */
     bool saveSceneList(const QString &path, const QString &scene);
     /** @brief Saves only the MLT xml to a file for preview rendering. */
@@ -206,6 +212,27 @@ private:
     QMap<QString, QString> m_documentProperties;
     QMap<QString, QString> m_documentMetadata;
 
+    enum AutoSaveStatus { AutoSaveOk = 0, AutoSaveCorrupted, AutoSaveFailed };
+    /** @brief Incremented on each modification, to skip autosaves when nothing changed */
+    quint64 m_revision;
+    /** @brief Revision being written by the autosave worker */
+    quint64 m_autoSaveRevision;
+    /** @brief Revision of the autosave file */
+    quint64 m_autoSavedRevision;
+    /** @brief True if an autosave was requested while the previous one was still being written */
+    bool m_autoSavePending;
+    QFutureWatcher<int> m_autoSaveWatcher;
+
+    /** @brief Scans an MLT scene list for the custom effects it uses, safe to call from any thread.
+     *  @param ok set to false if the scene list is not valid xml
+     *  @return the customeffects xml to embed in the project file, empty if no custom effect is used */
+    static QString usedCustomEffects(const QString &scene, const EffectsList &customEffects, bool *ok);
+    /** @brief Writes the project file xml to device in one streaming pass over the MLT scene list, safe to call from any thread.
+     *  @description Resets the playlist volume and embeds the custom effects in the bin playlist on the fly.
+     *  @return false if the scene list could not be parsed or written */
+    static bool streamSceneList(const QString &scene, const QString &binPlaylistId, const QString &customEffects, QIODevice *device);
+    /** @brief Writes the project file xml to path, replacing the file atomically. Runs on a worker thread. */
+    static int writeAutoSave(const QString &path, const QString &scene, const QString &binPlaylistId, const EffectsList &customEffects);
     QString searchFileRecursively(const QDir &dir, const QString &matchSize, const QString &matchHash) const;
 
     /** @brief Creates a new project. */
@@ -231,7 +258,8 @@ public slots:
     void setModified(bool mod = true);
     void slotProxyCurrentItem(bool doProxy, QList<ProjectClip *> clipList = QList<ProjectClip *>(), bool force = false, QUndoCommand *masterCommand = nullptr);
     /** @brief Saves the current project at the autosave location.
-     * @description The autosave files are in ~/.kde/data/stalefiles/kdenlive/ */
+     * @description The autosave files are in ~/.kde/data/stalefiles/kdenlive/ \n
+     * Only the MLT scene list is built here, it is converted to the project xml and written on a worker thread. */
     void slotAutoSave();
 
 private slots:
@@ -244,6 +272,7 @@ private slots:
     void slotSwitchProfile();
     /** @brief Check if we did a new action invalidating more recent undo items. */
     void checkPreviewStack();
+    void slotAutoSaveFinished();
 
 signals:
     void resetProjectList();
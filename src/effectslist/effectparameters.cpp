@@ -0,0 +1,314 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent (agent@local)                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#include "effectparameters.h"
+
+#include <QDomNodeList>
+#include <QLocale>
+#include <QStringList>
+
+static QLocale parameterLocale()
+{
+    QLocale locale;
+    locale.setNumberOptions(QLocale::OmitGroupSeparator);
+    return locale;
+}
+
+/** @brief Format value with enough digits to read back the same double */
+static QString numberToString(const QLocale &locale, double value)
+{
+    QString text = locale.toString(value, 'g', 15);
+    if (locale.toDouble(text) != value) {
+        text = locale.toString(value, 'g', 17);
+    }
+    return text;
+}
+
+EffectParameters::EffectParameters() :
+    m_disabled(false)
+    , m_isAudio(false)
+    , m_isRegion(false)
+    , m_activeKeyframe(-1)
+    , m_modified(false)
+{
+}
+
+EffectParameters::EffectParameters(const QDomElement &effect) :
+    m_tag(effect.attribute(QStringLiteral("tag")))
+    , m_id(effect.attribute(QStringLiteral("id")))
+    , m_index(effect.attribute(QStringLiteral("kdenlive_ix")))
+    , m_disabled(effect.attribute(QStringLiteral("disable")) == QLatin1String("1"))
+    , m_isAudio(effect.attribute(QStringLiteral("type")) == QLatin1String("audio"))
+    , m_isRegion(m_id == QLatin1String("region"))
+    , m_activeKeyframe(-1)
+    , m_modified(false)
+{
+    const QLocale locale = parameterLocale();
+    const QDomNodeList params = effect.elementsByTagName(QStringLiteral("parameter"));
+    m_parameters.reserve(params.count());
+    for (int i = 0; i < params.count(); ++i) {
+        const QDomElement e = params.item(i).toElement();
+        Parameter param;
+        param.name = e.attribute(QStringLiteral("name"));
+        param.xmlType = e.attribute(QStringLiteral("type"));
+        param.defaultValue = e.attribute(QStringLiteral("default"));
+        param.number = 0;
+        param.modified = false;
+        const QString factor = e.attribute(QStringLiteral("factor"), QStringLiteral("1"));
+        param.evalFactor = factor.contains(QLatin1Char('%'));
+        param.factor = param.evalFactor ? 1 : parseNumber(factor);
+        param.offset = parseNumber(e.attribute(QStringLiteral("offset"), QStringLiteral("0")));
+        if (param.xmlType == QLatin1String("keyframe") || param.xmlType == QLatin1String("simplekeyframe")) {
+            param.type = Keyframes;
+            const QStringList keyframes = e.attribute(QStringLiteral("keyframes")).split(QLatin1Char(';'), QString::SkipEmptyParts);
+            for (const QString &str : keyframes) {
+                const int frame = str.section(QLatin1Char('='), 0, 0).toInt();
+                const QString value = str.section(QLatin1Char('='), 1, 1);
+                param.keyframes.insert(frame, parseNumber(value));
+                param.keyframeTexts.insert(frame, value);
+            }
+        } else if (param.xmlType.startsWith(QLatin1String("animated")) || param.xmlType == QLatin1String("geometry")) {
+            param.type = Animation;
+            param.text = e.attribute(QStringLiteral("value"));
+        } else if (param.xmlType == QLatin1String("double") || param.xmlType == QLatin1String("constant")) {
+            bool ok;
+            param.number = locale.toDouble(e.attribute(QStringLiteral("value"), param.defaultValue), &ok);
+            if (!ok) {
+                param.number = e.attribute(QStringLiteral("value"), param.defaultValue).toDouble(&ok);
+            }
+            param.type = ok ? Number : Text;
+            param.text = e.attribute(QStringLiteral("value"));
+        } else {
+            param.type = Text;
+            param.text = e.attribute(QStringLiteral("value"));
+        }
+        m_parameters.append(param);
+    }
+}
+
+bool EffectParameters::isNull() const
+{
+    return m_index.isEmpty();
+}
+
+bool EffectParameters::isDisabled() const
+{
+    return m_disabled;
+}
+
+bool EffectParameters::isAudio() const
+{
+    return m_isAudio;
+}
+
+int EffectParameters::count() const
+{
+    return m_parameters.count();
+}
+
+QString EffectParameters::name(int ix) const
+{
+    return m_parameters.at(ix).name;
+}
+
+EffectParameters::Type EffectParameters::type(int ix) const
+{
+    return m_parameters.at(ix).type;
+}
+
+QString EffectParameters::xmlType(int ix) const
+{
+    return m_parameters.at(ix).xmlType;
+}
+
+QString EffectParameters::defaultValue(int ix) const
+{
+    return m_parameters.at(ix).defaultValue;
+}
+
+double EffectParameters::number(int ix) const
+{
+    return m_parameters.at(ix).number;
+}
+
+void EffectParameters::setNumber(int ix, double value)
+{
+    Parameter &param = m_parameters[ix];
+    param.number = value;
+    param.text = numberToString(parameterLocale(), value);
+    param.modified = true;
+    m_modified = true;
+}
+
+QString EffectParameters::text(int ix) const
+{
+    return m_parameters.at(ix).text;
+}
+
+void EffectParameters::setText(int ix, const QString &value)
+{
+    Parameter &param = m_parameters[ix];
+    if (param.text == value && param.type != Number) {
+        return;
+    }
+    param.text = value;
+    if (param.type == Number) {
+        param.number = parameterLocale().toDouble(value);
+    }
+    param.modified = true;
+    m_modified = true;
+}
+
+QMap<int, double> EffectParameters::keyframes(int ix) const
+{
+    return m_parameters.at(ix).keyframes;
+}
+
+void EffectParameters::setKeyframes(int ix, const QMap<int, double> &keyframes)
+{
+    Parameter &param = m_parameters[ix];
+    param.keyframes = keyframes;
+    param.modified = true;
+    m_modified = true;
+}
+
+void EffectParameters::setActiveKeyframe(int frame)
+{
+    m_activeKeyframe = frame;
+    m_modified = true;
+}
+
+bool EffectParameters::isModified() const
+{
+    return m_modified;
+}
+
+bool EffectParameters::needsRebuild() const
+{
+    if (!m_modified) {
+        return false;
+    }
+    // Sub effects share the parameter names of the region effect
+    if (m_isRegion) {
+        return true;
+    }
+    // EffectManager always removes and adds these filters again
+    if (m_tag.startsWith(QLatin1String("ladspa")) || m_tag == QLatin1String("sox") || m_tag == QLatin1String("autotrack_rectangle")) {
+        return true;
+    }
+    for (const Parameter &param : m_parameters) {
+        if (!param.modified) {
+            continue;
+        }
+        // So are the keyframe effects
+        if (param.xmlType == QLatin1String("keyframe") || param.evalFactor) {
+            return true;
+        }
+    }
+    return false;
+}
+
+EffectsParameterList EffectParameters::modifiedArgs() const
+{
+    EffectsParameterList parameters;
+    parameters.addParam(QStringLiteral("tag"), m_tag);
+    parameters.addParam(QStringLiteral("kdenlive_ix"), m_index);
+    parameters.addParam(QStringLiteral("id"), m_id);
+    for (const Parameter &param : m_parameters) {
+        if (!param.modified) {
+            continue;
+        }
+        switch (param.type) {
+        case Keyframes: {
+            QStringList values;
+            values.reserve(param.keyframes.count());
+            for (QMap<int, double>::const_iterator it = param.keyframes.constBegin(); it != param.keyframes.constEnd(); ++it) {
+                values << QString::number(it.key()) + QLatin1Char('=') + mltValue(it.value(), param.factor, param.offset);
+            }
+            parameters.addParam(param.name, values.join(QLatin1Char(';')));
+            break;
+        }
+        default:
+            // Like EffectsController::adjustEffectParameters, which only passes animated values as is
+            if (param.xmlType != QLatin1String("animated") && (param.factor != 1 || param.offset != 0)) {
+                parameters.addParam(param.name, mltValue(param.text, param.factor, param.offset));
+            } else {
+                parameters.addParam(param.name, param.text);
+            }
+            break;
+        }
+    }
+    return parameters;
+}
+
+void EffectParameters::writeTo(QDomElement effect)
+{
+    if (!m_modified) {
+        return;
+    }
+    if (m_activeKeyframe >= 0) {
+        effect.setAttribute(QStringLiteral("active_keyframe"), m_activeKeyframe);
+        m_activeKeyframe = -1;
+    }
+    const QLocale locale = parameterLocale();
+    const QDomNodeList params = effect.elementsByTagName(QStringLiteral("parameter"));
+    for (int i = 0; i < params.count() && i < m_parameters.count(); ++i) {
+        Parameter &param = m_parameters[i];
+        if (!param.modified) {
+            continue;
+        }
+        QDomElement e = params.item(i).toElement();
+        if (param.type == Keyframes) {
+            QStringList values;
+            values.reserve(param.keyframes.count());
+            QMap<int, QString> texts;
+            for (QMap<int, double>::const_iterator it = param.keyframes.constBegin(); it != param.keyframes.constEnd(); ++it) {
+                QString text = param.keyframeTexts.value(it.key());
+                if (text.isEmpty() || locale.toDouble(text) != it.value()) {
+                    text = numberToString(locale, it.value());
+                }
+                texts.insert(it.key(), text);
+                values << QString::number(it.key()) + QLatin1Char('=') + text;
+            }
+            param.keyframeTexts = texts;
+            e.setAttribute(QStringLiteral("keyframes"), values.join(QLatin1Char(';')));
+        } else {
+            e.setAttribute(QStringLiteral("value"), param.text);
+        }
+        param.modified = false;
+    }
+    m_modified = false;
+}
+
+double EffectParameters::parseNumber(const QString &text)
+{
+    bool ok;
+    const double value = parameterLocale().toDouble(text, &ok);
+    return ok ? value : text.toDouble();
+}
+
+QString EffectParameters::mltValue(double value, double factor, double offset)
+{
+    return parameterLocale().toString((value - offset) / factor);
+}
+
+QString EffectParameters::mltValue(const QString &value, double factor, double offset)
+{
+    return mltValue(parseNumber(value), factor, offset);
+}
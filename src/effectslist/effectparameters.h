@@ -0,0 +1,118 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent (agent@local)                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef EFFECTPARAMETERS_H
+#define EFFECTPARAMETERS_H
+
+#include "mltcontroller/effectscontroller.h"
+
+#include <QDomElement>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+/**
+ * @class EffectParameters
+ * @brief Typed copy of the parameters of one effect instance.
+ *
+ * The parameters are parsed once from the effect xml: numbers as doubles,
+ * keyframe lists as frame / value maps, MLT animations as their serialized
+ * string. Edits only mark the changed parameters, so that just these are sent
+ * to the MLT filter and written back to the xml, instead of formatting and
+ * parsing the whole effect again.
+ *
+ * Parameters are in the order of the effect's parameter elements, like the
+ * indexes used by the timeline keyframes.
+ */
+class EffectParameters
+{
+public:
+    enum Type {
+        Text = 0,
+        Number,
+        /** @brief MLT animation or geometry, kept serialized since MLT parses it */
+        Animation,
+        /** @brief Kdenlive keyframes (keyframe and simplekeyframe parameters) */
+        Keyframes
+    };
+
+    EffectParameters();
+    explicit EffectParameters(const QDomElement &effect);
+    bool isNull() const;
+    bool isDisabled() const;
+    bool isAudio() const;
+    int count() const;
+    QString name(int ix) const;
+    Type type(int ix) const;
+    /** @brief The type attribute of the parameter xml (animated, geometry, ...) */
+    QString xmlType(int ix) const;
+    QString defaultValue(int ix) const;
+
+    double number(int ix) const;
+    void setNumber(int ix, double value);
+    /** @brief Value of a Text or Animation parameter. */
+    QString text(int ix) const;
+    void setText(int ix, const QString &value);
+    QMap<int, double> keyframes(int ix) const;
+    void setKeyframes(int ix, const QMap<int, double> &keyframes);
+    void setActiveKeyframe(int frame);
+
+    bool isModified() const;
+    /** @brief True if a modified parameter cannot be set on the existing MLT filter, which then has to be rebuilt from the xml. */
+    bool needsRebuild() const;
+    /** @brief Returns the MLT properties of the modified parameters, with the effect identification properties. */
+    EffectsParameterList modifiedArgs() const;
+    /** @brief Write the modified parameters to effect, which must be the xml this was parsed from, and clear the modified flags. */
+    void writeTo(QDomElement effect);
+
+    /** @brief Parse a number of the effect xml, written in the user locale or in the C locale */
+    static double parseNumber(const QString &text);
+    /** @brief The value sent to MLT for an xml value, once the parameter's offset and factor are removed */
+    static QString mltValue(double value, double factor, double offset);
+    static QString mltValue(const QString &value, double factor, double offset);
+
+private:
+    struct Parameter {
+        QString name;
+        QString xmlType;
+        Type type;
+        double number;
+        QString text;
+        QMap<int, double> keyframes;
+        /** @brief Keyframe values as written in the xml, kept as is when their value did not change */
+        QMap<int, QString> keyframeTexts;
+        QString defaultValue;
+        double factor;
+        double offset;
+        /** @brief The factor depends on the profile and has to be evaluated by EffectsController */
+        bool evalFactor;
+        bool modified;
+    };
+    QVector<Parameter> m_parameters;
+    QString m_tag;
+    QString m_id;
+    QString m_index;
+    bool m_disabled;
+    bool m_isAudio;
+    bool m_isRegion;
+    int m_activeKeyframe;
+    bool m_modified;
+};
+
+#endif
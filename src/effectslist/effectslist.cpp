@@ -21,6 +21,7 @@
 #include <klocalizedstring.h>
 
 EffectsList::EffectsList(bool indexRequired) : m_useIndex(indexRequired)
+    , m_lookup(new Lookup)
 {
     m_baseElement = createElement(QStringLiteral("list"));
     appendChild(m_baseElement);
@@ -32,95 +33,50 @@ EffectsList::~EffectsList()
 
 QDomElement EffectsList::getEffectByName(const QString &name) const
 {
-    QString effectName;
-    QDomNodeList effects = m_baseElement.childNodes();
-    for (int i = 0; i < effects.count(); ++i) {
-        QDomElement effect =  effects.at(i).toElement();
-        QDomElement namenode = effect.firstChildElement(QStringLiteral("name"));
-        if (!namenode.isNull()) {
-            effectName = i18n(namenode.text().toUtf8().data());
-        }
-        if (name == effectName) {
-            QDomNodeList params = effect.elementsByTagName(QStringLiteral("parameter"));
-            for (int i = 0; i < params.count(); ++i) {
-                QDomElement e = params.item(i).toElement();
-                if (!e.hasAttribute(QStringLiteral("value")) && e.attribute(QStringLiteral("type")) != QLatin1String("animatedrect") && e.attribute(QStringLiteral("paramlist")) != QLatin1String("%lumaPaths")) {
-                    e.setAttribute(QStringLiteral("value"), e.attribute(QStringLiteral("default")));
-                }
+    QDomElement effect = findElement(LookupName, name);
+    if (!effect.isNull()) {
+        QDomNodeList params = effect.elementsByTagName(QStringLiteral("parameter"));
+        for (int i = 0; i < params.count(); ++i) {
+            QDomElement e = params.item(i).toElement();
+            if (!e.hasAttribute(QStringLiteral("value")) && e.attribute(QStringLiteral("type")) != QLatin1String("animatedrect") && e.attribute(QStringLiteral("paramlist")) != QLatin1String("%lumaPaths")) {
+                e.setAttribute(QStringLiteral("value"), e.attribute(QStringLiteral("default")));
             }
-            return effect;
         }
     }
-
-    return QDomElement();
+    return effect;
 }
 
 QDomElement EffectsList::getEffectByTag(const QString &tag, const QString &id) const
 {
-    QDomNodeList effects = m_baseElement.childNodes();
-    if (effects.isEmpty()) {
-        return QDomElement();
+    if (!id.isEmpty()) {
+        return findElement(LookupId, id);
     }
-    for (int i = 0; i < effects.count(); ++i) {
-        QDomElement effect =  effects.at(i).toElement();
-        if (!id.isEmpty()) {
-            if (effect.attribute(QStringLiteral("id")) == id) {
-                if (effect.tagName() == QLatin1String("effectgroup")) {
-                    // Effect group
-                    QDomNodeList subeffects = effect.elementsByTagName(QStringLiteral("effect"));
-                    for (int j = 0; j < subeffects.count(); ++j) {
-                        QDomElement sub = subeffects.at(j).toElement();
-                    }
-                }
-                return effect;
-            }
-        } else if (!tag.isEmpty()) {
-            if (effect.attribute(QStringLiteral("tag")) == tag) {
-                return effect;
-            }
-        }
+    if (!tag.isEmpty()) {
+        return findElement(LookupTag, tag);
     }
     return QDomElement();
 }
 
 QDomElement EffectsList::effectById(const QString &id) const
 {
-    QDomNodeList effects = m_baseElement.childNodes();
-    for (int i = 0; i < effects.count(); ++i) {
-        QDomElement effect =  effects.at(i).toElement();
-        if (!id.isEmpty() && effect.attribute(QStringLiteral("id")) == id) {
-            return effect;
-        }
+    if (id.isEmpty()) {
+        return QDomElement();
     }
-    return QDomElement();
+    return findElement(LookupId, id);
 }
 
 bool EffectsList::hasTransition(const QString &tag) const
 {
-    QDomNodeList trans = m_baseElement.childNodes();
-    for (int i = 0; i < trans.count(); ++i) {
-        QDomElement effect =  trans.at(i).toElement();
-        if (effect.attribute(QStringLiteral("tag")) == tag) {
-            return true;
-        }
-    }
-    return false;
+    return !findElement(LookupTag, tag).isNull();
 }
 
 int EffectsList::hasEffect(const QString &tag, const QString &id) const
 {
-    QDomNodeList effects = m_baseElement.childNodes();
-    for (int i = 0; i < effects.count(); ++i) {
-        QDomElement effect =  effects.at(i).toElement();
-        if (!id.isEmpty()) {
-            if (effect.attribute(QStringLiteral("id")) == id) {
-                return effect.attribute(QStringLiteral("kdenlive_ix")).toInt();
-            }
-        } else if (!tag.isEmpty() && effect.attribute(QStringLiteral("tag")) == tag) {
-            return effect.attribute(QStringLiteral("kdenlive_ix")).toInt();
-        }
+    const QDomElement effect = getEffectByTag(tag, id);
+    if (effect.isNull()) {
+        return -1;
     }
-    return -1;
+    return effect.attribute(QStringLiteral("kdenlive_ix")).toInt();
 }
 
 QStringList EffectsList::effectIdInfo(const int ix) const
@@ -220,6 +176,8 @@ void EffectsList::clone(const EffectsList &original)
 {
     setContent(original.toString());
     m_baseElement = documentElement();
+    // The copies of the list sharing the previous document keep their lookup tables
+    m_lookup = QSharedPointer<Lookup>(new Lookup);
 }
 
 void EffectsList::clearList()
@@ -227,25 +185,19 @@ void EffectsList::clearList()
     while (!m_baseElement.firstChild().isNull()) {
         m_baseElement.removeChild(m_baseElement.firstChild());
     }
+    invalidateLookup();
 }
 
 // static
 void EffectsList::setParameter(QDomElement effect, const QString &name, const QString &value)
 {
-    QDomNodeList params = effect.elementsByTagName(QStringLiteral("parameter"));
-    bool found = false;
-    for (int i = 0; i < params.count(); ++i) {
-        QDomElement e = params.item(i).toElement();
-        if (e.attribute(QStringLiteral("name")) == name) {
-            e.setAttribute(QStringLiteral("value"), value);
-            found = true;
-            break;
-        }
-    }
-    if (!found) {
+    QDomElement e = findNamedElement(effect, QStringLiteral("parameter"), name);
+    if (!e.isNull()) {
+        e.setAttribute(QStringLiteral("value"), value);
+    } else {
         // create property
         QDomDocument doc = effect.ownerDocument();
-        QDomElement e = doc.createElement(QStringLiteral("parameter"));
+        e = doc.createElement(QStringLiteral("parameter"));
         e.setAttribute(QStringLiteral("name"), name);
         QDomText val = doc.createTextNode(value);
         e.appendChild(val);
@@ -256,34 +208,20 @@ void EffectsList::setParameter(QDomElement effect, const QString &name, const QS
 // static
 QString EffectsList::parameter(const QDomElement &effect, const QString &name)
 {
-    QDomNodeList params = effect.elementsByTagName(QStringLiteral("parameter"));
-    for (int i = 0; i < params.count(); ++i) {
-        QDomElement e = params.item(i).toElement();
-        if (e.attribute(QStringLiteral("name")) == name) {
-            return e.attribute(QStringLiteral("value"));
-        }
-    }
-    return QString();
+    return findNamedElement(effect, QStringLiteral("parameter"), name).attribute(QStringLiteral("value"));
 }
 
 // static
 void EffectsList::setProperty(QDomElement effect, const QString &name, const QString &value)
 {
-    QDomNodeList params = effect.elementsByTagName(QStringLiteral("property"));
     // Update property if it already exists
-    bool found = false;
-    for (int i = 0; i < params.count(); ++i) {
-        QDomElement e = params.item(i).toElement();
-        if (e.attribute(QStringLiteral("name")) == name) {
-            e.firstChild().setNodeValue(value);
-            found = true;
-            break;
-        }
-    }
-    if (!found) {
+    QDomElement e = findNamedElement(effect, QStringLiteral("property"), name);
+    if (!e.isNull()) {
+        e.firstChild().setNodeValue(value);
+    } else {
         // create property
         QDomDocument doc = effect.ownerDocument();
-        QDomElement e = doc.createElement(QStringLiteral("property"));
+        e = doc.createElement(QStringLiteral("property"));
         e.setAttribute(QStringLiteral("name"), name);
         QDomText val = doc.createTextNode(value);
         e.appendChild(val);
@@ -294,40 +232,28 @@ void EffectsList::setProperty(QDomElement effect, const QString &name, const QSt
 // static
 void EffectsList::renameProperty(const QDomElement &effect, const QString &oldName, const QString &newName)
 {
-    QDomNodeList params = effect.elementsByTagName(QStringLiteral("property"));
-    // Update property if it already exists
-    for (int i = 0; i < params.count(); ++i) {
-        QDomElement e = params.item(i).toElement();
-        if (e.attribute(QStringLiteral("name")) == oldName) {
-            e.setAttribute(QStringLiteral("name"), newName);
-            break;
-        }
+    QDomElement e = findNamedElement(effect, QStringLiteral("property"), oldName);
+    if (!e.isNull()) {
+        e.setAttribute(QStringLiteral("name"), newName);
     }
 }
 
 // static
 QString EffectsList::property(const QDomElement &effect, const QString &name)
 {
-    QDomNodeList params = effect.elementsByTagName(QStringLiteral("property"));
-    for (int i = 0; i < params.count(); ++i) {
-        QDomElement e = params.item(i).toElement();
-        if (e.attribute(QStringLiteral("name")) == name) {
-            return e.firstChild().nodeValue();
-        }
+    const QDomElement e = findNamedElement(effect, QStringLiteral("property"), name);
+    if (e.isNull()) {
+        return QString();
     }
-    return QString();
+    return e.firstChild().nodeValue();
 }
 
 // static
 void EffectsList::removeProperty(QDomElement effect, const QString &name)
 {
-    QDomNodeList params = effect.elementsByTagName(QStringLiteral("property"));
-    for (int i = 0; i < params.count(); ++i) {
-        QDomElement e = params.item(i).toElement();
-        if (e.attribute(QStringLiteral("name")) == name) {
-            effect.removeChild(params.item(i));
-            break;
-        }
+    QDomElement e = findNamedElement(effect, QStringLiteral("property"), name);
+    if (!e.isNull()) {
+        effect.removeChild(e);
     }
 }
 
@@ -352,6 +278,7 @@ QDomElement EffectsList::append(const QDomElement &e)
         if (m_useIndex) {
             updateIndexes(m_baseElement.childNodes(), m_baseElement.childNodes().count() - 1);
         }
+        invalidateLookup();
     }
     return result;
 }
@@ -385,6 +312,7 @@ void EffectsList::removeAt(int ix)
     if (m_useIndex) {
         updateIndexes(effects, ix - 1);
     }
+    invalidateLookup();
 }
 
 QDomElement EffectsList::itemFromIndex(int ix) const
@@ -411,6 +339,7 @@ QDomElement EffectsList::insert(const QDomElement &effect)
     if (m_useIndex && ix > 0) {
         updateIndexes(effects, ix - 1);
     }
+    invalidateLookup();
     return result;
 }
 
@@ -456,4 +385,98 @@ void EffectsList::updateEffect(const QDomElement &effect)
     } else {
         m_baseElement.appendChild(importNode(effect, true));
     }
+    invalidateLookup();
+}
+
+QDomElement EffectsList::findElement(LookupKey key, const QString &value) const
+{
+    for (int pass = 0; pass < 2; ++pass) {
+        if (!m_lookup->valid) {
+            buildLookup();
+        }
+        QDomElement effect;
+        QString current;
+        switch (key) {
+        case LookupId:
+            effect = m_lookup->byId.value(value);
+            current = effect.attribute(QStringLiteral("id"));
+            break;
+        case LookupTag:
+            effect = m_lookup->byTag.value(value);
+            current = effect.attribute(QStringLiteral("tag"));
+            break;
+        case LookupName:
+            // Translations don't change while the list is used
+            effect = m_lookup->byName.value(value);
+            current = value;
+            break;
+        }
+        if (effect.isNull()) {
+            return effect;
+        }
+        // The element may have been removed or changed without going through the list
+        if (effect.parentNode() == m_baseElement && current == value) {
+            return effect;
+        }
+        m_lookup->valid = false;
+    }
+    return QDomElement();
+}
+
+void EffectsList::buildLookup() const
+{
+    Lookup &lookup = *m_lookup;
+    lookup.byId.clear();
+    lookup.byTag.clear();
+    lookup.byName.clear();
+    for (QDomElement effect = m_baseElement.firstChildElement(); !effect.isNull(); effect = effect.nextSiblingElement()) {
+        const QString id = effect.attribute(QStringLiteral("id"));
+        if (!id.isEmpty() && !lookup.byId.contains(id)) {
+            lookup.byId.insert(id, effect);
+        }
+        const QString tag = effect.attribute(QStringLiteral("tag"));
+        if (!tag.isEmpty() && !lookup.byTag.contains(tag)) {
+            lookup.byTag.insert(tag, effect);
+        }
+        QDomElement namenode = effect.firstChildElement(QStringLiteral("name"));
+        if (!namenode.isNull()) {
+            const QString name = i18n(namenode.text().toUtf8().data());
+            if (!lookup.byName.contains(name)) {
+                lookup.byName.insert(name, effect);
+            }
+        }
+    }
+    lookup.valid = true;
+}
+
+void EffectsList::invalidateLookup()
+{
+    m_lookup->valid = false;
+}
+
+// static
+QDomElement EffectsList::findNamedElement(const QDomElement &effect, const QString &tagName, const QString &name)
+{
+    // Same order as elementsByTagName(), without building the list of all the matching elements
+    QDomNode node = effect.firstChild();
+    while (!node.isNull()) {
+        if (node.isElement()) {
+            QDomElement e = node.toElement();
+            if (e.tagName() == tagName && e.attribute(QStringLiteral("name")) == name) {
+                return e;
+            }
+        }
+        if (node.hasChildNodes()) {
+            node = node.firstChild();
+            continue;
+        }
+        while (node.nextSibling().isNull()) {
+            node = node.parentNode();
+            if (node.isNull() || node == effect) {
+                return QDomElement();
+            }
+        }
+        node = node.nextSibling();
+    }
+    return QDomElement();
 }
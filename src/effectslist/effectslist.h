@@ -26,6 +26,8 @@
 #define EFFECTSLIST_H
 
 #include <QDomDocument>
+#include <QHash>
+#include <QSharedPointer>
 
 namespace Kdenlive
 {
@@ -100,8 +102,26 @@ public:
     bool enableEffects(const QList<int> &indexes, bool disable);
 
 private:
+    /** @brief First element of the list for each id, tag and translated name.
+     *  It is shared by the copies of the list, like the DOM itself, and rebuilt on first use after a change of the list. */
+    struct Lookup {
+        Lookup() : valid(false) {}
+        bool valid;
+        QHash<QString, QDomElement> byId;
+        QHash<QString, QDomElement> byTag;
+        QHash<QString, QDomElement> byName;
+    };
+    enum LookupKey { LookupId, LookupTag, LookupName };
     QDomElement m_baseElement;
     bool m_useIndex;
+    QSharedPointer<Lookup> m_lookup;
+
+    /** @brief Returns the first element with key, rebuilding the lookup tables if they are out of date. */
+    QDomElement findElement(LookupKey key, const QString &value) const;
+    void buildLookup() const;
+    void invalidateLookup();
+    /** @brief Returns the first descendant of effect with tagName and a name attribute equal to name. */
+    static QDomElement findNamedElement(const QDomElement &effect, const QString &tagName, const QString &name);
 };
 
 #endif
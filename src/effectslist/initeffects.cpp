@@ -22,12 +22,20 @@
 
 #include "kdenlivesettings.h"
 #include "mainwindow.h"
+#include "core.h"
 
 #include "kdenlive_debug.h"
+#include "config-kdenlive.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
 #include <QFile>
 #include <QDir>
+#include <QMutexLocker>
+#include <QSaveFile>
 #include <QStandardPaths>
+#include <QtConcurrent>
 
 #include <klocalizedstring.h>
 #include <locale>
@@ -35,13 +43,17 @@
 #include <xlocale.h>
 #endif
 
+// Bump when the content of the cached catalog changes
+static const qint32 catalogCacheVersion = 1;
+static QFuture<void> catalogRefresh;
+
 // static
-void initEffects::refreshLumas()
+QMap<QString, QStringList> initEffects::findLumas()
 {
     // Check for Kdenlive installed luma files, add empty string at start for no luma
+    QMap<QString, QStringList> lumaFiles;
     QStringList imagefiles;
     QStringList fileFilters;
-    MainWindow::m_lumaFiles.clear();
     fileFilters << QStringLiteral("*.png") << QStringLiteral("*.pgm");
     QStringList customLumas = QStandardPaths::locateAll(QStandardPaths::AppDataLocation, QStringLiteral("lumas"), QStandardPaths::LocateDirectory);
     customLumas.append(QString(mlt_environment("MLT_DATA")) + QStringLiteral("/lumas"));
@@ -51,15 +63,22 @@ void initEffects::refreshLumas()
         foreach (const QString &f, folders) {
             QDir dir(topDir.absoluteFilePath(f));
             QStringList filesnames = dir.entryList(fileFilters, QDir::Files);
-            if (MainWindow::m_lumaFiles.contains(f)) {
-                imagefiles = MainWindow::m_lumaFiles.value(f);
+            if (lumaFiles.contains(f)) {
+                imagefiles = lumaFiles.value(f);
             }
             foreach (const QString &fname, filesnames) {
                 imagefiles.append(dir.absoluteFilePath(fname));
             }
-            MainWindow::m_lumaFiles.insert(f, imagefiles);
+            lumaFiles.insert(f, imagefiles);
         }
     }
+    return lumaFiles;
+}
+
+// static
+void initEffects::refreshLumas()
+{
+    MainWindow::m_lumaFiles = findLumas();
     /*
 
     QStringList imagenamelist = QStringList() << i18n("None");
@@ -110,7 +129,7 @@ void initEffects::refreshLumas()
 }
 
 // static
-QDomDocument initEffects::getUsedCustomEffects(const QMap<QString, QString> &effectids)
+QDomDocument initEffects::getUsedCustomEffects(const QMap<QString, QString> &effectids, const EffectsList &customEffects)
 {
     QMapIterator<QString, QString> i(effectids);
     QDomDocument doc;
@@ -118,9 +137,9 @@ QDomDocument initEffects::getUsedCustomEffects(const QMap<QString, QString> &eff
     doc.appendChild(list);
     while (i.hasNext()) {
         i.next();
-        int ix = MainWindow::customEffects.hasEffect(i.value(), i.key());
+        int ix = customEffects.hasEffect(i.value(), i.key());
         if (ix > -1) {
-            QDomElement e = MainWindow::customEffects.at(ix);
+            QDomElement e = customEffects.at(ix);
             list.appendChild(doc.importNode(e, true));
         }
     }
@@ -131,16 +150,15 @@ QDomDocument initEffects::getUsedCustomEffects(const QMap<QString, QString> &eff
 bool initEffects::parseEffectFiles(std::unique_ptr<Mlt::Repository> &repository, const QString &locale)
 {
     bool movit = false;
-    QStringList::Iterator more;
-    QStringList::Iterator it;
-    QStringList fileList;
-    QString itemName;
 
     if (!repository) {
         //qCDebug(KDENLIVE_LOG) << "Repository didn't finish initialisation" ;
         return movit;
     }
 
+    // A refresh started by a previous call may still use the repository or write the cache
+    waitForCatalogRefresh();
+
     // Warning: Mlt::Factory::init() resets the locale to the default system value, make sure we keep correct locale
     if (!locale.isEmpty()) {
 #ifndef Q_OS_MAC
@@ -195,6 +213,49 @@ bool initEffects::parseEffectFiles(std::unique_ptr<Mlt::Repository> &repository,
     }
     delete transitions;
 
+    const QByteArray key = catalogKey(filtersList, producersList, transitionsItemList);
+    if (loadCatalogCache(key)) {
+        // The key does not cover everything MLT reports about its services, check the cache in the background.
+        // The catalog built there is only used on next start.
+        std::unique_ptr<Mlt::Repository> *repo = &repository;
+        catalogRefresh = QtConcurrent::run([repo, key, filtersList, producersList, transitionsItemList]() {
+            EffectsList transitionsCatalog;
+            EffectsList customCatalog;
+            EffectsList audioCatalog;
+            EffectsList videoCatalog;
+            buildCatalog(*repo, filtersList, producersList, transitionsItemList, &transitionsCatalog, &customCatalog, &audioCatalog, &videoCatalog);
+            saveCatalogCache(key, transitionsCatalog, customCatalog, audioCatalog, videoCatalog, findLumas());
+        });
+        return movit;
+    }
+
+    // Get list of installed luma files
+    refreshLumas();
+
+    MainWindow::transitions.clearList();
+    MainWindow::customEffects.clearList();
+    MainWindow::audioEffects.clearList();
+    MainWindow::videoEffects.clearList();
+    buildCatalog(repository, filtersList, producersList, transitionsItemList, &MainWindow::transitions, &MainWindow::customEffects, &MainWindow::audioEffects, &MainWindow::videoEffects);
+    saveCatalogCache(key, MainWindow::transitions, MainWindow::customEffects, MainWindow::audioEffects, MainWindow::videoEffects, MainWindow::m_lumaFiles);
+    return movit;
+}
+
+// static
+void initEffects::waitForCatalogRefresh()
+{
+    catalogRefresh.waitForFinished();
+}
+
+// static
+void initEffects::buildCatalog(std::unique_ptr<Mlt::Repository> &repository, const QStringList &filtersList, const QStringList &producersList, QStringList transitionsItemList, EffectsList *transitions, EffectsList *customEffects, EffectsList *audioEffects, EffectsList *videoEffects)
+{
+    QStringList::Iterator more;
+    QStringList::Iterator it;
+    QStringList fileList;
+    QString itemName;
+    int max;
+
     // Create structure holding all transitions descriptions so that if an XML file has no description, we take it from MLT
     QMap<QString, QString> transDescriptions;
     foreach (const QString &transname, transitionsItemList) {
@@ -210,9 +271,6 @@ bool initEffects::parseEffectFiles(std::unique_ptr<Mlt::Repository> &repository,
     }
     transitionsItemList.sort();
 
-    // Get list of installed luma files
-    refreshLumas();
-
     // Parse xml transition files
     QStringList direc = QStandardPaths::locateAll(QStandardPaths::AppDataLocation, QStringLiteral("transitions"), QStandardPaths::LocateDirectory);
     // Iterate through effects directories to parse all XML files.
@@ -223,7 +281,7 @@ bool initEffects::parseEffectFiles(std::unique_ptr<Mlt::Repository> &repository,
         fileList = directory.entryList(filter, QDir::Files);
         for (it = fileList.begin(); it != fileList.end(); ++it) {
             itemName = directory.absoluteFilePath(*it);
-            parseTransitionFile(&MainWindow::transitions, itemName, repository, transitionsItemList, transDescriptions);
+            parseTransitionFile(transitions, itemName, repository, transitionsItemList, transDescriptions);
         }
     }
 
@@ -242,7 +300,7 @@ bool initEffects::parseEffectFiles(std::unique_ptr<Mlt::Repository> &repository,
     }
 
     // Fill transitions list.
-    fillTransitionsList(repository, &MainWindow::transitions, transitionsItemList);
+    fillTransitionsList(repository, transitions, transitionsItemList);
 
     // Remove blacklisted effects from the filters list.
     QStringList mltFiltersList = filtersList;
@@ -276,14 +334,14 @@ bool initEffects::parseEffectFiles(std::unique_ptr<Mlt::Repository> &repository,
     QMap<QString, QDomElement> audioEffectsMap;
 
     // Create transitions
-    max = MainWindow::transitions.count();
+    max = transitions->count();
     for (int i = 0; i < max; ++i) {
-        effectInfo = MainWindow::transitions.at(i);
+        effectInfo = transitions->at(i);
         effectsMap.insert(effectInfo.firstChildElement(QStringLiteral("name")).text().toLower().toUtf8().data(), effectInfo);
     }
-    MainWindow::transitions.clearList();
+    transitions->clearList();
     foreach (const QDomElement &effect, effectsMap) {
-        MainWindow::transitions.append(effect);
+        transitions->append(effect);
     }
     effectsMap.clear();
 
@@ -337,52 +395,180 @@ bool initEffects::parseEffectFiles(std::unique_ptr<Mlt::Repository> &repository,
         fileList = directory.entryList(filter, QDir::Files);
         for (it = fileList.begin(); it != fileList.end(); ++it) {
             itemName = directory.absoluteFilePath(*it);
-            parseEffectFile(&MainWindow::customEffects,
-                            &MainWindow::audioEffects,
-                            &MainWindow::videoEffects,
+            parseEffectFile(customEffects, audioEffects, videoEffects,
                             itemName, filtersList, producersList, repository, effectDescriptions);
         }
     }
 
     // Create custom effects
-    max = MainWindow::customEffects.count();
+    max = customEffects->count();
     for (int i = 0; i < max; ++i) {
-        effectInfo = MainWindow::customEffects.at(i);
+        effectInfo = customEffects->at(i);
         if (effectInfo.tagName() == QLatin1String("effectgroup")) {
             effectsMap.insert(effectInfo.attribute(QStringLiteral("name")).toUtf8().data(), effectInfo);
         } else {
             effectsMap.insert(effectInfo.firstChildElement(QStringLiteral("name")).text().toUtf8().data(), effectInfo);
         }
     }
-    MainWindow::customEffects.clearList();
+    customEffects->clearList();
     foreach (const QDomElement &effect, effectsMap) {
-        MainWindow::customEffects.append(effect);
+        customEffects->append(effect);
     }
     effectsMap.clear();
 
     // Create audio effects
-    max = MainWindow::audioEffects.count();
+    max = audioEffects->count();
     for (int i = 0; i < max; ++i) {
-        effectInfo = MainWindow::audioEffects.at(i);
+        effectInfo = audioEffects->at(i);
         audioEffectsMap.insert(effectInfo.firstChildElement(QStringLiteral("name")).text().toLower().toUtf8().data(), effectInfo);
     }
-    MainWindow::audioEffects.clearList();
+    audioEffects->clearList();
     foreach (const QDomElement &effect, audioEffectsMap) {
-        MainWindow::audioEffects.append(effect);
+        audioEffects->append(effect);
     }
 
     // Create video effects
-    max = MainWindow::videoEffects.count();
+    max = videoEffects->count();
     for (int i = 0; i < max; ++i) {
-        effectInfo = MainWindow::videoEffects.at(i);
+        effectInfo = videoEffects->at(i);
         videoEffectsMap.insert(effectInfo.firstChildElement(QStringLiteral("name")).text().toLower().toUtf8().data(), effectInfo);
     }
-    MainWindow::videoEffects.clearList();
+    videoEffects->clearList();
     foreach (const QDomElement &effect, videoEffectsMap) {
-        MainWindow::videoEffects.append(effect);
+        videoEffects->append(effect);
     }
+}
 
-    return movit;
+/** @brief Add the path, modification time and size of path to hash, and those of the entries of the folder matching filters. */
+static void addPathToKey(QCryptographicHash &hash, const QString &path, const QStringList &nameFilters, QDir::Filters filters)
+{
+    QFileInfo info(path);
+    hash.addData(path.toUtf8());
+    if (!info.exists()) {
+        return;
+    }
+    hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    if (!info.isDir()) {
+        hash.addData(QByteArray::number(info.size()));
+        return;
+    }
+    const QFileInfoList entries = QDir(path).entryInfoList(nameFilters, filters, QDir::Name);
+    for (const QFileInfo &entry : entries) {
+        hash.addData(entry.fileName().toUtf8());
+        hash.addData(QByteArray::number(entry.lastModified().toMSecsSinceEpoch()));
+        hash.addData(QByteArray::number(entry.size()));
+    }
+}
+
+// static
+QByteArray initEffects::catalogKey(const QStringList &filtersList, const QStringList &producersList, const QStringList &transitionsList)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(catalogCacheVersion));
+    hash.addData(KDENLIVE_VERSION);
+    hash.addData(mlt_version_get_string());
+    // Parameter values are converted to the numeric locale
+    QLocale locale;
+    hash.addData(locale.name().toUtf8());
+    hash.addData(QString(locale.decimalPoint()).toUtf8());
+    hash.addData(filtersList.join(QLatin1Char(',')).toUtf8());
+    hash.addData(producersList.join(QLatin1Char(',')).toUtf8());
+    hash.addData(transitionsList.join(QLatin1Char(',')).toUtf8());
+    hash.addData(mlt_environment("MLT_REPOSITORY"));
+    addPathToKey(hash, QString(mlt_environment("MLT_REPOSITORY")), QStringList(), QDir::Files);
+    const QStringList xmlFilter = QStringList() << QStringLiteral("*.xml");
+    const QStringList folders = QStringList() << QStringLiteral("transitions") << QStringLiteral("effects");
+    for (const QString &folder : folders) {
+        const QStringList direc = QStandardPaths::locateAll(QStandardPaths::AppDataLocation, folder, QStandardPaths::LocateDirectory);
+        for (const QString &path : direc) {
+            addPathToKey(hash, path, xmlFilter, QDir::Files);
+        }
+    }
+    const QStringList blacklists = QStringList() << QStringLiteral("blacklisted_transitions.txt") << QStringLiteral("blacklisted_effects.txt");
+    for (const QString &name : blacklists) {
+        addPathToKey(hash, QStandardPaths::locate(QStandardPaths::AppDataLocation, name), QStringList(), QDir::Files);
+    }
+    QStringList lumas = QStandardPaths::locateAll(QStandardPaths::AppDataLocation, QStringLiteral("lumas"), QStandardPaths::LocateDirectory);
+    lumas.append(QString(mlt_environment("MLT_DATA")) + QStringLiteral("/lumas"));
+    for (const QString &path : lumas) {
+        addPathToKey(hash, path, QStringList(), QDir::AllDirs | QDir::NoDotAndDotDot);
+    }
+    return hash.result();
+}
+
+// static
+QString initEffects::catalogCachePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/effectcatalog.cache");
+}
+
+// static
+bool initEffects::loadCatalogCache(const QByteArray &key)
+{
+    QFile file(catalogCachePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+    qint32 version = 0;
+    QByteArray cachedKey;
+    in >> version;
+    if (version != catalogCacheVersion) {
+        return false;
+    }
+    in >> cachedKey;
+    if (cachedKey != key) {
+        return false;
+    }
+    QByteArray data[4];
+    QMap<QString, QStringList> lumas;
+    for (QByteArray &list : data) {
+        in >> list;
+    }
+    in >> lumas;
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+    QDomDocument docs[4];
+    for (int i = 0; i < 4; ++i) {
+        if (!docs[i].setContent(qUncompress(data[i]))) {
+            qCDebug(KDENLIVE_LOG) << "Invalid effect catalog cache" << file.fileName();
+            return false;
+        }
+    }
+    EffectsList *lists[4] = { &MainWindow::transitions, &MainWindow::customEffects, &MainWindow::audioEffects, &MainWindow::videoEffects };
+    for (int i = 0; i < 4; ++i) {
+        lists[i]->clearList();
+        QDomElement effect = docs[i].documentElement().firstChildElement();
+        while (!effect.isNull()) {
+            lists[i]->append(effect);
+            effect = effect.nextSiblingElement();
+        }
+    }
+    MainWindow::m_lumaFiles = lumas;
+    return true;
+}
+
+// static
+void initEffects::saveCatalogCache(const QByteArray &key, const EffectsList &transitions, const EffectsList &customEffects, const EffectsList &audioEffects, const EffectsList &videoEffects, const QMap<QString, QStringList> &lumas)
+{
+    const QString path = catalogCachePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCDebug(KDENLIVE_LOG) << "Cannot write effect catalog cache" << path;
+        return;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << catalogCacheVersion << key;
+    const EffectsList *lists[4] = { &transitions, &customEffects, &audioEffects, &videoEffects };
+    for (const EffectsList *list : lists) {
+        out << qCompress(list->toString(-1).toUtf8());
+    }
+    out << lumas;
+    file.commit();
 }
 
 // static
@@ -507,11 +693,13 @@ void initEffects::parseEffectFile(EffectsList *customEffectList, EffectsList *au
         }
 
         double version = -1;
+        pCore->getMltRepositoryMutex()->lock();
         Mlt::Properties *metadata = repository->metadata(filter_type, tag.toUtf8().data());
         if (metadata && metadata->is_valid()) {
             version = metadata->get_double("version");
         }
         delete metadata;
+        pCore->getMltRepositoryMutex()->unlock();
 
         if (documentElement.hasAttribute(QStringLiteral("version"))) {
             // a specific version of the filter is required
@@ -554,6 +742,7 @@ QDomDocument initEffects::createDescriptionFromMlt(std::unique_ptr<Mlt::Reposito
 {
 
     QDomDocument ret;
+    QMutexLocker locker(pCore->getMltRepositoryMutex());
     Mlt::Properties *metadata = repository->metadata(filter_type, filtername.toLatin1().data());
     ////qCDebug(KDENLIVE_LOG) << filtername;
     if (metadata && metadata->is_valid()) {
@@ -710,6 +899,7 @@ void initEffects::fillTransitionsList(std::unique_ptr<Mlt::Repository> &reposito
         QDomElement desc = ret.createElement(QStringLiteral("description"));
         ktrans.appendChild(tname);
         ktrans.appendChild(desc);
+        QMutexLocker locker(pCore->getMltRepositoryMutex());
         Mlt::Properties *metadata = nullptr;
         if (!customTransitions.contains(name)) {
             metadata = repository->metadata(transition_type, name.toUtf8().data());
@@ -990,11 +1180,13 @@ void initEffects::parseTransitionFile(EffectsList *transitionList, const QString
         }
 
         double version = -1;
+        pCore->getMltRepositoryMutex()->lock();
         Mlt::Properties *metadata = repository->metadata(transition_type, id.toUtf8().data());
         if (metadata && metadata->is_valid()) {
             version = metadata->get_double("version");
         }
         delete metadata;
+        pCore->getMltRepositoryMutex()->unlock();
 
         if (documentElement.hasAttribute(QStringLiteral("version"))) {
             // a specific version of the filter is required
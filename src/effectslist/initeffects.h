@@ -41,11 +41,20 @@ public:
      *
      * It checks for all available effects and transitions, removes blacklisted
      * ones, calls fillTransitionsList() and parseEffectFile() to fill the lists
-     * (with sorted, unique items) and then fills the global lists. */
+     * (with sorted, unique items) and then fills the global lists.
+     *
+     * The lists are loaded from a cache when MLT, the installed data files
+     * and the locale did not change since it was written. The cache is then
+     * rebuilt in the background for the next start, see waitForCatalogRefresh(). */
     static bool parseEffectFiles(std::unique_ptr<Mlt::Repository> &repository, const QString &locale = QString());
+    /** @brief Waits for the background refresh of the effect catalog cache, must be called before deleting the repository. */
+    static void waitForCatalogRefresh();
     static void refreshLumas();
+    /** @brief Returns the installed luma files, by format folder, does not use the global list. */
+    static QMap<QString, QStringList> findLumas();
     static QDomDocument createDescriptionFromMlt(std::unique_ptr<Mlt::Repository> &repository, const QString &type, const QString &name);
-    static QDomDocument getUsedCustomEffects(const QMap<QString, QString> &effectids);
+    /** @brief Returns the effects of customEffects matching effectids (id, tag), does not use the global lists. */
+    static QDomDocument getUsedCustomEffects(const QMap<QString, QString> &effectids, const EffectsList &customEffects);
 
     /** @brief Fills the transitions list.
      * @param repository MLT repository
@@ -96,6 +105,17 @@ public:
 
 private:
     initEffects(); // disable the constructor
+
+    /** @brief Fills the given lists with all the available effects and transitions, does not use the global lists. */
+    static void buildCatalog(std::unique_ptr<Mlt::Repository> &repository, const QStringList &filtersList, const QStringList &producersList, QStringList transitionsItemList,
+                             EffectsList *transitions, EffectsList *customEffects, EffectsList *audioEffects, EffectsList *videoEffects);
+    /** @brief Returns the key identifying the catalog built from the MLT services, the installed data files and the locale. */
+    static QByteArray catalogKey(const QStringList &filtersList, const QStringList &producersList, const QStringList &transitionsList);
+    static QString catalogCachePath();
+    /** @brief Fills the global lists from the cache if it was written with key. */
+    static bool loadCatalogCache(const QByteArray &key);
+    static void saveCatalogCache(const QByteArray &key, const EffectsList &transitions, const EffectsList &customEffects, const EffectsList &audioEffects,
+                                 const EffectsList &videoEffects, const QMap<QString, QStringList> &lumas);
 };
 
 #endif
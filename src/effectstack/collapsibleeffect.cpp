@@ -509,6 +509,32 @@ void CollapsibleEffect::updateWidget(const ItemInfo &info, const QDomElement &ef
     setupWidget(info, metaInfo);
 }
 
+bool CollapsibleEffect::rebind(const QDomElement &effect, const QDomElement &original_effect, const ItemInfo &info, bool canMoveUp, bool lastEffect)
+{
+    if (m_regionEffect || !m_paramWidget || effect.attribute(QStringLiteral("id")) != m_effect.attribute(QStringLiteral("id"))) {
+        return false;
+    }
+    EffectInfo effectInfo;
+    effectInfo.fromString(effect.attribute(QStringLiteral("kdenlive_info")));
+    // Group and collapsed state change the frame and menu
+    if (effectInfo.groupIndex != m_info.groupIndex || effectInfo.isCollapsed != m_info.isCollapsed) {
+        return false;
+    }
+    if (!m_paramWidget->rebind(effect, info)) {
+        return false;
+    }
+    m_effect = effect;
+    m_original_effect = original_effect;
+    m_itemInfo = info;
+    m_info = effectInfo;
+    buttonUp->setEnabled(canMoveUp);
+    buttonDown->setEnabled(!lastEffect);
+    bool disable = m_effect.attribute(QStringLiteral("disable")) == QLatin1String("1");
+    title->setEnabled(!disable);
+    m_enabledButton->setActive(disable);
+    return true;
+}
+
 void CollapsibleEffect::updateFrameInfo()
 {
     if (m_paramWidget) {
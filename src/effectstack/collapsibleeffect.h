@@ -53,6 +53,9 @@ public:
     bool eventFilter(QObject *o, QEvent *e) Q_DECL_OVERRIDE;
     /** @brief Update effect GUI to reflect parameted changes. */
     void updateWidget(const ItemInfo &info, const QDomElement &effect, EffectMetaInfo *metaInfo);
+    /** @brief Reuse this widget for another instance of the same effect, only updating the parameter values.
+     *  @return false if the effect needs a new widget */
+    bool rebind(const QDomElement &effect, const QDomElement &original_effect, const ItemInfo &info, bool canMoveUp, bool lastEffect);
     /** @brief Returns effect xml. */
     QDomElement effect() const;
     /** @brief Returns effect xml with keyframe offset for saving. */
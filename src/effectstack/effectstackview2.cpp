@@ -41,6 +41,7 @@
 #include <QScrollBar>
 #include <QDrag>
 #include <QMimeData>
+#include <QHash>
 
 EffectStackView2::EffectStackView2(Monitor *projectMonitor, QWidget *parent) :
     QWidget(parent),
@@ -302,30 +303,39 @@ void EffectStackView2::setupListView()
     m_draggedEffect = nullptr;
     m_draggedGroup = nullptr;
     disconnect(m_effectMetaInfo.monitor, &Monitor::renderPosition, this, &EffectStackView2::slotRenderPos);
-    QWidget *view = m_effect->container->takeWidget();
-    if (view) {
-        /*QList<CollapsibleEffect *> allChildren = view->findChildren<CollapsibleEffect *>();
-        qCDebug(KDENLIVE_LOG)<<" * * *FOUND CHLD: "<<allChildren.count();
-        foreach(CollapsibleEffect *eff, allChildren) {
-            eff->setEnabled(false);
-        }*/
-        //delete view;
-        view->setEnabled(false);
-        view->setHidden(true);
-        view->deleteLater();
+    QWidget *view = m_effect->container->widget();
+    QVBoxLayout *vbox1 = nullptr;
+    // Effect widgets that may be reused for an effect of the same type
+    QMultiHash<QString, CollapsibleEffect *> unusedEffects;
+    if (view && canReuseEffectWidgets()) {
+        for (CollapsibleEffect *effect : m_effects) {
+            unusedEffects.insert(effect->effect().attribute(QStringLiteral("id")), effect);
+        }
+        vbox1 = static_cast<QVBoxLayout *>(view->layout());
+        QLayoutItem *item;
+        while ((item = vbox1->takeAt(0))) {
+            delete item;
+        }
+    } else {
+        view = m_effect->container->takeWidget();
+        if (view) {
+            view->setEnabled(false);
+            view->setHidden(true);
+            view->deleteLater();
+        }
+        view = new QWidget(this);
+        QPalette p = qApp->palette();
+        p.setBrush(QPalette::Window, QBrush(Qt::transparent));
+        view->setPalette(p);
+        m_effect->container->setWidget(view);
+
+        vbox1 = new QVBoxLayout(view);
+        vbox1->setContentsMargins(0, 0, 0, 0);
+        vbox1->setSpacing(0);
     }
     m_effects.clear();
     m_groupIndex = 0;
     blockSignals(false);
-    view = new QWidget(this);
-    QPalette p = qApp->palette();
-    p.setBrush(QPalette::Window, QBrush(Qt::transparent));
-    view->setPalette(p);
-    m_effect->container->setWidget(view);
-
-    QVBoxLayout *vbox1 = new QVBoxLayout(view);
-    vbox1->setContentsMargins(0, 0, 0, 0);
-    vbox1->setSpacing(0);
 
     int effectsCount = m_currentEffectList.count();
     m_effect->effectCompare->setEnabled(effectsCount > 0);
@@ -400,7 +410,19 @@ void EffectStackView2::setupListView()
         if (i == 0 || m_currentEffectList.at(i - 1).attribute(QStringLiteral("id")) == QLatin1String("speed")) {
             canMoveUp = false;
         }
-        CollapsibleEffect *currentEffect = new CollapsibleEffect(d, m_currentEffectList.at(i), info, &m_effectMetaInfo, canMoveUp, i == effectsCount - 1, view);
+        CollapsibleEffect *currentEffect = nullptr;
+        const QList<CollapsibleEffect *> candidates = unusedEffects.values(d.attribute(QStringLiteral("id")));
+        for (CollapsibleEffect *candidate : candidates) {
+            if (candidate->rebind(d, m_currentEffectList.at(i), info, canMoveUp, i == effectsCount - 1)) {
+                unusedEffects.remove(d.attribute(QStringLiteral("id")), candidate);
+                currentEffect = candidate;
+                break;
+            }
+        }
+        bool newEffect = currentEffect == nullptr;
+        if (newEffect) {
+            currentEffect = new CollapsibleEffect(d, m_currentEffectList.at(i), info, &m_effectMetaInfo, canMoveUp, i == effectsCount - 1, view);
+        }
         isSelected = currentEffect->effectIndex() == activeEffectIndex();
         if (isSelected) {
             m_monitorSceneWanted = currentEffect->needsMonitorEffectScene();
@@ -417,7 +439,13 @@ void EffectStackView2::setupListView()
         } else {
             vbox1->addWidget(currentEffect);
         }
-        connectEffect(currentEffect);
+        if (newEffect) {
+            connectEffect(currentEffect);
+        }
+    }
+    for (CollapsibleEffect *effect : unusedEffects) {
+        effect->setHidden(true);
+        effect->deleteLater();
     }
 
     if (selectedCollapsibleEffect) {
@@ -442,6 +470,22 @@ void EffectStackView2::setupListView()
     m_scrollTimer.start();
 }
 
+bool EffectStackView2::canReuseEffectWidgets() const
+{
+    // Groups are rebuilt with their effects
+    if (!m_effect->container->widget()->findChildren<CollapsibleGroup *>().isEmpty()) {
+        return false;
+    }
+    for (int i = 0; i < m_currentEffectList.count(); ++i) {
+        EffectInfo effectInfo;
+        effectInfo.fromString(m_currentEffectList.at(i).attribute(QStringLiteral("kdenlive_info")));
+        if (effectInfo.groupIndex >= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
 int EffectStackView2::activeEffectIndex() const
 {
     int index = 0;
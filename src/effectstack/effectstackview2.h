@@ -145,6 +145,8 @@ private:
 
     /** @brief Sets the list of effects according to the clip's effect list. */
     void setupListView();
+    /** @brief Returns true if the current effect widgets can be rebound to the effects of m_currentEffectList instead of being rebuilt. */
+    bool canReuseEffectWidgets() const;
 
     /** @brief Build the drag info and start it. */
     void startDrag();
@@ -665,6 +665,7 @@ ParameterContainer::ParameterContainer(const QDomElement &effect, const ItemInfo
     for (int i = 0; i < allWidgets.count(); ++i) {
         allWidgets.at(i)->setSpinSize(minSize);
     }
+    m_bindingKey = bindingKey(effect);
 }
 
 ParameterContainer::~ParameterContainer()
@@ -1365,3 +1366,136 @@ bool ParameterContainer::doesAcceptDrops() const
     return m_acceptDrops;
 }
 
+QString ParameterContainer::bindingKey(const QDomElement &effect)
+{
+    // Conditional and custom widget effects change their layout with the parameter values
+    if (effect.hasAttribute(QStringLiteral("condition")) || effect.hasAttribute(QStringLiteral("sync_in_out"))) {
+        return QString();
+    }
+    const QString id = effect.attribute(QStringLiteral("id"));
+    const QString tag = effect.attribute(QStringLiteral("tag"));
+    if (id == QLatin1String("movit.lift_gamma_gain") || id == QLatin1String("lift_gamma_gain") || tag == QLatin1String("avfilter.selectivecolor")) {
+        return QString();
+    }
+    QStringList key;
+    key << tag << id;
+    QDomNodeList namenode = effect.childNodes();
+    for (int i = 0; i < namenode.count(); ++i) {
+        QDomElement pa = namenode.item(i).toElement();
+        if (pa.tagName() != QLatin1String("parameter")) {
+            continue;
+        }
+        const QString type = pa.attribute(QStringLiteral("type"));
+        if (type == QLatin1String("fixed")) {
+            continue;
+        }
+        // Only the simple value widgets, the keyframe table and fade positions can be updated in place.
+        // Animations, geometries, curves and roto splines keep clip bound state in their own widgets.
+        if (type != QLatin1String("double") && type != QLatin1String("constant") && type != QLatin1String("list") && type != QLatin1String("bool")
+                && type != QLatin1String("switch") && type != QLatin1String("color") && type != QLatin1String("keyframe")
+                && type != QLatin1String("simplekeyframe") && type != QLatin1String("position")) {
+            return QString();
+        }
+        // The corners editor is attached to the monitor scene
+        if (pa.attribute(QStringLiteral("widget")) == QLatin1String("corners")) {
+            return QString();
+        }
+        // Ranges relative to the frame size and luma lists depend on the clip
+        if (pa.attribute(QStringLiteral("min")).contains(QLatin1Char('%')) || pa.attribute(QStringLiteral("max")).contains(QLatin1Char('%'))
+                || pa.attribute(QStringLiteral("paramlist")) == QLatin1String("%lumaPaths")) {
+            return QString();
+        }
+        key << pa.attribute(QStringLiteral("name")) << type << pa.attribute(QStringLiteral("min")) << pa.attribute(QStringLiteral("max"))
+            << pa.attribute(QStringLiteral("default")) << pa.attribute(QStringLiteral("paramlist")) << pa.attribute(QStringLiteral("decimals"))
+            << pa.attribute(QStringLiteral("suffix")) << pa.attribute(QStringLiteral("paramprefix"));
+    }
+    return key.join(QLatin1Char('\n'));
+}
+
+bool ParameterContainer::rebind(const QDomElement &effect, const ItemInfo &info)
+{
+    if (m_bindingKey.isEmpty() || bindingKey(effect) != m_bindingKey) {
+        return false;
+    }
+    QLocale locale;
+    locale.setNumberOptions(QLocale::OmitGroupSeparator);
+    m_effect = effect;
+    m_info = info;
+    m_in = info.cropStart.frames(KdenliveSettings::project_fps());
+    m_out = (info.cropStart + info.cropDuration).frames(KdenliveSettings::project_fps()) - 1;
+    bool disable = effect.attribute(QStringLiteral("disable")) == QLatin1String("1") && KdenliveSettings::disable_effect_parameters();
+    m_vbox->parentWidget()->setEnabled(!disable);
+
+    QList<QDomElement> keyframeParams;
+    QDomNodeList namenode = effect.childNodes();
+    for (int i = 0; i < namenode.count(); ++i) {
+        QDomElement pa = namenode.item(i).toElement();
+        if (pa.tagName() != QLatin1String("parameter")) {
+            continue;
+        }
+        QString type = pa.attribute(QStringLiteral("type"));
+        QDomElement na = pa.firstChildElement(QStringLiteral("name"));
+        QString paramName = na.isNull() ? pa.attribute(QStringLiteral("name")) : i18n(na.text().toUtf8().data());
+        if (type == QLatin1String("keyframe") || type == QLatin1String("simplekeyframe")) {
+            keyframeParams << pa;
+            continue;
+        }
+        if (type == QLatin1String("position")) {
+            PositionWidget *posedit = static_cast<PositionWidget *>(m_valueItems.value(paramName + QStringLiteral("position")));
+            if (posedit) {
+                QString value = pa.attribute(QStringLiteral("value")).isNull() ?
+                                pa.attribute(QStringLiteral("default")) : pa.attribute(QStringLiteral("value"));
+                int pos = value.toInt();
+                const QString id = effect.attribute(QStringLiteral("id"));
+                if (id == QLatin1String("fadein") || id == QLatin1String("fade_from_black")) {
+                    pos = pos - m_in;
+                } else if (id == QLatin1String("fadeout") || id == QLatin1String("fade_to_black")) {
+                    // fadeout position starts from clip end
+                    pos = m_out - pos;
+                }
+                posedit->blockSignals(true);
+                posedit->setRange(0, m_out - m_in);
+                posedit->setPosition(pos);
+                posedit->blockSignals(false);
+            }
+            continue;
+        }
+        QWidget *widget = m_valueItems.value(paramName);
+        if (type == QLatin1String("fixed") || !widget) {
+            continue;
+        }
+        QString value = pa.attribute(QStringLiteral("value")).isNull() ?
+                        pa.attribute(QStringLiteral("default")) : pa.attribute(QStringLiteral("value"));
+        // The values are those of the effect, do not send them back as changes
+        widget->blockSignals(true);
+        if (type == QLatin1String("double") || type == QLatin1String("constant")) {
+            static_cast<DoubleParameterWidget *>(widget)->setValue(locale.toDouble(value));
+        } else if (type == QLatin1String("list")) {
+            QStringList listitems = pa.attribute(QStringLiteral("paramlist")).split(QLatin1Char(';'));
+            if (listitems.count() == 1) {
+                listitems = pa.attribute(QStringLiteral("paramlist")).split(QLatin1Char(','));
+            }
+            static_cast<ListParamWidget *>(widget)->setCurrentIndex(value.isEmpty() ? 0 : qMax(0, listitems.indexOf(value)));
+        } else if (type == QLatin1String("bool")) {
+            static_cast<BoolParamWidget *>(widget)->setValue(value == QLatin1String("1"));
+        } else if (type == QLatin1String("switch")) {
+            static_cast<BoolParamWidget *>(widget)->setValue(value == pa.attribute("min"));
+        } else if (type == QLatin1String("color")) {
+            if (pa.hasAttribute(QStringLiteral("paramprefix"))) {
+                value.remove(0, pa.attribute(QStringLiteral("paramprefix")).size());
+            }
+            if (value.startsWith('#')) {
+                value = value.replace('#', QLatin1String("0x"));
+            }
+            static_cast<ChooseColorWidget *>(widget)->setValue(value);
+        }
+        widget->blockSignals(false);
+    }
+    if (m_keyframeEditor && !keyframeParams.isEmpty()) {
+        m_keyframeEditor->blockSignals(true);
+        m_keyframeEditor->reload(keyframeParams, m_in, m_out, effect.attribute(QStringLiteral("active_keyframe"), QStringLiteral("-1")).toInt());
+        m_keyframeEditor->checkVisibleParam();
+        m_keyframeEditor->blockSignals(false);
+    }
+    return true;
+}
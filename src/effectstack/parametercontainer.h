@@ -98,6 +98,9 @@ public:
     /** @brief The effect was selected / deselected, so we have to update monitor connections. */
     void connectMonitor(bool activate);
     bool doesAcceptDrops() const;
+    /** @brief Show the values of another instance of the same effect in the existing widgets.
+     *  @return false if the widgets cannot be reused for effect, the container then has to be rebuilt */
+    bool rebind(const QDomElement &effect, const ItemInfo &info);
 
 private slots:
     void slotCollectAllParameters();
@@ -117,6 +120,8 @@ private:
     QString getWipeString(wipeInfo info);
     /** @brief Delete all child widgets */
     void clearLayout(QLayout *layout);
+    /** @brief Returns the description of the widgets built for effect, empty if they cannot be rebound to another instance. */
+    static QString bindingKey(const QDomElement &effect);
     int m_in;
     int m_out;
     ItemInfo m_info;
@@ -132,6 +137,7 @@ private:
     bool m_acceptDrops;
     MonitorSceneType m_monitorEffectScene;
     bool m_conditionParameter;
+    QString m_bindingKey;
 
 signals:
     void parameterChanged(const QDomElement &, const QDomElement &, int);
@@ -55,3 +55,10 @@ bool BoolParamWidget::getValue()
 {
     return m_checkBox->isChecked();
 }
+
+void BoolParamWidget::setValue(bool checked)
+{
+    m_checkBox->blockSignals(true);
+    m_checkBox->setChecked(checked);
+    m_checkBox->blockSignals(false);
+}
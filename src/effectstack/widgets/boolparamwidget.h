@@ -48,6 +48,11 @@ public:
      */
     bool getValue();
 
+    /** @brief Set the state of the checkbox without emitting valueChanged
+        @param checked Boolean indicating wether the checkbox should be checked
+    */
+    void setValue(bool checked);
+
 public slots:
     /** @brief Toggle the comments on or off    */
     void slotShowComment(bool);
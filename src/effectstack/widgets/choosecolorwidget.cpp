@@ -129,6 +129,13 @@ QString ChooseColorWidget::getColor() const
     return colorToString(m_button->color(), alphaChannel);
 }
 
+void ChooseColorWidget::setValue(const QString &color)
+{
+    m_button->blockSignals(true);
+    m_button->setColor(stringToColor(color));
+    m_button->blockSignals(false);
+}
+
 void ChooseColorWidget::setColor(const QColor &color)
 {
     m_button->setColor(color);
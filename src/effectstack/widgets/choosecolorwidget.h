@@ -47,6 +47,8 @@ public:
 
     /** @brief Gets the chosen color. */
     QString getColor() const;
+    /** @brief Sets the color from its parameter value, without emitting modified. */
+    void setValue(const QString &color);
 
 private:
     KColorButton *m_button;
@@ -585,6 +585,30 @@ void KeyframeEdit::checkVisibleParam()
     slotUpdateVisibleParameter(0);
 }
 
+void KeyframeEdit::reload(const QList<QDomElement> &params, int minFrame, int maxFrame, int activeKeyframe)
+{
+    keyframe_list->blockSignals(true);
+    keyframe_list->setRowCount(0);
+    keyframe_list->setColumnCount(0);
+    keyframe_list->blockSignals(false);
+    QLayoutItem *child;
+    while ((child = m_slidersLayout->takeAt(0)) != nullptr) {
+        QWidget *wid = child->widget();
+        delete child;
+        delete wid;
+    }
+    m_params.clear();
+    m_min = minFrame;
+    m_max = maxFrame;
+    for (const QDomElement &e : params) {
+        addParameter(e, activeKeyframe);
+    }
+    // Same table visibility as a newly created editor
+    bool singleKeyframe = keyframe_list->rowCount() < 2 && getPos(0) == m_min && m_max != -1;
+    widgetTable->setHidden(m_max == -1 || singleKeyframe);
+    buttonKeyframes->setHidden(!singleKeyframe);
+}
+
 void KeyframeEdit::slotUpdateRange(int inPoint, int outPoint)
 {
     m_min = inPoint;
@@ -99,6 +99,9 @@ public:
     /** @brief Makes the first parameter visible in timeline if no parameter is selected. */
     void checkVisibleParam();
 
+    /** @brief Replace the keyframes and range with those of another instance of the same effect (same parameters, in the same order). */
+    void reload(const QList<QDomElement> &params, int minFrame, int maxFrame, int activeKeyframe);
+
     /** @brief Returns attribute name for returned keyframes. */
     const QString getTag() const;
 
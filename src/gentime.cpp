@@ -17,39 +17,12 @@
 
 #include "gentime.h"
 
-double GenTime::s_delta = 0.00001;
-
-GenTime::GenTime()
-{
-    m_time = 0.0;
-}
-
-GenTime::GenTime(double seconds)
-{
-    m_time = seconds;
-}
-
-GenTime::GenTime(int frames, double framesPerSecond)
-{
-    m_time = (double) frames / framesPerSecond;
-}
-
-double GenTime::seconds() const
-{
-    return m_time;
-}
-
-double GenTime::ms() const
-{
-    return m_time * 1000;
-}
-
 double GenTime::frames(double framesPerSecond) const
 {
-    return floor(m_time * framesPerSecond + 0.5);
+    return floor(m_ticks * framesPerSecond / timebase() + 0.5);
 }
 
 QString GenTime::toString() const
 {
-    return QStringLiteral("%1 s").arg(m_time, 0, 'f', 2);
+    return QStringLiteral("%1 s").arg(seconds(), 0, 'f', 2);
 }
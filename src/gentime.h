@@ -24,26 +24,55 @@
 /**
  * @class GenTime
  * @brief Encapsulates a time, which can be set in various forms and outputted in various forms.
+ *
+ * The time is stored as an integer number of ticks of a 120000 Hz timebase, which is
+ * a multiple of the frame duration of all the usual frame rates, including the
+ * NTSC ones (23.976, 29.97 and 59.94 fps are 5005, 4004 and 2002 ticks per frame).
+ * Frame positions are therefore represented exactly and comparisons are integer ones.
  * @author Jason Wood
  */
 
 class GenTime
 {
 public:
+    /** @brief Number of ticks per second */
+    static constexpr qint64 timebase()
+    {
+        return 120000;
+    }
+
     /** @brief Creates a GenTime object, with a time of 0 seconds. */
-    GenTime();
+    constexpr GenTime() : m_ticks(0) {}
 
     /** @brief Creates a GenTime object, with time given in seconds. */
-    explicit GenTime(double seconds);
+    constexpr explicit GenTime(double seconds) : m_ticks(roundTicks(seconds * timebase())) {}
 
     /** @brief Creates a GenTime object, by passing number of frames and how many frames per second. */
-    GenTime(int frames, double framesPerSecond);
+    constexpr GenTime(int frames, double framesPerSecond) : m_ticks(roundTicks(frames * (timebase() / framesPerSecond))) {}
+
+    /** @brief Creates a GenTime object from a number of ticks of the timebase. */
+    static constexpr GenTime fromTicks(qint64 ticks)
+    {
+        return GenTime(ticks, TicksTag());
+    }
+
+    /** @brief Gets the time, in ticks of the timebase. */
+    constexpr qint64 ticks() const
+    {
+        return m_ticks;
+    }
 
     /** @brief Gets the time, in seconds. */
-    double seconds() const;
+    constexpr double seconds() const
+    {
+        return (double) m_ticks / timebase();
+    }
 
     /** @brief Gets the time, in milliseconds */
-    double ms() const;
+    constexpr double ms() const
+    {
+        return m_ticks * 1000.0 / timebase();
+    }
 
     /** @brief Gets the time in frames.
     * @param framesPerSecond Number of frames per second */
@@ -56,85 +85,91 @@ public:
      */
 
     /// Unary minus
-    GenTime operator -()
+    constexpr GenTime operator -() const
     {
-        return GenTime(-m_time);
+        return fromTicks(-m_ticks);
     }
 
     /// Addition
     GenTime &operator+=(GenTime op)
     {
-        m_time += op.m_time;
+        m_ticks += op.m_ticks;
         return *this;
     }
 
     /// Subtraction
     GenTime &operator-=(GenTime op)
     {
-        m_time -= op.m_time;
+        m_ticks -= op.m_ticks;
         return *this;
     }
 
     /** @brief Adds two GenTimes. */
-    GenTime operator+(GenTime op) const
+    constexpr GenTime operator+(GenTime op) const
     {
-        return GenTime(m_time + op.m_time);
+        return fromTicks(m_ticks + op.m_ticks);
     }
 
     /** @brief Subtracts one genTime from another. */
-    GenTime operator-(GenTime op) const
+    constexpr GenTime operator-(GenTime op) const
     {
-        return GenTime(m_time - op.m_time);
+        return fromTicks(m_ticks - op.m_ticks);
     }
 
     /** @brief Multiplies one GenTime by a double value, returning a GenTime. */
-    GenTime operator*(double op) const
+    constexpr GenTime operator*(double op) const
     {
-        return GenTime(m_time * op);
+        return fromTicks(roundTicks(m_ticks * op));
     }
 
     /** @brief Divides one GenTime by a double value, returning a GenTime. */
-    GenTime operator/(double op) const
+    constexpr GenTime operator/(double op) const
     {
-        return GenTime(m_time / op);
+        return fromTicks(roundTicks(m_ticks / op));
     }
 
-    bool operator<(GenTime op) const
+    constexpr bool operator<(GenTime op) const
     {
-        return m_time + s_delta < op.m_time;
+        return m_ticks < op.m_ticks;
     }
 
-    bool operator>(GenTime op) const
+    constexpr bool operator>(GenTime op) const
     {
-        return m_time > op.m_time + s_delta;
+        return m_ticks > op.m_ticks;
     }
 
-    bool operator>=(GenTime op) const
+    constexpr bool operator>=(GenTime op) const
     {
-        return m_time + s_delta >= op.m_time;
+        return m_ticks >= op.m_ticks;
     }
 
-    bool operator<=(GenTime op) const
+    constexpr bool operator<=(GenTime op) const
     {
-        return m_time <= op.m_time + s_delta;
+        return m_ticks <= op.m_ticks;
     }
 
-    bool operator==(GenTime op) const
+    constexpr bool operator==(GenTime op) const
     {
-        return fabs(m_time - op.m_time) < s_delta;
+        return m_ticks == op.m_ticks;
     }
 
-    bool operator!=(GenTime op) const
+    constexpr bool operator!=(GenTime op) const
     {
-        return fabs(m_time - op.m_time) >= s_delta;
+        return m_ticks != op.m_ticks;
     }
 
 private:
-    /** Holds the time in seconds for this object. */
-    double m_time;
+    struct TicksTag {};
+    constexpr GenTime(qint64 ticks, TicksTag) : m_ticks(ticks) {}
+
+    /** @brief Rounds a number of ticks to the nearest integer, halves away from zero */
+    static constexpr qint64 roundTicks(double ticks)
+    {
+        return ticks < 0 ? -(qint64)(0.5 - ticks) : (qint64)(ticks + 0.5);
+    }
 
-    /** A delta value that is used to get around floating point rounding issues. */
-    static double s_delta;
+    /** Holds the time in ticks of the timebase for this object. */
+    qint64 m_ticks;
 };
 
 #endif
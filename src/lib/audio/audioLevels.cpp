@@ -0,0 +1,208 @@
+/*
+Copyright (C) 2026  agent <agent@local>
+This file is part of kdenlive. See www.kdenlive.org.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+*/
+
+#include "audioLevels.h"
+
+#include "kdenlive_debug.h"
+#include <QFile>
+#include <QSaveFile>
+#include <cstring>
+
+namespace
+{
+// Peak file layout: header followed by all levels, channel after channel
+const char peakMagic[8] = {'K', 'D', 'E', 'N', 'P', 'E', 'A', 'K'};
+const quint32 peakVersion = 1;
+struct PeakHeader {
+    char magic[8];
+    quint32 version;
+    quint32 channels;
+    quint32 frames;
+    quint32 levels;
+};
+}
+
+/**
+  Owns the memory behind AudioLevels, either a heap buffer or a mapped peak file.
+  */
+class AudioLevelsStorage
+{
+public:
+    QByteArray buffer;
+    QFile file;
+    uchar *map = nullptr;
+    ~AudioLevelsStorage()
+    {
+        if (map) {
+            file.unmap(map);
+        }
+    }
+};
+
+AudioLevels::AudioLevels() :
+    m_channels(0)
+    , m_data(nullptr)
+{
+}
+
+AudioLevels::AudioLevels(int channels, int frames) :
+    m_channels(qMax(0, channels))
+    , m_storage(new AudioLevelsStorage)
+{
+    int size = setupLevels(qMax(0, frames), 1);
+    m_storage->buffer.fill(0, size);
+    m_data = reinterpret_cast<const quint8 *>(m_storage->buffer.constData());
+}
+
+int AudioLevels::setupLevels(int frames, int levelCount)
+{
+    m_frameCounts.clear();
+    m_offsets.clear();
+    int offset = 0;
+    for (int i = 0; i < levelCount; ++i) {
+        m_frameCounts << frames;
+        m_offsets << offset;
+        offset += m_channels * frames;
+        frames = (frames + 1) / 2;
+    }
+    return offset;
+}
+
+bool AudioLevels::isEmpty() const
+{
+    return m_channels == 0 || m_frameCounts.isEmpty() || m_frameCounts.at(0) == 0;
+}
+
+int AudioLevels::channels() const
+{
+    return m_channels;
+}
+
+int AudioLevels::frames() const
+{
+    return m_frameCounts.isEmpty() ? 0 : m_frameCounts.at(0);
+}
+
+void AudioLevels::clear()
+{
+    m_channels = 0;
+    m_frameCounts.clear();
+    m_offsets.clear();
+    m_storage.clear();
+    m_data = nullptr;
+}
+
+void AudioLevels::setLevel(int frame, int channel, int value)
+{
+    quint8 *data = reinterpret_cast<quint8 *>(m_storage->buffer.data());
+    data[channel * m_frameCounts.at(0) + frame] = (quint8) qBound(0, value, 255);
+}
+
+const quint8 *AudioLevels::channelData(int channel) const
+{
+    return m_data + channel * m_frameCounts.at(0);
+}
+
+void AudioLevels::buildPyramid()
+{
+    if (isEmpty()) {
+        return;
+    }
+    int frames = m_frameCounts.at(0);
+    int levelCount = 1;
+    for (int count = frames; count > 1; count = (count + 1) / 2) {
+        levelCount++;
+    }
+    QSharedPointer<AudioLevelsStorage> storage(new AudioLevelsStorage);
+    storage->buffer.resize(setupLevels(frames, levelCount));
+    quint8 *data = reinterpret_cast<quint8 *>(storage->buffer.data());
+    memcpy(data, m_data, (size_t)(m_channels * frames));
+    for (int level = 1; level < levelCount; ++level) {
+        int sourceFrames = m_frameCounts.at(level - 1);
+        int reduced = m_frameCounts.at(level);
+        for (int channel = 0; channel < m_channels; ++channel) {
+            const quint8 *src = data + m_offsets.at(level - 1) + channel * sourceFrames;
+            quint8 *dest = data + m_offsets.at(level) + channel * reduced;
+            for (int i = 0; i < sourceFrames / 2; ++i) {
+                dest[i] = qMax(src[2 * i], src[2 * i + 1]);
+            }
+            if (sourceFrames % 2) {
+                dest[reduced - 1] = src[sourceFrames - 1];
+            }
+        }
+    }
+    m_storage = storage;
+    m_data = data;
+}
+
+int AudioLevels::pyramidLevels() const
+{
+    return m_frameCounts.count();
+}
+
+int AudioLevels::pyramidLevel(double framesPerPixel) const
+{
+    int level = 0;
+    while (level + 1 < m_frameCounts.count() && (1 << (level + 1)) <= framesPerPixel) {
+        level++;
+    }
+    return level;
+}
+
+bool AudioLevels::save(const QString &path) const
+{
+    if (isEmpty()) {
+        return false;
+    }
+    PeakHeader header;
+    memcpy(header.magic, peakMagic, sizeof(peakMagic));
+    header.version = peakVersion;
+    header.channels = (quint32) m_channels;
+    header.frames = (quint32) m_frameCounts.at(0);
+    header.levels = (quint32) m_frameCounts.count();
+    int size = m_offsets.last() + m_channels * m_frameCounts.last();
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCDebug(KDENLIVE_LOG) << "Cannot write audio peak file" << path;
+        return false;
+    }
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(m_data), size);
+    return file.commit();
+}
+
+AudioLevels AudioLevels::load(const QString &path)
+{
+    AudioLevels levels;
+    QSharedPointer<AudioLevelsStorage> storage(new AudioLevelsStorage);
+    storage->file.setFileName(path);
+    if (!storage->file.open(QIODevice::ReadOnly) || storage->file.size() < (qint64) sizeof(PeakHeader)) {
+        return levels;
+    }
+    PeakHeader header;
+    if (storage->file.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header) || memcmp(header.magic, peakMagic, sizeof(peakMagic)) != 0 || header.version != peakVersion || header.channels == 0 || header.channels > 64 || header.frames == 0 || header.levels == 0 || header.levels > 32) {
+        return levels;
+    }
+    levels.m_channels = (int) header.channels;
+    int size = levels.setupLevels((int) header.frames, (int) header.levels);
+    if (storage->file.size() != (qint64) sizeof(header) + size) {
+        qCDebug(KDENLIVE_LOG) << "Invalid audio peak file" << path;
+        return AudioLevels();
+    }
+    storage->map = storage->file.map(sizeof(header), size);
+    if (!storage->map) {
+        return AudioLevels();
+    }
+    // The mapping stays valid after closing the file
+    storage->file.close();
+    levels.m_storage = storage;
+    levels.m_data = storage->map;
+    return levels;
+}
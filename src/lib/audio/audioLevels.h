@@ -0,0 +1,96 @@
+/*
+Copyright (C) 2026  agent <agent@local>
+This file is part of kdenlive. See www.kdenlive.org.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+*/
+
+#ifndef AUDIOLEVELS_H
+#define AUDIOLEVELS_H
+
+#include <QVector>
+#include <QString>
+#include <QSharedPointer>
+#include <QtGlobal>
+
+class AudioLevelsStorage;
+
+/**
+  Per frame audio levels of a clip, used to draw audio thumbnails.
+  Levels are stored as one contiguous 8 bit array per channel (0 - 255).
+  The data is shared, so copies are cheap and can be passed around between
+  the bin, timeline and monitor. Levels should only be modified (setLevel,
+  buildPyramid) while building them, before any copy is made.
+  Once buildPyramid() was called, reduced levels (each one keeping the
+  peaks of 2 values of the previous one) are available, so that zoomed
+  out views read one value per pixel whatever the clip length.
+
+  Levels can be saved to a peak file (a small header followed by the
+  levels exactly as they are stored in memory) and loaded back by memory
+  mapping that file, so no decoding is needed.
+  */
+class AudioLevels
+{
+public:
+    AudioLevels();
+    AudioLevels(int channels, int frames);
+
+    bool isEmpty() const;
+    int channels() const;
+    int frames() const;
+    void clear();
+
+    /** @brief Returns the level of @param channel at @param frame, frame is bounded to the available range.
+     *  @param pyramidLevel the reduction level to read from, frame is always expressed in full resolution frames */
+    inline int level(int frame, int channel, int pyramidLevel = 0) const
+    {
+        const int frames = m_frameCounts.at(pyramidLevel);
+        return m_data[m_offsets.at(pyramidLevel) + channel * frames + qBound(0, frame >> pyramidLevel, frames - 1)];
+    }
+    /** @brief Returns the highest level of all channels at @param frame. */
+    inline int maxLevel(int frame, int pyramidLevel = 0) const
+    {
+        const int frames = m_frameCounts.at(pyramidLevel);
+        frame = qBound(0, frame >> pyramidLevel, frames - 1);
+        const quint8 *data = m_data + m_offsets.at(pyramidLevel);
+        quint8 value = data[frame];
+        for (int channel = 1; channel < m_channels; ++channel) {
+            value = qMax(value, data[channel * frames + frame]);
+        }
+        return value;
+    }
+    /** @brief Sets the level of @param channel at @param frame, value is clamped to 0 - 255. */
+    void setLevel(int frame, int channel, int value);
+    /** @brief Returns the raw levels of @param channel (frames() values). */
+    const quint8 *channelData(int channel) const;
+
+    /** @brief Compute the reduced levels from the full resolution ones. */
+    void buildPyramid();
+    /** @brief Returns the number of available levels (1 if the pyramid was not built). */
+    int pyramidLevels() const;
+    /** @brief Returns the most reduced level that still has at least one value every @param framesPerPixel frames. */
+    int pyramidLevel(double framesPerPixel) const;
+
+    /** @brief Write levels to a peak file, returns false on failure. */
+    bool save(const QString &path) const;
+    /** @brief Map a peak file created by save(), returns empty levels if the file is missing or invalid. */
+    static AudioLevels load(const QString &path);
+
+private:
+    int m_channels;
+    /** @brief Number of values per channel for each level. */
+    QVector<int> m_frameCounts;
+    /** @brief Position of each level in m_data, channels are stored one after another. */
+    QVector<int> m_offsets;
+    QSharedPointer<AudioLevelsStorage> m_storage;
+    const quint8 *m_data;
+    /** @brief Compute level sizes and positions for @param frames values per channel. */
+    int setupLevels(int frames, int levelCount);
+};
+
+Q_DECLARE_TYPEINFO(AudioLevels, Q_MOVABLE_TYPE);
+
+#endif // AUDIOLEVELS_H
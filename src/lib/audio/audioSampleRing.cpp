@@ -0,0 +1,119 @@
+/*
+Copyright (C) 2026  agent <agent@local>
+This file is part of kdenlive. See www.kdenlive.org.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+*/
+
+#include "audioSampleRing.h"
+
+#include <string.h>
+
+AudioSampleRing::Reader::Reader()
+    : m_block(0)
+    , m_overruns(0)
+{
+}
+
+quint64 AudioSampleRing::Reader::overruns() const
+{
+    return m_overruns;
+}
+
+AudioSampleRing::AudioSampleRing(int capacity, int blocks)
+    : m_samples(capacity, 0)
+    , m_blocks(blocks)
+    , m_mask(capacity - 1)
+    , m_published(0)
+    , m_writing(0)
+    , m_reserved(0)
+{
+    Q_ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+    Q_ASSERT(blocks > 1);
+}
+
+void AudioSampleRing::write(const qint16 *data, int samples, int channels, int freq)
+{
+    const int count = samples * channels;
+    if (!data || count <= 0 || count > m_samples.size()) {
+        return;
+    }
+    // Only this thread modifies the counters, relaxed loads are enough
+    const quint64 block = m_published.load(std::memory_order_relaxed);
+    const quint64 start = m_reserved.load(std::memory_order_relaxed);
+    // Announce what we are about to overwrite before touching the data
+    m_writing.store(block + 1, std::memory_order_relaxed);
+    m_reserved.store(start + count, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    qint16 *storage = m_samples.data();
+    const int offset = start & m_mask;
+    const int firstPart = qMin(count, m_samples.size() - offset);
+    memcpy(storage + offset, data, firstPart * sizeof(qint16));
+    if (firstPart < count) {
+        memcpy(storage, data + firstPart, (count - firstPart) * sizeof(qint16));
+    }
+    Block &info = m_blocks[block % m_blocks.size()];
+    info.start = start;
+    info.count = count;
+    info.channels = channels;
+    info.freq = freq;
+    m_published.store(block + 1, std::memory_order_release);
+}
+
+quint64 AudioSampleRing::written() const
+{
+    return m_published.load(std::memory_order_acquire);
+}
+
+void AudioSampleRing::attach(Reader &reader) const
+{
+    reader.m_block = m_published.load(std::memory_order_acquire);
+}
+
+int AudioSampleRing::readLatest(Reader &reader, audioShortVector &data, int &freq, int &channels, int &samples) const
+{
+    const quint64 blockCount = m_blocks.size();
+    const quint64 capacity = m_samples.size();
+    // Retry a few times if the writer overwrote the block while we were copying it
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        const quint64 published = m_published.load(std::memory_order_acquire);
+        if (published == reader.m_block) {
+            return 0;
+        }
+        const quint64 block = published - 1;
+        const Block info = m_blocks.at(block % blockCount);
+        if (info.count <= 0 || (quint64) info.count > capacity || info.channels <= 0) {
+            reader.m_overruns++;
+            continue;
+        }
+        // The reader's own buffer only reallocates when the frame size changes
+        data.resize(info.count);
+        const int offset = info.start & m_mask;
+        const int firstPart = qMin(info.count, (int) capacity - offset);
+        memcpy(data.data(), m_samples.constData() + offset, firstPart * sizeof(qint16));
+        if (firstPart < info.count) {
+            memcpy(data.data() + firstPart, m_samples.constData(), (info.count - firstPart) * sizeof(qint16));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // Check that the writer did not start reusing the block info or the samples we read
+        if (m_writing.load(std::memory_order_relaxed) > block + blockCount || m_reserved.load(std::memory_order_relaxed) - info.start > capacity) {
+            reader.m_overruns++;
+            continue;
+        }
+        const quint64 newBlocks = published - reader.m_block;
+        if (newBlocks > blockCount) {
+            // Blocks were overwritten before we got a chance to see them
+            reader.m_overruns += newBlocks - blockCount;
+        }
+        reader.m_block = published;
+        freq = info.freq;
+        channels = info.channels;
+        samples = info.count / info.channels;
+        return (int) qMin(newBlocks, blockCount);
+    }
+    return 0;
+}
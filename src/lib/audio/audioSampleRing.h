@@ -0,0 +1,80 @@
+/*
+Copyright (C) 2026  agent <agent@local>
+This file is part of kdenlive. See www.kdenlive.org.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+*/
+
+#ifndef AUDIOSAMPLERING_H
+#define AUDIOSAMPLERING_H
+
+#include "definitions.h"
+
+#include <QVector>
+#include <atomic>
+
+/**
+  Ring buffer holding the audio of the last played frames, written by the
+  playback thread and read by the audio scopes.
+
+  There is a single writer, which never allocates nor locks: it copies the
+  interleaved samples of a frame into preallocated storage and publishes
+  the frame (a block) with an atomic counter.
+  Any number of readers can read concurrently, each one with its own Reader
+  cursor. A reader that copies a block while the writer overwrites it detects
+  it afterwards and retries with the latest block; such lost reads and the
+  blocks that were overwritten before being read are counted as overruns.
+  */
+class AudioSampleRing
+{
+public:
+    /** @brief Read position of one consumer */
+    class Reader
+    {
+    public:
+        Reader();
+        /** @brief Number of blocks this reader lost because the writer was faster */
+        quint64 overruns() const;
+
+    private:
+        friend class AudioSampleRing;
+        quint64 m_block;
+        quint64 m_overruns;
+    };
+
+    /** @param capacity Number of samples (all channels) kept, must be a power of 2
+     *  @param blocks Number of frames kept */
+    explicit AudioSampleRing(int capacity = 1 << 17, int blocks = 32);
+
+    /** @brief Append the interleaved samples of one frame. Only one thread may write. */
+    void write(const qint16 *data, int samples, int channels, int freq);
+    /** @brief Number of frames written so far */
+    quint64 written() const;
+
+    /** @brief Move reader to the current end, so that it only reads frames written from now on */
+    void attach(Reader &reader) const;
+    /** @brief Copy the newest frame if reader has not seen it yet
+     *  @return the number of frames written since the last read, 0 if there is nothing new */
+    int readLatest(Reader &reader, audioShortVector &data, int &freq, int &channels, int &samples) const;
+
+private:
+    struct Block {
+        quint64 start;
+        int count;
+        int channels;
+        int freq;
+    };
+    QVector<qint16> m_samples;
+    QVector<Block> m_blocks;
+    const quint64 m_mask;
+    /** @brief Number of published blocks */
+    std::atomic<quint64> m_published;
+    /** @brief Block (plus one) and sample position the writer is currently writing up to */
+    std::atomic<quint64> m_writing;
+    std::atomic<quint64> m_reserved;
+};
+
+#endif
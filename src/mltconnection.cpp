@@ -138,3 +138,8 @@ std::unique_ptr<Mlt::Repository>& MltConnection::getMltRepository()
 {
     return m_repository;
 }
+
+QMutex *MltConnection::getMltRepositoryMutex()
+{
+    return &m_repositoryMutex;
+}
@@ -12,6 +12,7 @@ the Free Software Foundation, either version 3 of the License, or
 #define MLTCONNECTION_H
 
 #include <memory>
+#include <QMutex>
 #include <QString>
 
 namespace Mlt {
@@ -35,6 +36,8 @@ public:
 
     /* @brief Returns a pointer to the MLT Repository*/
     std::unique_ptr<Mlt::Repository>& getMltRepository();
+    /** @brief Lock to hold while querying the repository metadata, which MLT loads on demand without synchronization */
+    QMutex *getMltRepositoryMutex();
 
 protected:
 
@@ -50,6 +53,7 @@ protected:
 
     /** @brief The MLT repository, useful for filter/producer requests */
     std::unique_ptr<Mlt::Repository> m_repository;
+    QMutex m_repositoryMutex;
 
 };
 
@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "effectscontroller.h"
+#include "effectslist/effectparameters.h"
 #include "dialogs/profilesdialog.h"
 #include "effectstack/widgets/animationwidget.h"
 
@@ -156,8 +157,6 @@ EffectsParameterList EffectsController::getEffectArgs(const ProfileInfo &info, c
 
 void EffectsController::adjustEffectParameters(EffectsParameterList &parameters, const QDomNodeList &params, const ProfileInfo &info, const QString &prefix)
 {
-    QLocale locale;
-    locale.setNumberOptions(QLocale::OmitGroupSeparator);
     for (int i = 0; i < params.count(); ++i) {
         QDomElement e = params.item(i).toElement();
         QString paramname = prefix + e.attribute(QStringLiteral("name"));
@@ -170,12 +169,11 @@ void EffectsController::adjustEffectParameters(EffectsParameterList &parameters,
             parameters.addParam(paramname, e.attribute(QStringLiteral("value")));
         } else if (e.attribute(QStringLiteral("type")) == QLatin1String("simplekeyframe")) {
             QStringList values = e.attribute(QStringLiteral("keyframes")).split(QLatin1Char(';'), QString::SkipEmptyParts);
-            double factor = e.attribute(QStringLiteral("factor"), QStringLiteral("1")).toDouble();
-            double offset = e.attribute(QStringLiteral("offset"), QStringLiteral("0")).toDouble();
+            double factor = EffectParameters::parseNumber(e.attribute(QStringLiteral("factor"), QStringLiteral("1")));
+            double offset = EffectParameters::parseNumber(e.attribute(QStringLiteral("offset"), QStringLiteral("0")));
             for (int j = 0; j < values.count(); ++j) {
                 QString pos = values.at(j).section(QLatin1Char('='), 0, 0);
-                double val = (values.at(j).section(QLatin1Char('='), 1, 1).toDouble() - offset) / factor;
-                values[j] = pos + QLatin1Char('=') + locale.toString(val);
+                values[j] = pos + QLatin1Char('=') + EffectParameters::mltValue(values.at(j).section(QLatin1Char('='), 1, 1), factor, offset);
             }
             // //qCDebug(KDENLIVE_LOG) << "/ / / /SENDING KEYFR:" << values;
             parameters.addParam(paramname, values.join(QLatin1Char(';')));
@@ -213,10 +211,10 @@ void EffectsController::adjustEffectParameters(EffectsParameterList &parameters,
                 if (e.attribute(QStringLiteral("factor")).contains(QLatin1Char('%'))) {
                     fact = getStringEval(info, e.attribute(QStringLiteral("factor")));
                 } else {
-                    fact = locale.toDouble(e.attribute(QStringLiteral("factor"), QStringLiteral("1")));
+                    fact = EffectParameters::parseNumber(e.attribute(QStringLiteral("factor"), QStringLiteral("1")));
                 }
-                double offset = e.attribute(QStringLiteral("offset"), QStringLiteral("0")).toDouble();
-                parameters.addParam(paramname, locale.toString((locale.toDouble(e.attribute(QStringLiteral("value"))) - offset) / fact));
+                double offset = EffectParameters::parseNumber(e.attribute(QStringLiteral("offset"), QStringLiteral("0")));
+                parameters.addParam(paramname, EffectParameters::mltValue(e.attribute(QStringLiteral("value")), fact, offset));
             } else {
                 parameters.addParam(paramname, e.attribute(QStringLiteral("value")));
             }
@@ -30,10 +30,23 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "timeline/clip.h"
 
 #include <QtConcurrent>
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+static const quint32 probeCacheMagic = 0x4b505242;
+static const qint32 probeCacheVersion = 1;
 
 ProducerQueue::ProducerQueue(BinController *controller) : QObject(controller)
+    , m_infoWorkers(0)
     , m_binController(controller)
 {
+    // Probing is mostly spent waiting on file access, so use all cores even on slow storage
+    m_infoPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+    QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cachePath.isEmpty() && QDir(cachePath).mkpath(QStringLiteral("probe"))) {
+        m_probeCachePath = cachePath + QStringLiteral("/probe/");
+    }
     connect(this, SIGNAL(multiStreamFound(QString, QList<int>, QList<int>, stringMap)), this, SLOT(slotMultiStreamProducerFound(QString, QList<int>, QList<int>, stringMap)));
     connect(this, &ProducerQueue::refreshTimelineProducer, m_binController, &BinController::replaceTimelineProducer);
 }
@@ -65,8 +78,15 @@ void ProducerQueue::getFileProperties(const QDomElement &xml, const QString &cli
     info.replaceProducer = replaceProducer;
     m_requestList.append(info);
     m_infoMutex.unlock();
-    if (!m_infoThread.isRunning()) {
-        m_infoThread = QtConcurrent::run(this, &ProducerQueue::processFileProperties);
+    startWorkers();
+}
+
+void ProducerQueue::startWorkers()
+{
+    QMutexLocker lock(&m_infoMutex);
+    while (m_infoWorkers < m_infoPool.maxThreadCount() && m_infoWorkers < m_requestList.count()) {
+        m_infoWorkers++;
+        QtConcurrent::run(&m_infoPool, this, &ProducerQueue::processFileProperties);
     }
 }
 
@@ -74,15 +94,15 @@ void ProducerQueue::forceProcessing(const QString &id)
 {
     // Make sure we load the clip producer now so that we can use it in timeline
     QList<requestClipInfo> requestListCopy;
+    m_infoMutex.lock();
     if (m_processingClipId.contains(id)) {
-        m_infoMutex.lock();
         requestListCopy = m_requestList;
         m_requestList.clear();
         m_infoMutex.unlock();
-        m_infoThread.waitForFinished();
+        m_infoPool.waitForDone();
+        registerProducers();
         emit infoProcessingFinished();
     } else {
-        m_infoMutex.lock();
         for (int i = 0; i < m_requestList.count(); ++i) {
             requestClipInfo info = m_requestList.at(i);
             if (info.clipId == id) {
@@ -94,19 +114,16 @@ void ProducerQueue::forceProcessing(const QString &id)
             }
         }
         m_infoMutex.unlock();
-        if (!m_infoThread.isRunning()) {
-            m_infoThread = QtConcurrent::run(this, &ProducerQueue::processFileProperties);
-        }
-        m_infoThread.waitForFinished();
+        startWorkers();
+        m_infoPool.waitForDone();
+        registerProducers();
         emit infoProcessingFinished();
     }
 
     m_infoMutex.lock();
     m_requestList.append(requestListCopy);
     m_infoMutex.unlock();
-    if (!m_infoThread.isRunning()) {
-        m_infoThread = QtConcurrent::run(this, &ProducerQueue::processFileProperties);
-    }
+    startWorkers();
 }
 
 void ProducerQueue::slotProcessingDone(const QString &id)
@@ -117,10 +134,10 @@ void ProducerQueue::slotProcessingDone(const QString &id)
 
 bool ProducerQueue::isProcessing(const QString &id)
 {
+    QMutexLocker lock(&m_infoMutex);
     if (m_processingClipId.contains(id)) {
         return true;
     }
-    QMutexLocker lock(&m_infoMutex);
     for (int i = 0; i < m_requestList.count(); ++i) {
         if (m_requestList.at(i).clipId == id) {
             return true;
@@ -135,8 +152,13 @@ void ProducerQueue::processFileProperties()
     QLocale locale;
     locale.setNumberOptions(QLocale::OmitGroupSeparator);
     bool forceThumbScale = m_binController->profile()->sar() != 1;
-    while (!m_requestList.isEmpty()) {
+    while (true) {
         m_infoMutex.lock();
+        if (m_requestList.isEmpty()) {
+            m_infoWorkers--;
+            m_infoMutex.unlock();
+            return;
+        }
         info = m_requestList.takeFirst();
         if (info.xml.hasAttribute(QStringLiteral("thumbnailOnly")) || info.xml.hasAttribute(QStringLiteral("refreshOnly"))) {
             m_infoMutex.unlock();
@@ -209,6 +231,10 @@ void ProducerQueue::processFileProperties()
         //qCDebug(KDENLIVE_LOG)<<" / / /CHECKING PRODUCER PATH: "<<path;
         QUrl url = QUrl::fromLocalFile(path);
         Mlt::Producer *producer = nullptr;
+        QString cacheKey;
+        bool cacheHit = false;
+        QMap<QString, QString> cachedProperties;
+        QImage thumb;
         ClipType type = (ClipType)info.xml.attribute(QStringLiteral("type")).toInt();
         if (type == Unknown) {
             type = getTypeForService(ProjectClip::getXmlProperty(info.xml, QStringLiteral("mlt_service")), path);
@@ -232,7 +258,7 @@ void ProducerQueue::processFileProperties()
             if (!producer->is_valid()) {
                 delete producer;
                 delete xmlProfile;
-                m_processingClipId.removeAll(info.clipId);
+                slotProcessingDone(info.clipId);
                 emit removeInvalidClip(info.clipId, info.replaceProducer);
                 continue;
             }
@@ -246,7 +272,7 @@ void ProducerQueue::processFileProperties()
             } else {
                 path.prepend(QStringLiteral("consumer:"));
                 // This is currently crashing so I guess we'd better reject it for now
-                m_processingClipId.removeAll(info.clipId);
+                slotProcessingDone(info.clipId);
                 emit removeInvalidClip(info.clipId, info.replaceProducer, i18n("Cannot import playlists with different profile."));
                 continue;
             }
@@ -271,7 +297,34 @@ void ProducerQueue::processFileProperties()
             mlt.appendChild(tractor);
             producer = new Mlt::Producer(*m_binController->profile(), "xml-string", doc.toString().toUtf8().constData());
         } else {
-            producer = new Mlt::Producer(*m_binController->profile(), nullptr, path.toUtf8().constData());
+            if (!proxyProducer && !info.xml.hasAttribute(QStringLiteral("checkProfile"))) {
+                cacheKey = probeCacheKey(path, info.xml);
+                cacheHit = !cacheKey.isEmpty() && loadProbeCache(cacheKey, cachedProperties, thumb);
+            }
+            if (cacheHit) {
+                // File was already probed, restore its properties. The novalidate producer only opens the file on first frame request
+                producer = new Mlt::Producer(*m_binController->profile(), "avformat-novalidate", path.toUtf8().constData());
+                QMapIterator<QString, QString> i(cachedProperties);
+                while (i.hasNext()) {
+                    i.next();
+                    producer->set(i.key().toUtf8().constData(), i.value().toUtf8().constData());
+                }
+            } else {
+                producer = new Mlt::Producer(*m_binController->profile(), nullptr, path.toUtf8().constData());
+                if (!cacheKey.isEmpty() && producer->is_valid() && qstrcmp(producer->get("mlt_service"), "avformat") == 0) {
+                    // Keep what libavformat reported, before project specific properties are applied
+                    Mlt::Properties probed(producer->get_properties());
+                    for (int i = 0; i < probed.count(); ++i) {
+                        const QString name = probed.get_name(i);
+                        if (name.startsWith(QLatin1Char('_')) || name.startsWith(QLatin1String("kdenlive")) || name == QLatin1String("id") || name == QLatin1String("resource") || name.startsWith(QLatin1String("mlt_"))) {
+                            continue;
+                        }
+                        if (probed.get(i)) {
+                            cachedProperties.insert(name, QString::fromUtf8(probed.get(i)));
+                        }
+                    }
+                }
+            }
             if (producer->is_valid() && info.xml.hasAttribute(QStringLiteral("checkProfile")) && producer->get_int("video_index") > -1) {
                 // Check if clip profile matches
                 QString service = producer->get("mlt_service");
@@ -331,7 +384,7 @@ void ProducerQueue::processFileProperties()
         }
         if (producer == nullptr || producer->is_blank() || !producer->is_valid()) {
             qCDebug(KDENLIVE_LOG) << " / / / / / / / / ERROR / / / / // CANNOT LOAD PRODUCER: " << path;
-            m_processingClipId.removeAll(info.clipId);
+            slotProcessingDone(info.clipId);
             if (proxyProducer) {
                 // Proxy file is corrupted
                 emit removeInvalidProxy(info.clipId, false);
@@ -358,7 +411,7 @@ void ProducerQueue::processFileProperties()
             if (producer->get_out() != info.xml.attribute(QStringLiteral("proxy_out")).toInt()) {
                 // Proxy file length is different than original clip length, this will corrupt project so disable this proxy clip
                 qCDebug(KDENLIVE_LOG) << "/ // PROXY LENGTH MISMATCH, DELETE PRODUCER";
-                m_processingClipId.removeAll(info.clipId);
+                slotProcessingDone(info.clipId);
                 emit removeInvalidProxy(info.clipId, true);
                 delete producer;
                 continue;
@@ -500,7 +553,7 @@ void ProducerQueue::processFileProperties()
                 }
             }
             // replace clip
-            m_processingClipId.removeAll(info.clipId);
+            slotProcessingDone(info.clipId);
 
             // Store original properties in a kdenlive: prefixed format
             QDomNodeList props = info.xml.elementsByTagName(QStringLiteral("property"));
@@ -512,8 +565,7 @@ void ProducerQueue::processFileProperties()
                     producer->set(name.toUtf8().constData(), e.firstChild().nodeValue().toUtf8().constData());
                 }
             }
-            m_binController->replaceProducer(info.clipId, *producer);
-            emit gotFileProperties(info, nullptr);
+            queueProducer(info, producer, true);
             continue;
         }
         // We are not replacing an existing producer, so set the id
@@ -608,7 +660,7 @@ void ProducerQueue::processFileProperties()
                 producer->set("out", fixedLength - 1);
             }
             delete tmpProd;
-        } else if (mltService == QLatin1String("avformat")) {
+        } else if (mltService.startsWith(QLatin1String("avformat"))) {
             // Get frame rate
             vindex = producer->get_int("video_index");
             // List streams
@@ -667,8 +719,12 @@ void ProducerQueue::processFileProperties()
                 vindex = -1;
             }
         }
-        Mlt::Frame *frame = producer->get_frame();
-        if (frame && frame->is_valid()) {
+        Mlt::Frame *frame = cacheHit ? nullptr : producer->get_frame();
+        if (cacheHit) {
+            if (!thumb.isNull()) {
+                emit replyGetImage(info.clipId, thumb.height() == info.imageHeight ? thumb : thumb.scaledToHeight(info.imageHeight, Qt::SmoothTransformation));
+            }
+        } else if (frame && frame->is_valid()) {
             if (!mltService.contains(QStringLiteral("avformat"))) {
                 // Fetch thumbnail
                 QImage img;
@@ -750,6 +806,7 @@ void ProducerQueue::processFileProperties()
                     if (frameNumber > -1) {
                         filePropertyMap[QStringLiteral("thumbnailFrame")] = QString::number(frameNumber);
                     }
+                    thumb = img;
                     emit replyGetImage(info.clipId, img);
                 } else if (frame->get_int("test_audio") == 0) {
                     filePropertyMap[QStringLiteral("type")] = QStringLiteral("audio");
@@ -830,17 +887,45 @@ void ProducerQueue::processFileProperties()
             }
         }
         producer->seek(0);
-        if (m_binController->hasClip(info.clipId)) {
+        if (!cacheKey.isEmpty() && !cacheHit && mltService == QLatin1String("avformat")) {
+            saveProbeCache(cacheKey, cachedProperties, thumb);
+        }
+        queueProducer(info, producer, false);
+    }
+}
+
+void ProducerQueue::queueProducer(const requestClipInfo &info, Mlt::Producer *producer, bool replaceOnly)
+{
+    ReadyProducer ready;
+    ready.info = info;
+    ready.producer = producer;
+    ready.replaceOnly = replaceOnly;
+    m_infoMutex.lock();
+    m_readyProducers.append(ready);
+    m_infoMutex.unlock();
+    QMetaObject::invokeMethod(this, "registerProducers", Qt::QueuedConnection);
+}
+
+void ProducerQueue::registerProducers()
+{
+    // Called in the main thread, so the workers never modify the bin controller concurrently
+    m_infoMutex.lock();
+    QList<ReadyProducer> readyList = m_readyProducers;
+    m_readyProducers.clear();
+    m_infoMutex.unlock();
+    for (const ReadyProducer &ready : readyList) {
+        const requestClipInfo &info = ready.info;
+        if (ready.replaceOnly || m_binController->hasClip(info.clipId)) {
             // If controller already exists, we just want to update the producer
-            m_binController->replaceProducer(info.clipId, *producer);
+            m_binController->replaceProducer(info.clipId, *ready.producer);
             emit gotFileProperties(info, nullptr);
         } else {
             // Create the controller
-            ClipController *controller = new ClipController(m_binController, *producer);
+            ClipController *controller = new ClipController(m_binController, *ready.producer);
             m_binController->addClipToBin(info.clipId, controller);
             emit gotFileProperties(info, controller);
         }
-        m_processingClipId.removeAll(info.clipId);
+        slotProcessingDone(info.clipId);
     }
 }
 
@@ -849,7 +934,71 @@ void ProducerQueue::abortOperations()
     m_infoMutex.lock();
     m_requestList.clear();
     m_infoMutex.unlock();
-    m_infoThread.waitForFinished();
+    m_infoPool.waitForDone();
+    // Drop the producers that were not registered yet
+    QMutexLocker lock(&m_infoMutex);
+    for (const ReadyProducer &ready : m_readyProducers) {
+        m_processingClipId.removeAll(ready.info.clipId);
+        delete ready.producer;
+    }
+    m_readyProducers.clear();
+}
+
+QString ProducerQueue::probeCacheKey(const QString &path, const QDomElement &xml) const
+{
+    if (m_probeCachePath.isEmpty()) {
+        return QString();
+    }
+    QFileInfo fileInfo(path);
+    if (!fileInfo.isFile()) {
+        return QString();
+    }
+    QByteArray key = fileInfo.absoluteFilePath().toUtf8();
+    key.append(QByteArray::number(fileInfo.size()));
+    key.append(QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+    // Forced streams change the probed properties and thumbnail
+    key.append(ProjectClip::getXmlProperty(xml, QStringLiteral("video_index")).toUtf8());
+    key.append(ProjectClip::getXmlProperty(xml, QStringLiteral("kdenlive-force.video_index")).toUtf8());
+    key.append(ProjectClip::getXmlProperty(xml, QStringLiteral("audio_index")).toUtf8());
+    key.append(ProjectClip::getXmlProperty(xml, QStringLiteral("kdenlive-force.audio_index")).toUtf8());
+    return QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Md5).toHex());
+}
+
+bool ProducerQueue::loadProbeCache(const QString &key, QMap<QString, QString> &properties, QImage &thumb) const
+{
+    QFile file(m_probeCachePath + key + QStringLiteral(".probe"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic;
+    qint32 version;
+    stream >> magic >> version;
+    if (magic != probeCacheMagic || version != probeCacheVersion) {
+        return false;
+    }
+    stream >> properties >> thumb;
+    return stream.status() == QDataStream::Ok && properties.contains(QStringLiteral("length"));
+}
+
+void ProducerQueue::saveProbeCache(const QString &key, const QMap<QString, QString> &properties, const QImage &thumb) const
+{
+    if (!properties.contains(QStringLiteral("length"))) {
+        return;
+    }
+    QSaveFile file(m_probeCachePath + key + QStringLiteral(".probe"));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << probeCacheMagic << probeCacheVersion << properties << thumb;
+    if (stream.status() == QDataStream::Ok) {
+        file.commit();
+    } else {
+        file.cancelWriting();
+    }
 }
 
 ClipType ProducerQueue::getTypeForService(const QString &id, const QString &path) const
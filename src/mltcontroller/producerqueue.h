@@ -25,10 +25,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "definitions.h"
 
 #include <QMutex>
-#include <QFuture>
+#include <QThreadPool>
 
 class ClipController;
 class BinController;
+class QImage;
 
 namespace Mlt
 {
@@ -58,15 +59,38 @@ public:
     void abortOperations();
 
 private:
+    /** @brief A producer built by a worker thread, waiting for registration in the bin */
+    struct ReadyProducer {
+        requestClipInfo info;
+        Mlt::Producer *producer;
+        /** @brief Only replace the producer of an existing clip, never create a new one */
+        bool replaceOnly;
+    };
     QMutex m_infoMutex;
     QList<requestClipInfo> m_requestList;
     /** @brief The ids of the clips that are currently being loaded for info query */
     QStringList m_processingClipId;
-    QFuture <void> m_infoThread;
+    /** @brief Number of threads currently processing the request list */
+    int m_infoWorkers;
+    QThreadPool m_infoPool;
     BinController *m_binController;
+    /** @brief Folder storing the probed properties of media files, shared by all projects */
+    QString m_probeCachePath;
+    /** @brief Producers built by the workers, the bin controller is only modified from the main thread */
+    QList<ReadyProducer> m_readyProducers;
     ClipType getTypeForService(const QString &id, const QString &path) const;
     /** @brief Pass xml values to an MLT producer at build time */
     void processProducerProperties(Mlt::Producer *prod, const QDomElement &xml);
+    /** @brief Start enough threads to process the waiting requests */
+    void startWorkers();
+    /** @brief Hand a producer built in a worker thread over to the main thread for registration */
+    void queueProducer(const requestClipInfo &info, Mlt::Producer *producer, bool replaceOnly);
+    /** @brief Returns the probe cache key for a media file (based on path, size and modification date), empty if it cannot be cached */
+    QString probeCacheKey(const QString &path, const QDomElement &xml) const;
+    /** @brief Read the cached properties and thumbnail of a probed file, returns false if there is no valid cache entry */
+    bool loadProbeCache(const QString &key, QMap<QString, QString> &properties, QImage &thumb) const;
+    /** @brief Store the properties and thumbnail of a probed file */
+    void saveProbeCache(const QString &key, const QMap<QString, QString> &properties, const QImage &thumb) const;
 
 public slots:
     /** @brief Requests the file properties for the specified URL (will be put in a queue list)
@@ -80,8 +104,10 @@ public slots:
     void slotProcessingDone(const QString &id);
 
 private slots:
-    /** @brief Process the clip info requests (in a separate thread). */
+    /** @brief Process the clip info requests (in several threads). */
     void processFileProperties();
+    /** @brief Add or replace the producers built by the workers in the bin controller (main thread). */
+    void registerProducers();
     /** @brief A clip with multiple video streams was found, ask what to do. */
     void slotMultiStreamProducerFound(const QString &path, const QList<int> &audio_list, const QList<int> &video_list, stringMap data);
 
@@ -21,12 +21,15 @@
 #define ABSTRACTMONITOR_H
 
 #include "definitions.h"
+#include "lib/audio/audioSampleRing.h"
+#include "scopes/sharedframe.h"
 
 #include <stdint.h>
 
 #include <QObject>
 #include <QWidget>
 #include <QImage>
+#include <QSharedPointer>
 
 class MonitorManager;
 
@@ -42,6 +45,7 @@ Q_OBJECT public:
         : QObject(parent),
           sendFrameForAnalysis(false),
           analyseAudio(false),
+          audioSamples(new AudioSampleRing),
           m_id(name)
     {
     }
@@ -55,6 +59,9 @@ Q_OBJECT public:
     /** @brief This property is used to decide if the renderer should send audio data for monitoring. */
     bool analyseAudio;
 
+    /** @brief The audio of the played frames, read by the audio scopes. */
+    QSharedPointer<AudioSampleRing> audioSamples;
+
     Kdenlive::MonitorId id() const
     {
         return m_id;
@@ -69,9 +76,8 @@ private:
 signals:
     /** @brief The renderer refreshed the current frame. */
     void frameUpdated(const QImage &);
-
-    /** @brief This signal contains the audio of the current frame. */
-    void audioSamplesSignal(const audioShortVector &, int, int, int);
+    /** @brief The renderer displayed a yuv420p frame, which scopes can read without copy. */
+    void sharedFrameUpdated(const SharedFrame &);
     /** @brief Scopes are ready to receive a new frame. */
     void scopesClear();
 };
@@ -144,6 +144,14 @@ void GLWidget::updateAudioForAnalysis()
     }
 }
 
+void GLWidget::setAudioSamples(const QSharedPointer<AudioSampleRing> &samples)
+{
+    m_audioSamples = samples;
+    if (m_frameRenderer) {
+        m_frameRenderer->audioSamples = samples;
+    }
+}
+
 void GLWidget::initializeGL()
 {
     if (m_isInitialized || !isVisible() || !openglContext()) return;
@@ -200,16 +208,17 @@ void GLWidget::initializeGL()
     }
     m_frameRenderer = new FrameRenderer(openglContext(), &m_offscreenSurface);
     m_frameRenderer->sendAudioForAnalysis = KdenliveSettings::monitor_audio();
+    m_frameRenderer->audioSamples = m_audioSamples;
     openglContext()->makeCurrent(this);
     //openglContext()->blockSignals(false);
     connect(m_frameRenderer, &FrameRenderer::frameDisplayed, this, &GLWidget::frameDisplayed, Qt::QueuedConnection);
+    connect(m_frameRenderer, &FrameRenderer::frameDisplayed, this, &GLWidget::sendFrameToScopes, Qt::QueuedConnection);
     if (KdenliveSettings::gpu_accel() || openglContext()->supportsThreadedOpenGL()) {
         connect(m_frameRenderer, &FrameRenderer::textureReady, this, &GLWidget::updateTexture, Qt::DirectConnection);
     } else {
         connect(m_frameRenderer, &FrameRenderer::frameDisplayed, this, &GLWidget::onFrameDisplayed, Qt::QueuedConnection);
     }
 
-    connect(m_frameRenderer, &FrameRenderer::audioSamplesSignal, this, &GLWidget::audioSamplesSignal, Qt::QueuedConnection);
     connect(this, &GLWidget::textureUpdated, this, &GLWidget::update, Qt::QueuedConnection);
     m_initSem.release();
     m_isInitialized = true;
@@ -481,8 +490,8 @@ void GLWidget::paintGL()
     f->glDrawArrays(GL_TRIANGLE_STRIP, 0, vertices.size());
     check_error(f);
 
-    if (m_sendFrame && m_analyseSem.tryAcquire(1)) {
-        // Render RGB frame for analysis
+    if (m_glslManager && m_sendFrame && m_analyseSem.tryAcquire(1)) {
+        // Movit frames only exist as a texture, render RGB frame for analysis
         int fullWidth = m_monitorProfile->width();
         int fullHeight = m_monitorProfile->height();
         if (!m_fbo || m_fbo->size() != QSize(fullWidth, fullHeight)) {
@@ -1147,6 +1156,14 @@ void GLWidget::onFrameDisplayed(const SharedFrame &frame)
     update();
 }
 
+void GLWidget::sendFrameToScopes(const SharedFrame &frame)
+{
+    // Scopes read the YUV planes of the displayed frame, no GPU readback needed
+    if (sendFrameForAnalysis && frame.get_image_format() == mlt_image_yuv420p && m_analyseSem.tryAcquire(1)) {
+        emit analyseSharedFrame(frame);
+    }
+}
+
 void GLWidget::mouseReleaseEvent(QMouseEvent *event)
 {
     QQuickView::mouseReleaseEvent(event);
@@ -1326,6 +1343,7 @@ void FrameRenderer::showFrame(Mlt::Frame frame)
     int height = 0;
     mlt_image_format format = mlt_image_yuv420p;
     frame.get_image(format, width, height);
+    sendAudio(frame);
     // Save this frame for future use and to keep a reference to the GL Texture.
     m_displayFrame = SharedFrame(frame);
 
@@ -1384,6 +1402,7 @@ void FrameRenderer::showGLFrame(Mlt::Frame frame)
 
         emit textureReady(*textureId);
         m_context->doneCurrent();
+        sendAudio(frame);
 
         // Save this frame for future use and to keep a reference to the GL Texture.
         m_frame = SharedFrame(frame);
@@ -1409,6 +1428,7 @@ void FrameRenderer::showGLNoSyncFrame(Mlt::Frame frame)
 
         emit textureReady(*textureId);
         m_context->doneCurrent();
+        sendAudio(frame);
 
         // Save this frame for future use and to keep a reference to the GL Texture.
         m_frame = SharedFrame(frame);
@@ -1421,6 +1441,22 @@ void FrameRenderer::showGLNoSyncFrame(Mlt::Frame frame)
     m_semaphore.release();
 }
 
+void FrameRenderer::sendAudio(Mlt::Frame &frame)
+{
+    if (!sendAudioForAnalysis || !audioSamples || frame.get_int("test_audio") != 0) {
+        return;
+    }
+    mlt_audio_format audio_format = mlt_audio_s16;
+    int freq = frame.get_int("audio_frequency");
+    int num_channels = frame.get_int("audio_channels");
+    int samples = 0;
+    if (freq <= 0 || num_channels <= 0) {
+        return;
+    }
+    const qint16 *data = (const qint16 *) frame.get_audio(audio_format, freq, num_channels, samples);
+    audioSamples->write(data, samples, num_channels, freq);
+}
+
 void FrameRenderer::clearFrame()
 {
     m_frame = SharedFrame();
@@ -1440,39 +1476,34 @@ void FrameRenderer::cleanup()
     }
 }
 
-void GLWidget::setAudioThumb(int channels, const QVariantList &audioCache)
+void GLWidget::setAudioThumb(const AudioLevels &audioLevels)
 {
     if (rootObject()) {
         QmlAudioThumb *audioThumbDisplay = rootObject()->findChild<QmlAudioThumb *>(QStringLiteral("audiothumb"));
         if (audioThumbDisplay) {
             QImage img(width(), height() / 6, QImage::Format_ARGB32_Premultiplied);
             img.fill(Qt::transparent);
-            if (!audioCache.isEmpty() && channels > 0) {
-                int audioLevelCount = audioCache.count() - 1;
+            if (!audioLevels.isEmpty()) {
+                int frames = audioLevels.frames();
                 // simplified audio
                 QPainter painter(&img);
                 QRectF mappedRect(0, 0, img.width(), img.height());
                 int channelHeight = mappedRect.height();
                 double value;
-                double scale = (double) width() / (audioLevelCount / channels);
+                double scale = (double) width() / frames;
                 if (scale < 1) {
+                    int pyramidLevel = audioLevels.pyramidLevel(1.0 / scale);
                     painter.setPen(QColor(80, 80, 150, 200));
                     for (int i = 0; i < img.width(); i++) {
                         int framePos = i / scale;
-                        value = audioCache.at(qMin(framePos * channels, audioLevelCount)).toDouble() / 256;
-                        for (int channel = 1; channel < channels; channel ++) {
-                            value = qMax(value, audioCache.at(qMin(framePos * channels + channel, audioLevelCount)).toDouble() / 256);
-                        }
+                        value = audioLevels.maxLevel(framePos, pyramidLevel) / 256.0;
                         painter.drawLine(i, mappedRect.bottom() - (value * channelHeight), i, mappedRect.bottom());
                     }
                 } else {
                     QPainterPath positiveChannelPath;
                     positiveChannelPath.moveTo(0, mappedRect.bottom());
-                    for (int i = 0; i < audioLevelCount / channels; i++) {
-                        value = audioCache.at(qMin(i * channels, audioLevelCount)).toDouble() / 256;
-                        for (int channel = 1; channel < channels; channel ++) {
-                            value = qMax(value, audioCache.at(qMin(i * channels + channel, audioLevelCount)).toDouble() / 256);
-                        }
+                    for (int i = 0; i < frames; i++) {
+                        value = audioLevels.maxLevel(i) / 256.0;
                         positiveChannelPath.lineTo(i * scale, mappedRect.bottom() - (value * channelHeight));
                     }
                     positiveChannelPath.lineTo(mappedRect.right(), mappedRect.bottom());
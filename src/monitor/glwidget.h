@@ -32,6 +32,8 @@
 
 #include "scopes/sharedframe.h"
 #include "definitions.h"
+#include "lib/audio/audioLevels.h"
+#include "lib/audio/audioSampleRing.h"
 
 class QOpenGLFunctions_3_2_Core;
 //class QmlFilter;
@@ -73,6 +75,8 @@ public:
         return m_rect.width();
     }
     void updateAudioForAnalysis();
+    /** @brief Set the ring buffer receiving the audio of displayed frames when audio analysis is enabled */
+    void setAudioSamples(const QSharedPointer<AudioSampleRing> &samples);
     int displayHeight() const
     {
         return m_rect.height();
@@ -110,7 +114,7 @@ public:
     void lockMonitor();
     void releaseMonitor();
     int realTime() const;
-    void setAudioThumb(int channels = 0, const QVariantList &audioCache = QList<QVariant>());
+    void setAudioThumb(const AudioLevels &audioLevels = AudioLevels());
     int droppedFrames() const;
     void resetDrops();
 
@@ -145,7 +149,7 @@ signals:
     void mouseSeek(int eventDelta, int modifiers);
     void startDrag();
     void analyseFrame(const QImage&);
-    void audioSamplesSignal(const audioShortVector &, int, int, int);
+    void analyseSharedFrame(const SharedFrame &frame);
     void showContextMenu(const QPoint &);
     void lockMonitor(bool);
     void passKeyEvent(QKeyEvent *);
@@ -172,6 +176,7 @@ private:
     Mlt::Event *m_displayEvent;
     Mlt::Profile *m_monitorProfile;
     FrameRenderer *m_frameRenderer;
+    QSharedPointer<AudioSampleRing> m_audioSamples;
     int m_projectionLocation;
     int m_modelViewLocation;
     int m_vertexLocation;
@@ -201,6 +206,8 @@ private slots:
     void updateTexture(GLuint yName, GLuint uName, GLuint vName);
     void paintGL();
     void onFrameDisplayed(const SharedFrame &frame);
+    /** @brief Pass a displayed yuv420p frame to the scopes if they requested one */
+    void sendFrameToScopes(const SharedFrame &frame);
 
 protected:
     void resizeEvent(QResizeEvent *event) Q_DECL_OVERRIDE;
@@ -252,7 +259,6 @@ public slots:
 signals:
     void textureReady(GLuint yName, GLuint uName = 0, GLuint vName = 0);
     void frameDisplayed(const SharedFrame &frame);
-    void audioSamplesSignal(const audioShortVector &, int, int, int);
 
 private:
     QSemaphore m_semaphore;
@@ -266,6 +272,11 @@ public:
     GLuint m_displayTexture[3];
     QOpenGLFunctions_3_2_Core *m_gl32;
     bool sendAudioForAnalysis;
+    QSharedPointer<AudioSampleRing> audioSamples;
+
+private:
+    /** @brief Copy the frame's audio to audioSamples if audio analysis is enabled */
+    void sendAudio(Mlt::Frame &frame);
 };
 
 #endif
@@ -295,7 +295,8 @@ Monitor::Monitor(Kdenlive::MonitorId id, MonitorManager *manager, QWidget *paren
     connect(render, &Render::rendererStopped, this, &Monitor::rendererStopped);
     connect(render, &AbstractRender::scopesClear, m_glMonitor, &GLWidget::releaseAnalyse, Qt::DirectConnection);
     connect(m_glMonitor, SIGNAL(analyseFrame(QImage)), render, SIGNAL(frameUpdated(QImage)));
-    connect(m_glMonitor, &GLWidget::audioSamplesSignal, render, &AbstractRender::audioSamplesSignal);
+    connect(m_glMonitor, &GLWidget::analyseSharedFrame, render, &AbstractRender::sharedFrameUpdated);
+    m_glMonitor->setAudioSamples(render->audioSamples);
 
     if (id != Kdenlive::ClipMonitor) {
         connect(render, &Render::durationChanged, this, &Monitor::durationChanged);
@@ -2147,9 +2148,9 @@ void Monitor::slotEditInlineMarker()
     }
 }
 
-void Monitor::prepareAudioThumb(int channels, QVariantList &audioCache)
+void Monitor::prepareAudioThumb(const AudioLevels &audioLevels)
 {
-    m_glMonitor->setAudioThumb(channels, audioCache);
+    m_glMonitor->setAudioThumb(audioLevels);
 }
 
 void Monitor::slotUpdateQmlTimecode(const QString &tc)
@@ -27,6 +27,7 @@
 #include "timecodedisplay.h"
 #include "scopes/sharedframe.h"
 #include "effectslist/effectslist.h"
+#include "lib/audio/audioLevels.h"
 
 #include <QDomElement>
 #include <QToolBar>
@@ -142,7 +143,7 @@ public:
     QAction *recAction();
     void refreshIcons();
     /** @brief Send audio thumb data to qml for on monitor display */
-    void prepareAudioThumb(int channels, QVariantList &audioCache);
+    void prepareAudioThumb(const AudioLevels &audioLevels = AudioLevels());
     void refreshMonitorIfActive();
     void connectAudioSpectrum(bool activate);
     /** @brief Set a property on the Qml scene **/
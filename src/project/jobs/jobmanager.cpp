@@ -43,6 +43,9 @@ JobManager::JobManager(Bin *bin): QObject()
     , m_bin(bin)
     , m_abortAllJobs(false)
 {
+    for (int i = 0; i < ResourceCount; ++i) {
+        m_runningCount[i] = 0;
+    }
     connect(this, &JobManager::processLog, this, &JobManager::slotProcessLog);
     connect(this, &JobManager::checkJobProcess, this, &JobManager::slotCheckJobProcess);
 }
@@ -128,7 +131,7 @@ void JobManager::slotCheckJobProcess()
     for (int i = 0; i < m_jobList.count(); ++i) {
         if (m_jobList.at(i)->status() == JobWorking || m_jobList.at(i)->status() == JobWaiting) {
             count ++;
-        } else {
+        } else if (!m_runningJobs.contains(m_jobList.at(i))) {
             // remove finished jobs
             AbstractClipJob *job = m_jobList.takeAt(i);
             job->deleteLater();
@@ -137,9 +140,93 @@ void JobManager::slotCheckJobProcess()
     }
     m_jobMutex.unlock();
     emit jobCount(count);
-    if (m_jobThreads.futures().isEmpty() || m_jobThreads.futures().count() < KdenliveSettings::proxythreads()) {
-        m_jobThreads.addFuture(QtConcurrent::run(this, &JobManager::slotProcessJobs));
+    startJobs();
+}
+
+JobManager::JobResource JobManager::jobResource(AbstractClipJob::JOBTYPE type)
+{
+    switch (type) {
+    case AbstractClipJob::MLTJOB:
+    case AbstractClipJob::FILTERCLIPJOB:
+    case AbstractClipJob::ANALYSECLIPJOB:
+        return AnalyseResource;
+    default:
+        return EncodeResource;
+    }
+}
+
+int JobManager::jobPriority(AbstractClipJob::JOBTYPE type)
+{
+    switch (type) {
+    case AbstractClipJob::PROXYJOB:
+        // Other jobs and timeline editing depend on proxies
+        return 0;
+    case AbstractClipJob::MLTJOB:
+        // Requested from a timeline effect
+        return 1;
+    default:
+        return 2;
+    }
+}
+
+int JobManager::resourceLimit(JobResource resource)
+{
+    if (resource == AnalyseResource) {
+        return qMax(1, KdenliveSettings::analysethreads());
+    }
+    return qMax(1, KdenliveSettings::proxythreads());
+}
+
+AbstractClipJob *JobManager::nextJob() const
+{
+    AbstractClipJob *next = nullptr;
+    for (int i = 0; i < m_jobList.count(); ++i) {
+        AbstractClipJob *job = m_jobList.at(i);
+        if (job->status() != JobWaiting) {
+            continue;
+        }
+        JobResource resource = jobResource(job->jobType);
+        if (m_runningCount[resource] >= resourceLimit(resource)) {
+            continue;
+        }
+        if (job->jobType != AbstractClipJob::PROXYJOB) {
+            // Wait until the proxy of this clip is ready
+            bool waitProxy = false;
+            for (int j = 0; j < m_jobList.count(); ++j) {
+                AbstractClipJob *other = m_jobList.at(j);
+                if (other->jobType == AbstractClipJob::PROXYJOB && other->clipId() == job->clipId() && (other->status() == JobWaiting || other->status() == JobWorking)) {
+                    waitProxy = true;
+                    break;
+                }
+            }
+            if (waitProxy) {
+                continue;
+            }
+        }
+        // Keep the oldest job among those with the best priority
+        if (next == nullptr || jobPriority(job->jobType) < jobPriority(next->jobType)) {
+            next = job;
+        }
+    }
+    return next;
+}
+
+void JobManager::startJobs()
+{
+    if (m_abortAllJobs) {
+        return;
+    }
+    m_jobPool.setMaxThreadCount(resourceLimit(EncodeResource) + resourceLimit(AnalyseResource));
+    QMutexLocker lock(&m_jobMutex);
+    AbstractClipJob *job = nextJob();
+    while (job) {
+        job->setStatus(JobWorking);
+        m_runningJobs << job;
+        m_runningCount[jobResource(job->jobType)]++;
+        m_jobThreads.addFuture(QtConcurrent::run(&m_jobPool, this, &JobManager::processJob, job));
+        job = nextJob();
     }
+    updateJobCount();
 }
 
 void JobManager::updateJobCount()
@@ -154,42 +241,22 @@ void JobManager::updateJobCount()
     emit jobCount(count);
 }
 
-void JobManager::slotProcessJobs()
+void JobManager::processJob(AbstractClipJob *job)
 {
-    bool firstPass = true;
-    while (!m_jobList.isEmpty() && !m_abortAllJobs) {
-        AbstractClipJob *job = nullptr;
-        m_jobMutex.lock();
-        for (int i = 0; i < m_jobList.count(); ++i) {
-            if (m_jobList.at(i)->status() == JobWaiting) {
-                job = m_jobList.at(i);
-                job->setStatus(JobWorking);
-                break;
-            }
-        }
-        if (!firstPass) {
-            updateJobCount();
-        }
-        m_jobMutex.unlock();
-
-        if (job == nullptr) {
-            break;
-        }
-        firstPass = false;
-        QString destination = job->destination();
-        // Check if the clip is still here
-        ProjectClip *currentClip = m_bin->getBinClip(job->clipId());
-        if (currentClip == nullptr) {
-            job->setStatus(JobDone);
-            continue;
-        }
+    QString destination = job->destination();
+    // Check if the clip is still here
+    ProjectClip *currentClip = m_bin->getBinClip(job->clipId());
+    if (currentClip == nullptr) {
+        job->setStatus(JobDone);
+    } else if (job->status() == JobWorking) {
         // Set clip status to started
         currentClip->setJobStatus(job->jobType, job->status());
 
         // Make sure destination path is writable
+        bool writable = true;
         if (!destination.isEmpty()) {
             QFileInfo file(destination);
-            bool writable = false;
+            writable = false;
             if (file.exists()) {
                 if (file.isWritable()) {
                     writable = true;
@@ -206,30 +273,35 @@ void JobManager::slotProcessJobs()
             if (!writable) {
                 emit updateJobStatus(job->clipId(), job->jobType, JobCrashed, i18n("Cannot write to path: %1", destination));
                 job->setStatus(JobCrashed);
-                continue;
             }
         }
-        connect(job, SIGNAL(jobProgress(QString, int, int)), this, SIGNAL(processLog(QString, int, int)));
-        connect(job, &AbstractClipJob::cancelRunningJob, m_bin, &Bin::slotCancelRunningJob);
+        if (writable) {
+            connect(job, SIGNAL(jobProgress(QString, int, int)), this, SIGNAL(processLog(QString, int, int)));
+            connect(job, &AbstractClipJob::cancelRunningJob, m_bin, &Bin::slotCancelRunningJob);
 
-        if (job->jobType == AbstractClipJob::MLTJOB || job->jobType == AbstractClipJob::ANALYSECLIPJOB) {
-            connect(job, SIGNAL(gotFilterJobResults(QString, int, int, stringMap, stringMap)), this, SIGNAL(gotFilterJobResults(QString, int, int, stringMap, stringMap)));
-        }
-        job->startJob();
-        if (job->status() == JobDone) {
-            emit updateJobStatus(job->clipId(), job->jobType, JobDone);
-            //TODO: replace with more generic clip replacement framework
-            if (job->jobType == AbstractClipJob::PROXYJOB) {
-                m_bin->gotProxy(job->clipId(), destination);
-            } else if (job->addClipToProject() > -100) {
-                emit addClip(destination, job->addClipToProject());
+            if (job->jobType == AbstractClipJob::MLTJOB || job->jobType == AbstractClipJob::ANALYSECLIPJOB) {
+                connect(job, SIGNAL(gotFilterJobResults(QString, int, int, stringMap, stringMap)), this, SIGNAL(gotFilterJobResults(QString, int, int, stringMap, stringMap)));
+            }
+            job->startJob();
+            if (job->status() == JobDone) {
+                emit updateJobStatus(job->clipId(), job->jobType, JobDone);
+                //TODO: replace with more generic clip replacement framework
+                if (job->jobType == AbstractClipJob::PROXYJOB) {
+                    m_bin->gotProxy(job->clipId(), destination);
+                } else if (job->addClipToProject() > -100) {
+                    emit addClip(destination, job->addClipToProject());
+                }
+            } else if (job->status() == JobCrashed || job->status() == JobAborted) {
+                emit updateJobStatus(job->clipId(), job->jobType, job->status(), job->errorMessage(), QString(), job->logDetails());
             }
-        } else if (job->status() == JobCrashed || job->status() == JobAborted) {
-            emit updateJobStatus(job->clipId(), job->jobType, job->status(), job->errorMessage(), QString(), job->logDetails());
         }
     }
-    // Thread finished, cleanup & update count
-    QTimer::singleShot(200, this, &JobManager::checkJobProcess);
+    m_jobMutex.lock();
+    m_runningJobs.removeAll(job);
+    m_runningCount[jobResource(job->jobType)]--;
+    m_jobMutex.unlock();
+    // Job finished, cleanup, update count & start next jobs
+    emit checkJobProcess();
 }
 
 QList<ProjectClip *> JobManager::filterClips(const QList<ProjectClip *> &clips, AbstractClipJob::JOBTYPE jobType, const QStringList &params)
@@ -291,7 +363,9 @@ void JobManager::launchJob(ProjectClip *clip, AbstractClipJob *job, bool runQueu
         return;
     }
 
+    m_jobMutex.lock();
     m_jobList.append(job);
+    m_jobMutex.unlock();
     clip->setJobStatus(job->jobType, JobWaiting, 0, job->statusMessage());
     if (runQueue) {
         slotCheckJobProcess();
@@ -329,9 +403,11 @@ void JobManager::slotCancelPendingJobs()
 void JobManager::slotCancelJobs()
 {
     m_abortAllJobs = true;
+    m_jobMutex.lock();
     for (int i = 0; i < m_jobList.count(); ++i) {
         m_jobList.at(i)->setStatus(JobAborted);
     }
+    m_jobMutex.unlock();
     m_jobThreads.waitForFinished();
     m_jobThreads.clearFutures();
 
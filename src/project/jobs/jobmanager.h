@@ -28,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QObject>
 #include <QMutex>
 #include <QFutureSynchronizer>
+#include <QThreadPool>
 
 class AbstractClipJob;
 class Bin;
@@ -95,7 +96,6 @@ public:
 
 private slots:
     void slotCheckJobProcess();
-    void slotProcessJobs();
     void slotProcessLog(const QString &id, int progress, int type, const QString &message);
 
 public slots:
@@ -107,6 +107,12 @@ public slots:
     void slotCancelPendingJobs();
 
 private:
+    /** @brief Jobs sharing a resource are limited to a configurable number of concurrent jobs. */
+    enum JobResource {
+        EncodeResource = 0,
+        AnalyseResource = 1,
+        ResourceCount = 2
+    };
     /** @brief A pointer to the project's bin. */
     Bin *m_bin;
     /** @brief Mutex preventing thread issues. */
@@ -115,12 +121,30 @@ private:
     QList<AbstractClipJob *> m_jobList;
     /** @brief Holds the threads running a job. */
     QFutureSynchronizer<void> m_jobThreads;
+    /** @brief Thread pool running the jobs, sized to the sum of all resource limits. */
+    QThreadPool m_jobPool;
+    /** @brief Jobs currently processed by a thread, they must not be deleted. */
+    QList<AbstractClipJob *> m_runningJobs;
+    /** @brief Number of running jobs for each resource. */
+    int m_runningCount[ResourceCount];
     /** @brief Set to true to trigger abortion of all jobs. */
     bool m_abortAllJobs;
     /** @brief Create a proxy for a clip. */
     void createProxy(const QString &id);
     /** @brief Update job count in info widget. */
     void updateJobCount();
+    /** @brief Start waiting jobs as long as their resource has free slots. */
+    void startJobs();
+    /** @brief Returns the next job that can be started, or nullptr. Must be called with m_jobMutex locked. */
+    AbstractClipJob *nextJob() const;
+    /** @brief Process one job, running in a thread of m_jobPool. */
+    void processJob(AbstractClipJob *job);
+    /** @brief Returns the resource used by a job type. */
+    static JobResource jobResource(AbstractClipJob::JOBTYPE type);
+    /** @brief Returns the priority of a job type, lower values start first. */
+    static int jobPriority(AbstractClipJob::JOBTYPE type);
+    /** @brief Returns the maximum number of concurrent jobs for a resource. */
+    static int resourceLimit(JobResource resource);
 
 signals:
     void addClip(const QString &, int folderId);
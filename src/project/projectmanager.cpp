@@ -381,6 +381,7 @@ bool ProjectManager::saveFile()
         return saveFileAs();
     } else {
         bool result = saveFileAs(m_project->url().toLocalFile());
+        m_project->waitForAutoSave();
         m_project->m_autosave->resize(0);
         return result;
     }
@@ -675,6 +676,10 @@ void ProjectManager::slotStartAutoSave()
 
 void ProjectManager::slotAutoSave()
 {
+    if (!m_project->needsAutoSave()) {
+        // Nothing changed since the last autosave
+        return;
+    }
     prepareSave();
     bool multitrackEnabled = m_trackView->multitrackView;
     if (multitrackEnabled) {
@@ -1052,13 +1052,8 @@ void Render::showAudio(Mlt::Frame &frame)
     }
 
     // Data format: [ c00 c10 c01 c11 c02 c12 c03 c13 ... c0{samples-1} c1{samples-1} for 2 channels.
-    // So the vector is of size samples*channels.
-    audioShortVector sampleVector(samples * num_channels);
-    memcpy(sampleVector.data(), data, samples * num_channels * sizeof(qint16));
-
-    if (samples > 0) {
-        emit audioSamplesSignal(sampleVector, freq, num_channels, samples);
-    }
+    // Copied to the preallocated ring, scopes read it from there.
+    audioSamples->write(data, samples, num_channels, freq);
 }
 
 /*
@@ -1190,7 +1185,7 @@ void Render::unlockService(Mlt::Tractor *tractor)
     service.unlock();
 }
 
-void Render::mltInsertSpace(const QMap<int, int> &trackClipStartList, const QMap<int, int> &trackTransitionStartList, int track, const GenTime &duration, const GenTime &timeOffset)
+void Render::mltInsertSpace(const QMap<int, int> &trackClipStartList, int track, const GenTime &duration, const GenTime &timeOffset)
 {
     if (!m_mltProducer) {
         //qCDebug(KDENLIVE_LOG) << "PLAYLIST NOT INITIALISED //////";
@@ -1202,7 +1197,6 @@ void Render::mltInsertSpace(const QMap<int, int> &trackClipStartList, const QMap
         return;
     }
     ////qCDebug(KDENLIVE_LOG)<<"// CLP STRT LST: "<<trackClipStartList;
-    ////qCDebug(KDENLIVE_LOG)<<"// TRA STRT LST: "<<trackTransitionStartList;
 
     Mlt::Service service(parentProd.get_service());
     Mlt::Tractor tractor(service);
@@ -1239,33 +1233,6 @@ void Render::mltInsertSpace(const QMap<int, int> &trackClipStartList, const QMap
             }
             trackPlaylist.consolidate_blanks(0);
         }
-        // now move transitions
-        mlt_service serv = m_mltProducer->parent().get_service();
-        mlt_service nextservice = mlt_service_get_producer(serv);
-        mlt_properties properties = MLT_SERVICE_PROPERTIES(nextservice);
-        QString mlt_type = mlt_properties_get(properties, "mlt_type");
-        QString resource = mlt_properties_get(properties, "mlt_service");
-
-        while (mlt_type == QLatin1String("transition")) {
-            mlt_transition tr = (mlt_transition) nextservice;
-            int currentTrack = mlt_transition_get_b_track(tr);
-            int currentIn = (int) mlt_transition_get_in(tr);
-            int currentOut = (int) mlt_transition_get_out(tr);
-            insertPos = trackTransitionStartList.value(track);
-            if (insertPos != -1) {
-                insertPos += offset;
-                if (track == currentTrack && currentOut > insertPos && resource != QLatin1String("mix")) {
-                    mlt_transition_set_in_and_out(tr, currentIn + diff, currentOut + diff);
-                }
-            }
-            nextservice = mlt_service_producer(nextservice);
-            if (nextservice == nullptr) {
-                break;
-            }
-            properties = MLT_SERVICE_PROPERTIES(nextservice);
-            mlt_type = mlt_properties_get(properties, "mlt_type");
-            resource = mlt_properties_get(properties, "mlt_service");
-        }
     } else {
         for (int trackNb = tractor.count() - 1; trackNb >= 1; --trackNb) {
             Mlt::Producer trackProducer(tractor.track(trackNb));
@@ -1306,33 +1273,6 @@ void Render::mltInsertSpace(const QMap<int, int> &trackClipStartList, const QMap
                 trackPlaylist.consolidate_blanks(0);
             }
         }
-        // now move transitions
-        mlt_service serv = m_mltProducer->parent().get_service();
-        mlt_service nextservice = mlt_service_get_producer(serv);
-        mlt_properties properties = MLT_SERVICE_PROPERTIES(nextservice);
-        QString mlt_type = mlt_properties_get(properties, "mlt_type");
-        QString resource = mlt_properties_get(properties, "mlt_service");
-
-        while (mlt_type == QLatin1String("transition")) {
-            mlt_transition tr = (mlt_transition) nextservice;
-            int currentIn = (int) mlt_transition_get_in(tr);
-            int currentOut = (int) mlt_transition_get_out(tr);
-            int currentTrack = mlt_transition_get_b_track(tr);
-            insertPos = trackTransitionStartList.value(currentTrack);
-            if (insertPos != -1) {
-                insertPos += offset;
-                if (currentOut > insertPos && resource != QLatin1String("mix")) {
-                    mlt_transition_set_in_and_out(tr, currentIn + diff, currentOut + diff);
-                }
-            }
-            nextservice = mlt_service_producer(nextservice);
-            if (nextservice == nullptr) {
-                break;
-            }
-            properties = MLT_SERVICE_PROPERTIES(nextservice);
-            mlt_type = mlt_properties_get(properties, "mlt_type");
-            resource = mlt_properties_get(properties, "mlt_service");
-        }
     }
     service.unlock();
     mltCheckLength(&tractor);
@@ -1628,6 +1568,7 @@ bool Render::checkX11Grab()
 double Render::getMltVersionInfo(const QString &tag)
 {
     double version = 0;
+    QMutexLocker locker(pCore->getMltRepositoryMutex());
     Mlt::Properties *metadata = pCore->getMltRepository()->metadata(producer_type, tag.toUtf8().data());
     if (metadata && metadata->is_valid()) {
         version = metadata->get_double("version");
@@ -187,7 +187,8 @@ Q_OBJECT public:
      */
     void mltCheckLength(Mlt::Tractor *tractor);
     Mlt::Producer *getSlowmotionProducer(const QString &url);
-    void mltInsertSpace(const QMap<int, int> &trackClipStartList, const QMap<int, int> &trackTransitionStartList, int track, const GenTime &duration, const GenTime &timeOffset);
+    /** @brief Insert or remove space in the track playlists, transitions are moved by TransitionHandler::insertSpace(). */
+    void mltInsertSpace(const QMap<int, int> &trackClipStartList, int track, const GenTime &duration, const GenTime &timeOffset);
     int mltGetSpaceLength(const GenTime &pos, int track, bool fromBlankStart);
     bool mltResizeClipCrop(const ItemInfo &info, GenTime newCropStart);
 
@@ -26,22 +26,24 @@ AbstractAudioScopeWidget::AbstractAudioScopeWidget(bool trackMouse, QWidget *par
     m_nChannels(0),
     m_nSamples(0),
     m_audioFrame(),
-    m_newData(0)
+    m_audioSourceChanged(false)
 {
 }
 
-void AbstractAudioScopeWidget::slotReceiveAudio(const audioShortVector &sampleData, int freq, int num_channels, int num_samples)
+void AbstractAudioScopeWidget::setAudioSource(const QSharedPointer<AudioSampleRing> &source)
+{
+    QMutexLocker lock(&m_audioSourceMutex);
+    if (m_audioSource != source) {
+        m_audioSource = source;
+        m_audioSourceChanged = true;
+    }
+}
+
+void AbstractAudioScopeWidget::slotAudioAvailable()
 {
 #ifdef DEBUG_AASW
     qCDebug(KDENLIVE_LOG) << "Received audio for " << widgetName() << '.';
 #endif
-    m_audioFrame = sampleData;
-    m_freq = freq;
-    m_nChannels = num_channels;
-    m_nSamples = num_samples;
-
-    m_newData.fetchAndAddAcquire(1);
-
     AbstractScopeWidget::slotRenderZoneUpdated();
 }
 
@@ -51,7 +53,21 @@ AbstractAudioScopeWidget::~AbstractAudioScopeWidget()
 
 QImage AbstractAudioScopeWidget::renderScope(uint accelerationFactor)
 {
-    const int newData = m_newData.fetchAndStoreAcquire(0);
+    QSharedPointer<AudioSampleRing> source;
+    m_audioSourceMutex.lock();
+    source = m_audioSource;
+    const bool sourceChanged = m_audioSourceChanged;
+    m_audioSourceChanged = false;
+    m_audioSourceMutex.unlock();
+
+    int newData = 0;
+    if (source) {
+        if (sourceChanged) {
+            source->attach(m_audioReader);
+        }
+        // Copies the newest frame to our own buffer, the writer is never blocked
+        newData = source->readLatest(m_audioReader, m_audioFrame, m_freq, m_nChannels, m_nSamples);
+    }
 
     return renderAudioScope(accelerationFactor, m_audioFrame, m_freq, m_nChannels, m_nSamples, newData);
 }
@@ -12,11 +12,14 @@
 #define ABSTRACTAUDIOSCOPEWIDGET_H
 
 #include <QWidget>
+#include <QMutex>
+#include <QSharedPointer>
 
 #include <stdint.h>
 
 #include "../../definitions.h"
 #include "../abstractscopewidget.h"
+#include "lib/audio/audioSampleRing.h"
 
 class Render;
 
@@ -30,8 +33,12 @@ public:
     explicit AbstractAudioScopeWidget(bool trackMouse = false, QWidget *parent = nullptr);
     virtual ~AbstractAudioScopeWidget();
 
+    /** @brief Set the ring buffer the audio is read from, or a null pointer if there is no active renderer */
+    void setAudioSource(const QSharedPointer<AudioSampleRing> &source);
+
 public slots:
-    void slotReceiveAudio(const audioShortVector &sampleData, int freq, int num_channels, int num_samples);
+    /** @brief New audio was written to the audio source, schedule a rendering */
+    void slotAudioAvailable();
 
 protected:
     /** @brief This is just a wrapper function, subclasses can use renderAudioScope. */
@@ -51,7 +58,11 @@ protected:
 
 private:
     audioShortVector m_audioFrame;
-    QAtomicInt m_newData;
+    QSharedPointer<AudioSampleRing> m_audioSource;
+    AudioSampleRing::Reader m_audioReader;
+    bool m_audioSourceChanged;
+    /** @brief Protects m_audioSource, which is read from the rendering thread */
+    QMutex m_audioSourceMutex;
 
 };
 
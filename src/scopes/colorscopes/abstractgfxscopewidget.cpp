@@ -9,6 +9,7 @@
  ***************************************************************************/
 
 #include "abstractgfxscopewidget.h"
+#include "scopekernels.h"
 #include "renderer.h"
 #include "monitor/monitormanager.h"
 
@@ -30,9 +31,22 @@ AbstractGfxScopeWidget::~AbstractGfxScopeWidget() { }
 QImage AbstractGfxScopeWidget::renderScope(uint accelerationFactor)
 {
     QMutexLocker lock(&m_mutex);
+    if (m_scopeFrame.is_valid()) {
+        return renderYuvScope(accelerationFactor, m_scopeFrame);
+    }
     return renderGfxScope(accelerationFactor, m_scopeImage);
 }
 
+QImage AbstractGfxScopeWidget::renderYuvScope(uint accelerationFactor, const SharedFrame &frame)
+{
+    const YuvPlanes planes(frame);
+    if (!planes.isValid()) {
+        return renderGfxScope(accelerationFactor, QImage());
+    }
+    planes.toRgb(m_rgbImage);
+    return renderGfxScope(accelerationFactor, m_rgbImage);
+}
+
 void AbstractGfxScopeWidget::mouseReleaseEvent(QMouseEvent *event)
 {
     AbstractScopeWidget::mouseReleaseEvent(event);
@@ -45,6 +59,15 @@ void AbstractGfxScopeWidget::slotRenderZoneUpdated(const QImage &frame)
 {
     QMutexLocker lock(&m_mutex);
     m_scopeImage = frame;
+    m_scopeFrame = SharedFrame();
+    AbstractScopeWidget::slotRenderZoneUpdated();
+}
+
+void AbstractGfxScopeWidget::slotRenderZoneUpdated(const SharedFrame &frame)
+{
+    QMutexLocker lock(&m_mutex);
+    m_scopeFrame = frame;
+    m_scopeImage = QImage();
     AbstractScopeWidget::slotRenderZoneUpdated();
 }
 
@@ -16,6 +16,7 @@
 #include <QWidget>
 
 #include "../abstractscopewidget.h"
+#include "monitor/scopes/sharedframe.h"
 
 /**
 \brief Abstract class for scopes analyzing image frames.
@@ -36,12 +37,20 @@ protected:
         accelerationFactor hints how much faster than usual the calculation should be accomplished, if possible. */
     virtual QImage renderGfxScope(uint accelerationFactor, const QImage &) = 0;
 
+    /** @brief Scope renderer for frames received as yuv420p SharedFrame.
+        The default implementation converts the frame to RGB and calls renderGfxScope(),
+        scopes that can work on the YUV planes directly should reimplement it. */
+    virtual QImage renderYuvScope(uint accelerationFactor, const SharedFrame &frame);
+
     QImage renderScope(uint accelerationFactor) Q_DECL_OVERRIDE;
 
     void mouseReleaseEvent(QMouseEvent *) Q_DECL_OVERRIDE;
 
 private:
     QImage m_scopeImage;
+    SharedFrame m_scopeFrame;
+    /** @brief RGB conversion buffer of the default renderYuvScope() */
+    QImage m_rgbImage;
     QMutex m_mutex;
 
 public slots:
@@ -49,6 +58,8 @@ public slots:
       This slot must be connected in the implementing class, it is *not*
       done in this abstract class. */
     void slotRenderZoneUpdated(const QImage &);
+    /** @brief Same as above for a frame shown by the monitor, which is not copied. */
+    void slotRenderZoneUpdated(const SharedFrame &);
 
 protected slots:
     virtual void slotAutoRefreshToggled(bool autoRefresh);
@@ -10,6 +10,7 @@
 
 #include "histogram.h"
 #include "histogramgenerator.h"
+#include "scopekernels.h"
 #include <QTime>
 
 #include <KSharedConfig>
@@ -125,11 +126,7 @@ QImage Histogram::renderGfxScope(uint accelFactor, const QImage &qimage)
 {
     QTime start = QTime::currentTime();
     start.start();
-    const int componentFlags = (ui->cbY->isChecked() ? 1 : 0) * HistogramGenerator::ComponentY
-                               | (ui->cbS->isChecked() ? 1 : 0) * HistogramGenerator::ComponentSum
-                               | (ui->cbR->isChecked() ? 1 : 0) * HistogramGenerator::ComponentR
-                               | (ui->cbG->isChecked() ? 1 : 0) * HistogramGenerator::ComponentG
-                               | (ui->cbB->isChecked() ? 1 : 0) * HistogramGenerator::ComponentB;
+    const int componentFlags = components();
 
     HistogramGenerator::Rec rec = m_aRec601->isChecked() ? HistogramGenerator::Rec_601 : HistogramGenerator::Rec_709;
 
@@ -139,6 +136,27 @@ QImage Histogram::renderGfxScope(uint accelFactor, const QImage &qimage)
     emit signalScopeRenderingFinished(start.elapsed(), accelFactor);
     return histogram;
 }
+QImage Histogram::renderYuvScope(uint accelFactor, const SharedFrame &frame)
+{
+    QTime start = QTime::currentTime();
+    start.start();
+
+    QImage histogram = m_histogramGenerator->calculateHistogram(m_scopeRect.size(), YuvPlanes(frame), components(),
+                       m_aUnscaled->isChecked(), accelFactor);
+
+    emit signalScopeRenderingFinished(start.elapsed(), accelFactor);
+    return histogram;
+}
+
+int Histogram::components() const
+{
+    return (ui->cbY->isChecked() ? 1 : 0) * HistogramGenerator::ComponentY
+           | (ui->cbS->isChecked() ? 1 : 0) * HistogramGenerator::ComponentSum
+           | (ui->cbR->isChecked() ? 1 : 0) * HistogramGenerator::ComponentR
+           | (ui->cbG->isChecked() ? 1 : 0) * HistogramGenerator::ComponentG
+           | (ui->cbB->isChecked() ? 1 : 0) * HistogramGenerator::ComponentB;
+}
+
 QImage Histogram::renderBackground(uint)
 {
     emit signalBackgroundRenderingFinished(0, 1);
@@ -45,7 +45,10 @@ private:
     bool isBackgroundDependingOnInput() const Q_DECL_OVERRIDE;
     QImage renderHUD(uint accelerationFactor) Q_DECL_OVERRIDE;
     QImage renderGfxScope(uint accelerationFactor, const QImage &) Q_DECL_OVERRIDE;
+    QImage renderYuvScope(uint accelerationFactor, const SharedFrame &) Q_DECL_OVERRIDE;
     QImage renderBackground(uint accelerationFactor) Q_DECL_OVERRIDE;
+    /** @brief Returns the HistogramGenerator::Components flags of the checked components */
+    int components() const;
     Ui::Histogram_UI *ui;
 
 };
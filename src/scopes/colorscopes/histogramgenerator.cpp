@@ -9,11 +9,13 @@
  ***************************************************************************/
 
 #include "histogramgenerator.h"
+#include "scopekernels.h"
 
 #include <algorithm>
 #include <math.h>
 #include <QImage>
 #include <QPainter>
+#include <QVector>
 #include "klocalizedstring.h"
 
 HistogramGenerator::HistogramGenerator()
@@ -27,49 +29,91 @@ QImage HistogramGenerator::calculateHistogram(const QSize &paradeSize, const QIm
         return QImage();
     }
 
-    bool drawY = (components & HistogramGenerator::ComponentY) != 0;
-    bool drawR = (components & HistogramGenerator::ComponentR) != 0;
-    bool drawG = (components & HistogramGenerator::ComponentG) != 0;
-    bool drawB = (components & HistogramGenerator::ComponentB) != 0;
-    bool drawSum = (components & HistogramGenerator::ComponentSum) != 0;
+    const bool drawY = (components & HistogramGenerator::ComponentY) != 0;
 
-    int r[256], g[256], b[256], y[256], s[766];
+    int r[256], g[256], b[256], y[256];
     // Initialize the values to zero
     std::fill(r, r + 256, 0);
     std::fill(g, g + 256, 0);
     std::fill(b, b + 256, 0);
     std::fill(y, y + 256, 0);
-    std::fill(s, s + 766, 0);
-
-    const uint iw = image.bytesPerLine();
-    const uint ih = image.height();
-    const uint ww = paradeSize.width();
-    const uint wh = paradeSize.height();
-    const uint byteCount = iw * ih;
 
     // Read the stats from the input image
-    for (int Y = 0; Y < image.height(); ++Y) {
-        for (int X = 0; X < image.width(); X += accelFactor) {
-            QRgb col = image.pixel(X, Y);
-            r[qRed(col)]++;
-            g[qGreen(col)]++;
-            b[qBlue(col)]++;
-            if (drawY) {
-                // Use if branch to avoid expensive multiplication if Y disabled
-                if (rec == HistogramGenerator::Rec_601) {
-                    y[(int)floor(.299 * qRed(col) + .587 * qGreen(col) + .114 * qBlue(col))]++;
-                } else {
-                    y[(int)floor(.2125 * qRed(col) + .7154 * qGreen(col) + .0721 * qBlue(col))]++;
-                }
+    const QImage source = image.depth() == 32 ? image : image.convertToFormat(QImage::Format_RGB32);
+    const int width = source.width();
+    qint16 weights[3];
+    ScopeKernels::lumaWeights(rec == HistogramGenerator::Rec_709, weights);
+    QVector<uchar> luma(width);
+    for (int Y = 0; Y < source.height(); Y += accelFactor) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(source.constScanLine(Y));
+        ScopeKernels::countChannels(line, width, r, g, b);
+        if (drawY) {
+            // Skip the luma calculation if Y disabled
+            ScopeKernels::luma(line, width, weights, luma.data());
+            for (int X = 0; X < width; ++X) {
+                y[luma.at(X)]++;
             }
-            if (drawSum) {
-                // Use an if branch here because the sum takes more operations than rgb
-                s[qRed(col)]++;
-                s[qGreen(col)]++;
-                s[qBlue(col)]++;
+        }
+    }
+    return drawHistogram(paradeSize, r, g, b, y, components, unscaled, image.bytesPerLine() * image.height());
+}
+
+QImage HistogramGenerator::calculateHistogram(const QSize &paradeSize, const YuvPlanes &planes, const int &components,
+        bool unscaled, uint accelFactor) const
+{
+    if (paradeSize.height() <= 0 || paradeSize.width() <= 0 || !planes.isValid()) {
+        return QImage();
+    }
+
+    const bool drawY = (components & HistogramGenerator::ComponentY) != 0;
+    const bool drawRgb = (components & ~HistogramGenerator::ComponentY) != 0;
+
+    int r[256], g[256], b[256], y[256];
+    std::fill(r, r + 256, 0);
+    std::fill(g, g + 256, 0);
+    std::fill(b, b + 256, 0);
+    std::fill(y, y + 256, 0);
+
+    // Luma is read from the Y plane, RGB is only computed if one of its components is drawn
+    uchar lumaTable[256];
+    ScopeKernels::studioLumaTable(lumaTable);
+    const int width = planes.width();
+    QVector<QRgb> rgb(width);
+    for (int Y = 0; Y < planes.height(); Y += accelFactor) {
+        if (drawRgb) {
+            ScopeKernels::yuvToRgb(planes.yLine(Y), planes.uLine(Y), planes.vLine(Y), width, planes.isRec709(), rgb.data());
+            ScopeKernels::countChannels(rgb.constData(), width, r, g, b);
+        }
+        if (drawY) {
+            const uchar *line = planes.yLine(Y);
+            for (int X = 0; X < width; ++X) {
+                y[lumaTable[line[X]]]++;
             }
         }
     }
+    // Scale like a 32 bit image of the same size
+    return drawHistogram(paradeSize, r, g, b, y, components, unscaled, width * 4 * planes.height());
+}
+
+QImage HistogramGenerator::drawHistogram(const QSize &paradeSize, const int *r, const int *g, const int *b, const int *y,
+        int components, bool unscaled, uint byteCount) const
+{
+    bool drawY = (components & HistogramGenerator::ComponentY) != 0;
+    bool drawR = (components & HistogramGenerator::ComponentR) != 0;
+    bool drawG = (components & HistogramGenerator::ComponentG) != 0;
+    bool drawB = (components & HistogramGenerator::ComponentB) != 0;
+    bool drawSum = (components & HistogramGenerator::ComponentSum) != 0;
+
+    const uint ww = paradeSize.width();
+    const uint wh = paradeSize.height();
+
+    int s[766];
+    std::fill(s, s + 766, 0);
+    if (drawSum) {
+        for (int i = 0; i < 256; ++i) {
+            s[i] = r[i] + g[i] + b[i];
+        }
+    }
 
     const int nParts = (drawY ? 1 : 0) + (drawR ? 1 : 0) + (drawG ? 1 : 0) + (drawB ? 1 : 0) + (drawSum ? 1 : 0);
     if (nParts == 0) {
@@ -18,6 +18,7 @@ class QImage;
 class QPainter;
 class QRect;
 class QSize;
+class YuvPlanes;
 
 class HistogramGenerator : public QObject
 {
@@ -35,6 +36,9 @@ public:
         unscaled = true leaves the width at 256 if the widget is wider (to avoid scaling). */
     QImage calculateHistogram(const QSize &paradeSize, const QImage &image, const int &components, const HistogramGenerator::Rec rec,
                               bool unscaled, uint accelFactor = 1) const;
+    /** Same as above for a yuv420p frame, the luma is read from the Y plane. */
+    QImage calculateHistogram(const QSize &paradeSize, const YuvPlanes &planes, const int &components,
+                              bool unscaled, uint accelFactor = 1) const;
 
     QImage drawComponent(const int *y, const QSize &size, const float &scaling, const QColor &color, bool unscaled, uint max) const;
 
@@ -43,6 +47,11 @@ public:
 
     enum Components { ComponentY = 1 << 0, ComponentR = 1 << 1, ComponentG = 1 << 2, ComponentB = 1 << 3, ComponentSum = 1 << 4 };
 
+private:
+    /** Paints the histogram of the given component counts, byteCount is the size of the analysed 32 bit image. */
+    QImage drawHistogram(const QSize &paradeSize, const int *r, const int *g, const int *b, const int *y,
+                         int components, bool unscaled, uint byteCount) const;
+
 };
 
 #endif // HISTOGRAMGENERATOR_H
@@ -12,6 +12,7 @@
 #include "klocalizedstring.h"
 #include <QColor>
 #include <QPainter>
+#include <QVector>
 
 #define CHOP255(a) ((255) < (a) ? (255) : (a))
 #define CHOP1255(a) ((a) < (1) ? (1) : ((a) > (255) ? (255) : (a)))
@@ -23,12 +24,6 @@ const QColor RGBParadeGenerator::colSoft(150, 150, 150, 255);
 const uchar RGBParadeGenerator::distRight(40);
 const uchar RGBParadeGenerator::distBottom(40);
 
-struct StructRGB {
-    uint r;
-    uint g;
-    uint b;
-};
-
 RGBParadeGenerator::RGBParadeGenerator()
 {
 }
@@ -48,99 +43,87 @@ QImage RGBParadeGenerator::calculateRGBParade(const QSize &paradeSize, const QIm
 
         QPainter davinci(&parade);
 
+        const QImage source = image.depth() == 32 ? image : image.convertToFormat(QImage::Format_RGB32);
         const uint ww = paradeSize.width();
         const uint wh = paradeSize.height();
-        const uint iw = image.bytesPerLine();
-        const uint ih = image.height();
-        const uint byteCount = iw * ih; // Note that 1 px = 4 B
+        const int iw = source.width();
+        const int ih = source.height();
 
         const uchar offset = 10;
-        const uint partW = (ww - 2 * offset - distRight) / 3;
+        const int partW = ((int) ww - 2 * offset - distRight) / 3;
         const uint partH = wh - distBottom;
+        if (partW <= 0 || (int) wh <= distBottom) {
+            return parade;
+        }
 
         // Statistics
-        uchar minR = 255, minG = 255, minB = 255, maxR = 0, maxG = 0, maxB = 0, r, g, b;
+        int minR = 255, minG = 255, minB = 255, maxR = 0, maxG = 0, maxB = 0;
 
         // Number of input pixels that will fall on one scope pixel.
         // Must be a float because the acceleration factor can be high, leading to <1 expected px per px.
-        const float pixelDepth = (float)((byteCount >> 2) / accelFactor) / (partW * 255);
+        const float pixelDepth = (float)(iw * ih / accelFactor) / (partW * 255);
         const float gain = 255 / (8 * pixelDepth);
 //        qCDebug(KDENLIVE_LOG) << "Pixel depth: expected " << pixelDepth << "; Gain: using " << gain << " (acceleration: " << accelFactor << "x)";
 
         QImage unscaled(ww - distRight, 256, QImage::Format_ARGB32);
         unscaled.fill(qRgba(0, 0, 0, 0));
 
-        const float wPrediv = (float)(partW - 1) / (iw - 1);
-
-        StructRGB paradeVals[partW][256];
-        for (uint i = 0; i < partW; ++i) {
-            for (uint j = 0; j < 256; ++j) {
-                paradeVals[i][j].r = 0;
-                paradeVals[i][j].g = 0;
-                paradeVals[i][j].b = 0;
-            }
+        // Parade column of each image column
+        QVector<int> columns(iw);
+        for (int x = 0; x < iw; ++x) {
+            columns[x] = iw > 1 ? x * (partW - 1) / (iw - 1) : 0;
         }
 
-        const uchar *bits = image.bits();
-        const uint stepsize = image.depth() / 8 * accelFactor;
-
-        for (uint i = 0, x = 0; i < byteCount; i += stepsize) {
-            QRgb *col = (QRgb *)bits;
-            r = qRed(*col);
-            g = qGreen(*col);
-            b = qBlue(*col);
-
-            double dx = x * wPrediv;
-
-            paradeVals[(int)dx][r].r++;
-            paradeVals[(int)dx][g].g++;
-            paradeVals[(int)dx][b].b++;
-
-            if (r < minR) {
-                minR = r;
-            }
-            if (g < minG) {
-                minG = g;
+        // Hit counts, one row of partW values per level
+        QVector<uint> paradeR(partW * 256, 0);
+        QVector<uint> paradeG(partW * 256, 0);
+        QVector<uint> paradeB(partW * 256, 0);
+        uint *valuesR = paradeR.data();
+        uint *valuesG = paradeG.data();
+        uint *valuesB = paradeB.data();
+
+        for (int y = 0; y < ih; y += accelFactor) {
+            const QRgb *line = reinterpret_cast<const QRgb *>(source.constScanLine(y));
+            for (int x = 0; x < iw; ++x) {
+                const QRgb px = line[x];
+                const int column = columns.at(x);
+                valuesR[qRed(px) * partW + column]++;
+                valuesG[qGreen(px) * partW + column]++;
+                valuesB[qBlue(px) * partW + column]++;
             }
-            if (b < minB) {
-                minB = b;
-            }
-            if (r > maxR) {
-                maxR = r;
-            }
-            if (g > maxG) {
-                maxG = g;
-            }
-            if (b > maxB) {
-                maxB = b;
-            }
-
-            bits += stepsize;
-            x += stepsize;
-            x %= iw; // Modulo image width, to represent the current x position in the image
         }
 
         const uint offset1 = partW + offset;
         const uint offset2 = 2 * partW + 2 * offset;
-        switch (paintMode) {
-        case PaintMode_RGB:
-            for (uint i = 0; i < partW; ++i) {
-                for (uint j = 0; j < 256; ++j) {
-                    unscaled.setPixel(i,         j, qRgba(255, 10, 10, CHOP255(gain * paradeVals[i][j].r)));
-                    unscaled.setPixel(i + offset1, j, qRgba(10, 255, 10, CHOP255(gain * paradeVals[i][j].g)));
-                    unscaled.setPixel(i + offset2, j, qRgba(10, 10, 255, CHOP255(gain * paradeVals[i][j].b)));
-                }
+        const QRgb colR = paintMode == PaintMode_RGB ? qRgb(255, 10, 10) : qRgb(255, 255, 255);
+        const QRgb colG = paintMode == PaintMode_RGB ? qRgb(10, 255, 10) : qRgb(255, 255, 255);
+        const QRgb colB = paintMode == PaintMode_RGB ? qRgb(10, 10, 255) : qRgb(255, 255, 255);
+        for (int j = 0; j < 256; ++j) {
+            const uint *rowR = valuesR + j * partW;
+            const uint *rowG = valuesG + j * partW;
+            const uint *rowB = valuesB + j * partW;
+            QRgb *line = reinterpret_cast<QRgb *>(unscaled.scanLine(j));
+            bool hasR = false, hasG = false, hasB = false;
+            for (int i = 0; i < partW; ++i) {
+                hasR |= rowR[i] > 0;
+                hasG |= rowG[i] > 0;
+                hasB |= rowB[i] > 0;
+                line[i] = (colR & RGB_MASK) | ((uint) CHOP255(gain * rowR[i]) << 24);
+                line[i + offset1] = (colG & RGB_MASK) | ((uint) CHOP255(gain * rowG[i]) << 24);
+                line[i + offset2] = (colB & RGB_MASK) | ((uint) CHOP255(gain * rowB[i]) << 24);
             }
-            break;
-        default:
-            for (uint i = 0; i < partW; ++i) {
-                for (uint j = 0; j < 256; ++j) {
-                    unscaled.setPixel(i,         j, qRgba(255, 255, 255, CHOP255(gain * paradeVals[i][j].r)));
-                    unscaled.setPixel(i + offset1, j, qRgba(255, 255, 255, CHOP255(gain * paradeVals[i][j].g)));
-                    unscaled.setPixel(i + offset2, j, qRgba(255, 255, 255, CHOP255(gain * paradeVals[i][j].b)));
-                }
+            if (hasR) {
+                minR = qMin(minR, j);
+                maxR = j;
+            }
+            if (hasG) {
+                minG = qMin(minG, j);
+                maxG = j;
+            }
+            if (hasB) {
+                minB = qMin(minB, j);
+                maxB = j;
             }
-            break;
         }
 
         // Scale the image to the target height. Scaling is not accomplished before because
@@ -151,11 +134,10 @@ QImage RGBParadeGenerator::calculateRGBParade(const QSize &paradeSize, const QIm
         if (drawAxis) {
             QRgb opx;
             for (uint i = 0; i <= 10; ++i) {
-                double dy = (float)i / 10 * (partH - 1);
+                QRgb *line = reinterpret_cast<QRgb *>(parade.scanLine((float)i / 10 * (partH - 1)));
                 for (uint x = 0; x < ww - distRight; ++x) {
-                    opx = parade.pixel(x, dy);
-                    parade.setPixel(x, dy, qRgba(CHOP255(150 + qRed(opx)), 255,
-                                                 CHOP255(200 + qBlue(opx)), CHOP255(32 + qAlpha(opx))));
+                    opx = line[x];
+                    line[x] = qRgba(CHOP255(150 + qRed(opx)), 255, CHOP255(200 + qBlue(opx)), CHOP255(32 + qAlpha(opx)));
                 }
             }
         }
@@ -0,0 +1,190 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent (agent@local)                             *
+ *   This file is part of kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include "scopekernels.h"
+#include "monitor/scopes/sharedframe.h"
+
+#include <QImage>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+// QRgb pixels are stored as B, G, R, A bytes on x86 (little endian).
+// Returns the weighted sums of the 4 pixels at line.
+static inline __m128i weightedSum4(const QRgb *line, const __m128i &weights)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(line));
+    // [B0*wb + G0*wg, R0*wr, B1*wb + G1*wg, R1*wr]
+    __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(px, zero), weights);
+    __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(px, zero), weights);
+    // Add the pairs, results are in lanes 0 and 2
+    lo = _mm_add_epi32(lo, _mm_srli_epi64(lo, 32));
+    hi = _mm_add_epi32(hi, _mm_srli_epi64(hi, 32));
+    return _mm_unpacklo_epi64(_mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 2, 0)), _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 2, 0)));
+}
+#endif
+
+void ScopeKernels::lumaWeights(bool rec709, qint16 weights[3])
+{
+    // Weights sum up to 1 << lumaShift, so that white gives 255
+    if (rec709) {
+        weights[0] = 6963;
+        weights[1] = 23442;
+        weights[2] = 2363;
+    } else {
+        weights[0] = 9798;
+        weights[1] = 19235;
+        weights[2] = 3735;
+    }
+}
+
+void ScopeKernels::weightedSum(const QRgb *line, int width, const qint16 weights[3], qint32 *out)
+{
+    int x = 0;
+#ifdef __SSE2__
+    const __m128i w = _mm_set_epi16(0, weights[0], weights[1], weights[2], 0, weights[0], weights[1], weights[2]);
+    for (; x + 4 <= width; x += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), weightedSum4(line + x, w));
+    }
+#endif
+    for (; x < width; ++x) {
+        out[x] = weights[0] * qRed(line[x]) + weights[1] * qGreen(line[x]) + weights[2] * qBlue(line[x]);
+    }
+}
+
+void ScopeKernels::luma(const QRgb *line, int width, const qint16 weights[3], uchar *out)
+{
+    int x = 0;
+#ifdef __SSE2__
+    const __m128i w = _mm_set_epi16(0, weights[0], weights[1], weights[2], 0, weights[0], weights[1], weights[2]);
+    for (; x + 8 <= width; x += 8) {
+        const __m128i y0 = _mm_srli_epi32(weightedSum4(line + x, w), lumaShift);
+        const __m128i y1 = _mm_srli_epi32(weightedSum4(line + x + 4, w), lumaShift);
+        // Values are on [0, 255], saturated packing is lossless
+        const __m128i y16 = _mm_packs_epi32(y0, y1);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + x), _mm_packus_epi16(y16, y16));
+    }
+#endif
+    for (; x < width; ++x) {
+        out[x] = (weights[0] * qRed(line[x]) + weights[1] * qGreen(line[x]) + weights[2] * qBlue(line[x])) >> lumaShift;
+    }
+}
+
+void ScopeKernels::countChannels(const QRgb *line, int width, int *r, int *g, int *b)
+{
+    // Scattered increments cannot be vectorized, but reading the scanline
+    // directly is much cheaper than going through QImage::pixel()
+    for (int x = 0; x < width; ++x) {
+        const QRgb px = line[x];
+        r[qRed(px)]++;
+        g[qGreen(px)]++;
+        b[qBlue(px)]++;
+    }
+}
+
+void ScopeKernels::yuvToRgb(const uchar *y, const uchar *u, const uchar *v, int width, bool rec709, QRgb *out)
+{
+    // Shader coefficients on 16 bits
+    const int cy = 76304;
+    const int crv = rec709 ? 117506 : 104582;
+    const int cgu = rec709 ? 13959 : 25672;
+    const int cgv = rec709 ? 34931 : 53274;
+    const int cbu = rec709 ? 138412 : 132186;
+    const int chromaWidth = width / 2;
+    for (int x = 0; x < width; ++x) {
+        // The last column of an odd width frame has no chroma sample of its own
+        const int c = qMin(x >> 1, chromaWidth - 1);
+        const int yy = cy * (y[x] - 16) + (1 << 15);
+        const int uu = u[c] - 128;
+        const int vv = v[c] - 128;
+        const int r = (yy + crv * vv) >> 16;
+        const int g = (yy - cgu * uu - cgv * vv) >> 16;
+        const int b = (yy + cbu * uu) >> 16;
+        out[x] = qRgb(qBound(0, r, 255), qBound(0, g, 255), qBound(0, b, 255));
+    }
+}
+
+void ScopeKernels::studioLumaTable(uchar table[256])
+{
+    for (int i = 0; i < 256; ++i) {
+        table[i] = qBound(0, ((i - 16) * 255 + 109) / 219, 255);
+    }
+}
+
+YuvPlanes::YuvPlanes(const SharedFrame &frame)
+    : m_y(nullptr)
+    , m_u(nullptr)
+    , m_v(nullptr)
+    , m_width(0)
+    , m_height(0)
+    , m_rec709(false)
+{
+    if (!frame.is_valid() || frame.get_image_format() != mlt_image_yuv420p) {
+        return;
+    }
+    m_width = frame.get_image_width();
+    m_height = frame.get_image_height();
+    // Same plane layout as the monitor textures
+    m_y = frame.get_image();
+    if (m_y == nullptr || m_width < 2 || m_height < 2) {
+        m_y = nullptr;
+        return;
+    }
+    m_u = m_y + m_width * m_height;
+    m_v = m_u + (m_width / 2) * (m_height / 2);
+    const int colorspace = frame.get_int("colorspace");
+    m_rec709 = colorspace == 0 ? m_height > 576 : colorspace != 601;
+}
+
+bool YuvPlanes::isValid() const
+{
+    return m_y != nullptr;
+}
+
+int YuvPlanes::width() const
+{
+    return m_width;
+}
+
+int YuvPlanes::height() const
+{
+    return m_height;
+}
+
+bool YuvPlanes::isRec709() const
+{
+    return m_rec709;
+}
+
+const uchar *YuvPlanes::yLine(int row) const
+{
+    return m_y + row * m_width;
+}
+
+const uchar *YuvPlanes::uLine(int row) const
+{
+    return m_u + qMin(row / 2, m_height / 2 - 1) * (m_width / 2);
+}
+
+const uchar *YuvPlanes::vLine(int row) const
+{
+    return m_v + qMin(row / 2, m_height / 2 - 1) * (m_width / 2);
+}
+
+void YuvPlanes::toRgb(QImage &image) const
+{
+    if (image.width() != m_width || image.height() != m_height || image.format() != QImage::Format_RGB32) {
+        image = QImage(m_width, m_height, QImage::Format_RGB32);
+    }
+    for (int row = 0; row < m_height; ++row) {
+        ScopeKernels::yuvToRgb(yLine(row), uLine(row), vLine(row), m_width, m_rec709, reinterpret_cast<QRgb *>(image.scanLine(row)));
+    }
+}
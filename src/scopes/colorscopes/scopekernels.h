@@ -0,0 +1,85 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent (agent@local)                             *
+ *   This file is part of kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#ifndef SCOPEKERNELS_H
+#define SCOPEKERNELS_H
+
+#include <QRgb>
+
+class QImage;
+class SharedFrame;
+
+/**
+  Per scanline pixel kernels shared by the color scopes.
+
+  All kernels work on 32 bit (A)RGB scanlines and use integer arithmetic.
+  On x86 they process 4 pixels at once with SSE2 (which is always available
+  on x86-64), other architectures use the scalar version.
+ */
+class ScopeKernels
+{
+public:
+    /** Fixed point precision of the luma weights. */
+    static const int lumaShift = 15;
+
+    /** @brief Returns the Rec. 601 (or Rec. 709 if rec709 is true) luma weights for R, G and B, on lumaShift bits */
+    static void lumaWeights(bool rec709, qint16 weights[3]);
+
+    /** @brief Computes weights[0] * R + weights[1] * G + weights[2] * B for width pixels of line (weights may be negative) */
+    static void weightedSum(const QRgb *line, int width, const qint16 weights[3], qint32 *out);
+
+    /** @brief Computes the 8 bit luma of width pixels of line (weights from lumaWeights()) */
+    static void luma(const QRgb *line, int width, const qint16 weights[3], uchar *out);
+
+    /** @brief Adds width pixels of line to the red, green and blue histograms (256 values each) */
+    static void countChannels(const QRgb *line, int width, int *r, int *g, int *b);
+
+    /** @brief Converts width pixels of a yuv420p row to RGB, with the same studio range
+        conversion as the monitor shader. u and v hold one sample for two pixels, width must be at least 2. */
+    static void yuvToRgb(const uchar *y, const uchar *u, const uchar *v, int width, bool rec709, QRgb *out);
+
+    /** @brief Fills table with the full range (0 to 255) value of each studio range luma value */
+    static void studioLumaTable(uchar table[256]);
+};
+
+/**
+  Read only access to the planes of a yuv420p SharedFrame, so that the scopes
+  can analyse the frames displayed by the monitor without converting them.
+  The frame must be kept alive while the planes are used.
+ */
+class YuvPlanes
+{
+public:
+    explicit YuvPlanes(const SharedFrame &frame);
+
+    /** @brief Returns false if the frame does not hold a yuv420p image */
+    bool isValid() const;
+    int width() const;
+    int height() const;
+    /** @brief True if the frame uses the Rec. 709 color space, false for Rec. 601 */
+    bool isRec709() const;
+
+    const uchar *yLine(int row) const;
+    const uchar *uLine(int row) const;
+    const uchar *vLine(int row) const;
+
+    /** @brief Converts the whole frame to RGB32, reusing the buffer of image if it has the right size */
+    void toRgb(QImage &image) const;
+
+private:
+    const uchar *m_y;
+    const uchar *m_u;
+    const uchar *m_v;
+    int m_width;
+    int m_height;
+    bool m_rec709;
+};
+
+#endif // SCOPEKERNELS_H
@@ -64,8 +64,10 @@ mRgb2YPbPr =                        r =
  */
 
 #include "vectorscopegenerator.h"
+#include "scopekernels.h"
 #include <math.h>
 #include <QImage>
+#include <QVector>
 
 // The maximum distance from the center for any RGB color is 0.63, so
 // no need to make the circle bigger than required.
@@ -73,6 +75,12 @@ const float SCALING = 1 / .7;
 
 const float VectorscopeGenerator::scaling = 1 / .7;
 
+// U and V weights of R, G and B for both color spaces
+static const double yuvU[3] = { -0.0005781, -0.001135, 0.001713 };
+static const double yuvV[3] = { 0.002411, -0.002019, -0.0003921 };
+static const double ypbprU[3] = { -0.0006671, -0.001299, 0.0019608 };
+static const double ypbprV[3] = { 0.001961, -0.001642, -0.0003189 };
+
 /**
   Input point is on [-1,1]², 0 being at the center,
   and positive directions are →top/→right.
@@ -124,47 +132,56 @@ QImage VectorscopeGenerator::calculateVectorscope(const QSize &vectorscopeSize,
     QImage scope = QImage(cw, cw, QImage::Format_ARGB32);
     scope.fill(qRgba(0, 0, 0, 0));
 
-    const uchar *bits = image.bits();
+    const QImage source = image.depth() == 32 ? image : image.convertToFormat(QImage::Format_RGB32);
+    const int iw = source.width();
 
     double dy, dr, dg, db, dmax;
     double /*y,*/ u, v;
-    QPoint pt;
     QRgb px;
 
-    const int stepsize = image.depth() / 8 * accelFactor;
-
     // Just an average for the number of image pixels per scope pixel.
-    // NOTE: byteCount() has to be replaced by (img.bytesPerLine()*img.height()) for Qt 4.5 to compile, see: http://doc.trolltech.org/4.6/qimage.html#bytesPerLine
-    double avgPxPerPx = (double) image.depth() / 8 * (image.bytesPerLine() * image.height()) / scope.size().width() / scope.size().height() / accelFactor;
-
-    for (int i = 0; i < (image.bytesPerLine()*image.height()); i += stepsize) {
-        QRgb *col = (QRgb *) bits;
-
-        int r = qRed(*col);
-        int g = qGreen(*col);
-        int b = qBlue(*col);
-
-        switch (colorSpace) {
-        case VectorscopeGenerator::ColorSpace_YUV:
-//             y = (double)  0.001173 * r +0.002302 * g +0.0004471* b;
-            u = (double) - 0.0005781 * r - 0.001135 * g + 0.001713 * b;
-            v = (double)  0.002411 * r - 0.002019 * g - 0.0003921 * b;
-            break;
-        case VectorscopeGenerator::ColorSpace_YPbPr:
-        default:
-//             y = (double)  0.001173 * r +0.002302 * g +0.0004471* b;
-            u = (double) - 0.0006671 * r - 0.001299 * g + 0.0019608 * b;
-            v = (double)  0.001961 * r - 0.001642 * g - 0.0003189 * b;
-            break;
-        }
-
-        pt = mapToCircle(vectorscopeSize, QPointF(SCALING * gain * u, SCALING * gain * v));
-
-        if (pt.x() >= scope.width() || pt.x() < 0
-                || pt.y() >= scope.height() || pt.y() < 0) {
-            // Point lies outside (because of scaling), don't plot it
-
-        } else {
+    double avgPxPerPx = (double) source.depth() / 8 * (source.bytesPerLine() * source.height()) / scope.size().width() / scope.size().height() / accelFactor;
+
+    // Chroma weights on chromaShift bits
+    const int chromaShift = 22;
+    const double *uCoeffs = colorSpace == VectorscopeGenerator::ColorSpace_YUV ? yuvU : ypbprU;
+    const double *vCoeffs = colorSpace == VectorscopeGenerator::ColorSpace_YUV ? yuvV : ypbprV;
+    qint16 uWeights[3];
+    qint16 vWeights[3];
+    for (int i = 0; i < 3; ++i) {
+        uWeights[i] = qRound(uCoeffs[i] * (1 << chromaShift));
+        vWeights[i] = qRound(vCoeffs[i] * (1 << chromaShift));
+    }
+    const double chromaScale = 1.0 / (1 << chromaShift);
+
+    // Same mapping as mapToCircle(), applied to the fixed point chroma values
+    const double ax = (vectorscopeSize.width() - 1) * SCALING * gain * chromaScale / 2;
+    const double bx = (double)(vectorscopeSize.width() - 1) / 2;
+    const double ay = (vectorscopeSize.height() - 1) * SCALING * gain * chromaScale / 2;
+    const double by = (double)(vectorscopeSize.height() - 1) / 2;
+
+    QRgb *scopeBits = reinterpret_cast<QRgb *>(scope.bits());
+    const int scopeStride = scope.bytesPerLine() / 4;
+    QVector<qint32> uValues(iw);
+    QVector<qint32> vValues(iw);
+
+    for (int y = 0; y < source.height(); y += accelFactor) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(source.constScanLine(y));
+        ScopeKernels::weightedSum(line, iw, uWeights, uValues.data());
+        ScopeKernels::weightedSum(line, iw, vWeights, vValues.data());
+
+        for (int x = 0; x < iw; ++x) {
+            const int ptX = ax * uValues.at(x) + bx;
+            const int ptY = by - ay * vValues.at(x);
+
+            if (ptX >= scope.width() || ptX < 0
+                    || ptY >= scope.height() || ptY < 0) {
+                // Point lies outside (because of scaling), don't plot it
+                continue;
+            }
+            QRgb *target = scopeBits + ptY * scopeStride + ptX;
+            u = uValues.at(x) * chromaScale;
+            v = vValues.at(x) * chromaScale;
 
             // Draw the pixel using the chosen draw mode.
             switch (paintMode) {
@@ -206,7 +223,7 @@ QImage VectorscopeGenerator::calculateVectorscope(const QSize &vectorscopeSize,
                     db = 255;
                 }
 
-                scope.setPixel(pt, qRgba(dr, dg, db, 255));
+                *target = qRgba(dr, dg, db, 255);
                 break;
 
             case PaintMode_Chroma:
@@ -241,29 +258,27 @@ QImage VectorscopeGenerator::calculateVectorscope(const QSize &vectorscopeSize,
                 dg *= dmax;
                 db *= dmax;
 
-                scope.setPixel(pt, qRgba(dr, dg, db, 255));
+                *target = qRgba(dr, dg, db, 255);
                 break;
             case PaintMode_Original:
-                scope.setPixel(pt, *col);
+                *target = line[x];
                 break;
             case PaintMode_Green:
-                px = scope.pixel(pt);
-                scope.setPixel(pt, qRgba(qRed(px) + (255 - qRed(px)) / (3 * avgPxPerPx), qGreen(px) + 20 * (255 - qGreen(px)) / (avgPxPerPx),
-                                         qBlue(px) + (255 - qBlue(px)) / (avgPxPerPx), qAlpha(px) + (255 - qAlpha(px)) / (avgPxPerPx)));
+                px = *target;
+                *target = qRgba(qRed(px) + (255 - qRed(px)) / (3 * avgPxPerPx), qGreen(px) + 20 * (255 - qGreen(px)) / (avgPxPerPx),
+                                qBlue(px) + (255 - qBlue(px)) / (avgPxPerPx), qAlpha(px) + (255 - qAlpha(px)) / (avgPxPerPx));
                 break;
             case PaintMode_Green2:
-                px = scope.pixel(pt);
-                scope.setPixel(pt, qRgba(qRed(px) + ceil((255 - (float)qRed(px)) / (4 * avgPxPerPx)), 255,
-                                         qBlue(px) + ceil((255 - (float)qBlue(px)) / (avgPxPerPx)), qAlpha(px) + ceil((255 - (float)qAlpha(px)) / (avgPxPerPx))));
+                px = *target;
+                *target = qRgba(qRed(px) + ceil((255 - (float)qRed(px)) / (4 * avgPxPerPx)), 255,
+                                qBlue(px) + ceil((255 - (float)qBlue(px)) / (avgPxPerPx)), qAlpha(px) + ceil((255 - (float)qAlpha(px)) / (avgPxPerPx)));
                 break;
             case PaintMode_Black:
-                px = scope.pixel(pt);
-                scope.setPixel(pt, qRgba(0, 0, 0, qAlpha(px) + (255 - qAlpha(px)) / 20));
+                px = *target;
+                *target = qRgba(0, 0, 0, qAlpha(px) + (255 - qAlpha(px)) / 20);
                 break;
             }
         }
-
-        bits += stepsize;
     }
     return scope;
 }
@@ -10,6 +10,7 @@
 
 #include "waveform.h"
 #include "waveformgenerator.h"
+#include "scopekernels.h"
 // For reading out the project resolution
 #include "kdenlivesettings.h"
 #include "dialogs/profilesdialog.h"
@@ -188,7 +189,32 @@ QImage Waveform::renderGfxScope(uint accelFactor, const QImage &qimage)
     QImage wave = m_waveformGenerator->calculateWaveform(scopeRect().size() - m_textWidth - QSize(0, m_paddingBottom), qimage,
                   (WaveformGenerator::PaintMode) paintmode, true, rec, accelFactor);
 
-    emit signalScopeRenderingFinished(start.elapsed(), 1);
+    emit signalScopeRenderingFinished(start.elapsed(), accelFactor);
+    return wave;
+}
+
+QImage Waveform::renderYuvScope(uint accelFactor, const SharedFrame &frame)
+{
+    QTime start = QTime::currentTime();
+    start.start();
+
+    const YuvPlanes planes(frame);
+    if (!planes.isValid()) {
+        return renderGfxScope(accelFactor, QImage());
+    }
+    const int paintmode = ui->paintMode->itemData(ui->paintMode->currentIndex()).toInt();
+    WaveformGenerator::Rec rec = m_aRec601->isChecked() ? WaveformGenerator::Rec_601 : WaveformGenerator::Rec_709;
+    const QSize size = scopeRect().size() - m_textWidth - QSize(0, m_paddingBottom);
+    QImage wave;
+    if (planes.isRec709() == (rec == WaveformGenerator::Rec_709)) {
+        // The Y plane already holds the luma of the selected matrix
+        wave = m_waveformGenerator->calculateWaveform(size, planes, (WaveformGenerator::PaintMode) paintmode, true, accelFactor);
+    } else {
+        planes.toRgb(m_rgbFrame);
+        wave = m_waveformGenerator->calculateWaveform(size, m_rgbFrame, (WaveformGenerator::PaintMode) paintmode, true, rec, accelFactor);
+    }
+
+    emit signalScopeRenderingFinished(start.elapsed(), accelFactor);
     return wave;
 }
 
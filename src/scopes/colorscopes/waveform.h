@@ -49,11 +49,14 @@ private:
     static const int m_paddingBottom;
 
     QImage m_waveform;
+    /** @brief RGB conversion buffer, used when the frame matrix is not the selected one */
+    QImage m_rgbFrame;
 
     /// Implemented methods ///
     QRect scopeRect() Q_DECL_OVERRIDE;
     QImage renderHUD(uint) Q_DECL_OVERRIDE;
     QImage renderGfxScope(uint, const QImage &) Q_DECL_OVERRIDE;
+    QImage renderYuvScope(uint, const SharedFrame &) Q_DECL_OVERRIDE;
     QImage renderBackground(uint) Q_DECL_OVERRIDE;
     bool isHUDDependingOnInput() const Q_DECL_OVERRIDE;
     bool isScopeDependingOnInput() const Q_DECL_OVERRIDE;
@@ -9,13 +9,14 @@
  ***************************************************************************/
 
 #include "waveformgenerator.h"
+#include "scopekernels.h"
 
 #include <cmath>
 
 #include <QImage>
-#include <QPainter>
 #include <QSize>
 #include <QTime>
+#include <QVector>
 
 #define CHOP255(a) ((255) < (a) ? (255) : (a))
 
@@ -29,6 +30,43 @@ WaveformGenerator::~WaveformGenerator()
 
 QImage WaveformGenerator::calculateWaveform(const QSize &waveformSize, const QImage &image, WaveformGenerator::PaintMode paintMode,
         bool drawAxis, WaveformGenerator::Rec rec, uint accelFactor)
+{
+    if (image.width() <= 0 || image.height() <= 0) {
+        return QImage();
+    }
+    const QImage source = image.depth() == 32 ? image : image.convertToFormat(QImage::Format_RGB32);
+    const int iw = source.width();
+    qint16 weights[3];
+    ScopeKernels::lumaWeights(rec == WaveformGenerator::Rec_709, weights);
+    QVector<uchar> luma(iw);
+    return paintWaveform(waveformSize, iw, source.height(), paintMode, drawAxis, accelFactor, [&](int y) {
+        ScopeKernels::luma(reinterpret_cast<const QRgb *>(source.constScanLine(y)), iw, weights, luma.data());
+        return luma.constData();
+    });
+}
+
+QImage WaveformGenerator::calculateWaveform(const QSize &waveformSize, const YuvPlanes &planes, WaveformGenerator::PaintMode paintMode,
+        bool drawAxis, uint accelFactor)
+{
+    if (!planes.isValid()) {
+        return QImage();
+    }
+    // The Y plane already is the luma, only scale it to the full range
+    uchar lumaTable[256];
+    ScopeKernels::studioLumaTable(lumaTable);
+    const int iw = planes.width();
+    QVector<uchar> luma(iw);
+    return paintWaveform(waveformSize, iw, planes.height(), paintMode, drawAxis, accelFactor, [&](int y) {
+        const uchar *line = planes.yLine(y);
+        for (int x = 0; x < iw; ++x) {
+            luma[x] = lumaTable[line[x]];
+        }
+        return luma.constData();
+    });
+}
+
+QImage WaveformGenerator::paintWaveform(const QSize &waveformSize, int iw, int ih, WaveformGenerator::PaintMode paintMode,
+        bool drawAxis, uint accelFactor, const std::function<const uchar *(int)> &lumaLine)
 {
     Q_ASSERT(accelFactor >= 1);
 
@@ -37,7 +75,7 @@ QImage WaveformGenerator::calculateWaveform(const QSize &waveformSize, const QIm
 
     QImage wave(waveformSize, QImage::Format_ARGB32);
 
-    if (waveformSize.width() <= 0 || waveformSize.height() <= 0 || image.width() <= 0 || image.height() <= 0) {
+    if (waveformSize.width() <= 0 || waveformSize.height() <= 0 || iw <= 0 || ih <= 0) {
         return QImage();
 
     } else {
@@ -45,103 +83,74 @@ QImage WaveformGenerator::calculateWaveform(const QSize &waveformSize, const QIm
         // Fill with transparent color
         wave.fill(qRgba(0, 0, 0, 0));
 
-        const uint ww = waveformSize.width();
-        const uint wh = waveformSize.height();
-        const uint iw = image.bytesPerLine();
-        const uint ih = image.height();
-        const uint byteCount = iw * ih;
+        const int ww = waveformSize.width();
+        const int wh = waveformSize.height();
 
-        uint waveValues[waveformSize.width()][waveformSize.height()];
-        for (int i = 0; i < waveformSize.width(); ++i) {
-            for (int j = 0; j < waveformSize.height(); ++j) {
-                waveValues[i][j] = 0;
-            }
-        }
+        // Hit count of each scope pixel, one scope row after the other (row 0 is black)
+        QVector<uint> waveValues(ww * wh, 0);
 
         // Number of input pixels that will fall on one scope pixel.
         // Must be a float because the acceleration factor can be high, leading to <1 expected px per px.
-        const float pixelDepth = (float)((byteCount >> 2) / accelFactor) / (ww * wh);
+        const float pixelDepth = (float)(iw * ih / accelFactor) / (ww * wh);
         const float gain = 255 / (8 * pixelDepth);
         //qCDebug(KDENLIVE_LOG) << "Pixel depth: expected " << pixelDepth << "; Gain: using " << gain << " (acceleration: " << accelFactor << "x)";
 
+        // Scope column of each image column, and scope row of each luma value.
         // Subtract 1 from sizes because we start counting from 0.
         // Not doing it would result in attempts to paint outside of the image.
-        const float hPrediv = (float)(wh - 1) / 255;
-        const float wPrediv = (float)(ww - 1) / (iw - 1);
-
-        const uchar *bits = image.bits();
-        const int bpp = image.depth() / 8;
-
-        for (uint i = 0, x = 0; i < byteCount; i += bpp) {
-
-            Q_ASSERT(bits < image.bits() + byteCount);
-
-            double dY, dx, dy;
-            QRgb *col = (QRgb *)bits;
+        QVector<int> columns(iw);
+        for (int x = 0; x < iw; ++x) {
+            columns[x] = iw > 1 ? x * (ww - 1) / (iw - 1) : 0;
+        }
+        int rowOffsets[256];
+        for (int y = 0; y < 256; ++y) {
+            rowOffsets[y] = y * (wh - 1) / 255 * ww;
+        }
 
-            if (rec == WaveformGenerator::Rec_601) {
-                // CIE 601 Luminance
-                dY = .299 * qRed(*col) + .587 * qGreen(*col) + .114 * qBlue(*col);
-            } else {
-                // CIE 709 Luminance
-                dY = .2125 * qRed(*col) + .7154 * qGreen(*col) + .0721 * qBlue(*col);
-            }
-            // dY is on [0,255] now.
-
-            dy = dY * hPrediv;
-            dx = x * wPrediv;
-            waveValues[(int)dx][(int)dy]++;
-
-            bits += bpp;
-            x += bpp;
-            if (x > iw) {
-                x -= iw;
-                if (accelFactor > 1) {
-                    bits += bpp * iw * (accelFactor - 1);
-                    i += bpp * iw * (accelFactor - 1);
-                }
+        uint *values = waveValues.data();
+        for (int y = 0; y < ih; y += accelFactor) {
+            const uchar *luma = lumaLine(y);
+            for (int x = 0; x < iw; ++x) {
+                values[rowOffsets[luma[x]] + columns.at(x)]++;
             }
         }
 
-        switch (paintMode) {
-        case PaintMode_Green:
-            for (int i = 0; i < waveformSize.width(); ++i) {
-                for (int j = 0; j < waveformSize.height(); ++j) {
+        for (int j = 0; j < wh; ++j) {
+            const uint *rowValues = values + j * ww;
+            QRgb *line = reinterpret_cast<QRgb *>(wave.scanLine(wh - j - 1));
+            switch (paintMode) {
+            case PaintMode_Green:
+                for (int i = 0; i < ww; ++i) {
+                    if (rowValues[i] == 0) {
+                        continue;
+                    }
                     // Logarithmic scale. Needs fine tuning by hand, but looks great.
-                    wave.setPixel(i, waveformSize.height() - j - 1, qRgba(CHOP255(52 * log(0.1 * gain * waveValues[i][j])),
-                                  CHOP255(52 * log(gain * waveValues[i][j])),
-                                  CHOP255(52 * log(.25 * gain * waveValues[i][j])),
-                                  CHOP255(64 * log(gain * waveValues[i][j]))));
+                    line[i] = qRgba(CHOP255(52 * log(0.1 * gain * rowValues[i])),
+                                    CHOP255(52 * log(gain * rowValues[i])),
+                                    CHOP255(52 * log(.25 * gain * rowValues[i])),
+                                    CHOP255(64 * log(gain * rowValues[i])));
                 }
-            }
-            break;
-        case PaintMode_Yellow:
-            for (int i = 0; i < waveformSize.width(); ++i) {
-                for (int j = 0; j < waveformSize.height(); ++j) {
-                    wave.setPixel(i, waveformSize.height() - j - 1, qRgba(255, 242, 0,   CHOP255(gain * waveValues[i][j])));
+                break;
+            case PaintMode_Yellow:
+                for (int i = 0; i < ww; ++i) {
+                    line[i] = qRgba(255, 242, 0, CHOP255(gain * rowValues[i]));
                 }
-            }
-            break;
-        default:
-            for (int i = 0; i < waveformSize.width(); ++i) {
-                for (int j = 0; j < waveformSize.height(); ++j) {
-                    wave.setPixel(i, waveformSize.height() - j - 1, qRgba(255, 255, 255, CHOP255(2 * gain * waveValues[i][j])));
+                break;
+            default:
+                for (int i = 0; i < ww; ++i) {
+                    line[i] = qRgba(255, 255, 255, CHOP255(2 * gain * rowValues[i]));
                 }
+                break;
             }
-            break;
         }
 
         if (drawAxis) {
-            QPainter davinci(&wave);
             QRgb opx;
-            davinci.setPen(qRgba(150, 255, 200, 32));
-            davinci.setCompositionMode(QPainter::CompositionMode_Overlay);
-            for (uint i = 0; i <= 10; ++i) {
-                float dy = (float)i / 10 * (wh - 1);
-                for (uint x = 0; x < ww; ++x) {
-                    opx = wave.pixel(x, dy);
-                    wave.setPixel(x, dy, qRgba(CHOP255(150 + qRed(opx)), 255,
-                                               CHOP255(200 + qBlue(opx)), CHOP255(32 + qAlpha(opx))));
+            for (int i = 0; i <= 10; ++i) {
+                QRgb *line = reinterpret_cast<QRgb *>(wave.scanLine((float)i / 10 * (wh - 1)));
+                for (int x = 0; x < ww; ++x) {
+                    opx = line[x];
+                    line[x] = qRgba(CHOP255(150 + qRed(opx)), 255, CHOP255(200 + qBlue(opx)), CHOP255(32 + qAlpha(opx)));
                 }
             }
         }
@@ -12,8 +12,10 @@
 #define WAVEFORMGENERATOR_H
 
 #include <QObject>
+#include <functional>
 class QImage;
 class QSize;
+class YuvPlanes;
 
 class WaveformGenerator : public QObject
 {
@@ -28,6 +30,14 @@ public:
 
     QImage calculateWaveform(const QSize &waveformSize, const QImage &image, WaveformGenerator::PaintMode paintMode,
                              bool drawAxis, const WaveformGenerator::Rec rec, uint accelFactor = 1);
+    /** @brief Same as above, reading the luma from the Y plane of a yuv420p frame */
+    QImage calculateWaveform(const QSize &waveformSize, const YuvPlanes &planes, WaveformGenerator::PaintMode paintMode,
+                             bool drawAxis, uint accelFactor = 1);
+
+private:
+    /** @brief Paints the waveform of an iw x ih image, lumaLine returns the 8 bit luma of row y */
+    QImage paintWaveform(const QSize &waveformSize, int iw, int ih, WaveformGenerator::PaintMode paintMode,
+                         bool drawAxis, uint accelFactor, const std::function<const uchar *(int)> &lumaLine);
 };
 
 #endif // WAVEFORMGENERATOR_H
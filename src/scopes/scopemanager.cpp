@@ -32,9 +32,13 @@
 
 ScopeManager::ScopeManager(QObject *parent) :
     QObject(parent),
-    m_lastConnectedRenderer(nullptr)
+    m_lastConnectedRenderer(nullptr),
+    m_lastAudioBlock(0)
 {
     m_signalMapper = new QSignalMapper(this);
+    // The scopes read the samples themselves, we only need to tell them when new audio arrived
+    m_audioTimer.setInterval(20);
+    connect(&m_audioTimer, &QTimer::timeout, this, &ScopeManager::slotDistributeAudio);
 
     connect(pCore->monitorManager(), &MonitorManager::checkColorScopes, this, &ScopeManager::slotUpdateActiveRenderer);
     connect(pCore->monitorManager(), &MonitorManager::clearScopes, this, &ScopeManager::slotClearColorScopes);
@@ -68,6 +72,7 @@ bool ScopeManager::addScope(AbstractAudioScopeWidget *audioScope, QDockWidget *a
         AudioScopeData asd;
         asd.scope = audioScope;
         m_audioScopes.append(asd);
+        audioScope->setAudioSource(m_lastConnectedRenderer ? m_lastConnectedRenderer->audioSamples : QSharedPointer<AudioSampleRing>());
 
         connect(audioScope, &AbstractScopeWidget::requestAutoRefresh, this, &ScopeManager::slotCheckActiveScopes);
         if (audioScopeWidget != nullptr) {
@@ -113,8 +118,16 @@ bool ScopeManager::addScope(AbstractGfxScopeWidget *colorScope, QDockWidget *col
     return added;
 }
 
-void ScopeManager::slotDistributeAudio(const audioShortVector &sampleData, int freq, int num_channels, int num_samples)
+void ScopeManager::slotDistributeAudio()
 {
+    if (m_lastConnectedRenderer == nullptr) {
+        return;
+    }
+    const quint64 written = m_lastConnectedRenderer->audioSamples->written();
+    if (written == m_lastAudioBlock) {
+        return;
+    }
+    m_lastAudioBlock = written;
 #ifdef DEBUG_SM
     qCDebug(KDENLIVE_LOG) << "ScopeManager: Starting to distribute audio.";
 #endif
@@ -122,7 +135,7 @@ void ScopeManager::slotDistributeAudio(const audioShortVector &sampleData, int f
         // Distribute audio to all scopes that are visible and want to be refreshed
         if (!m_audioScopes[i].scope->visibleRegion().isEmpty()) {
             if (m_audioScopes[i].scope->autoRefreshEnabled()) {
-                m_audioScopes[i].scope->slotReceiveAudio(sampleData, freq, num_channels, num_samples);
+                m_audioScopes[i].scope->slotAudioAvailable();
 #ifdef DEBUG_SM
                 qCDebug(KDENLIVE_LOG) << "ScopeManager: Distributed audio to " << m_audioScopes[i].scope->widgetName();
 #endif
@@ -131,6 +144,16 @@ void ScopeManager::slotDistributeAudio(const audioShortVector &sampleData, int f
     }
 }
 void ScopeManager::slotDistributeFrame(const QImage &image)
+{
+    distributeFrame(image);
+}
+
+void ScopeManager::slotDistributeSharedFrame(const SharedFrame &frame)
+{
+    distributeFrame(frame);
+}
+
+template <class T> void ScopeManager::distributeFrame(const T &image)
 {
 #ifdef DEBUG_SM
     qCDebug(KDENLIVE_LOG) << "ScopeManager: Starting to distribute frame.";
@@ -192,6 +215,19 @@ void ScopeManager::slotRequestFrame(const QString &widgetName)
 void ScopeManager::slotClearColorScopes()
 {
     m_lastConnectedRenderer = nullptr;
+    updateAudioSource();
+}
+
+void ScopeManager::updateAudioSource()
+{
+    QSharedPointer<AudioSampleRing> source;
+    if (m_lastConnectedRenderer != nullptr) {
+        source = m_lastConnectedRenderer->audioSamples;
+        m_lastAudioBlock = source->written();
+    }
+    for (int i = 0; i < m_audioScopes.size(); ++i) {
+        m_audioScopes[i].scope->setAudioSource(source);
+    }
 }
 
 void ScopeManager::slotUpdateActiveRenderer()
@@ -209,13 +245,14 @@ void ScopeManager::slotUpdateActiveRenderer()
     if (pCore->monitorManager()->isActive(Kdenlive::DvdMonitor)) {
         m_lastConnectedRenderer = nullptr;
     }
+    updateAudioSource();
 
     // Connect new renderer
     if (m_lastConnectedRenderer != nullptr) {
         connect(m_lastConnectedRenderer, &AbstractRender::frameUpdated,
                 this, &ScopeManager::slotDistributeFrame, Qt::UniqueConnection);
-        connect(m_lastConnectedRenderer, &AbstractRender::audioSamplesSignal,
-                this, &ScopeManager::slotDistributeAudio, Qt::UniqueConnection);
+        connect(m_lastConnectedRenderer, &AbstractRender::sharedFrameUpdated,
+                this, &ScopeManager::slotDistributeSharedFrame, Qt::UniqueConnection);
 
 #ifdef DEBUG_SM
         qCDebug(KDENLIVE_LOG) << "Renderer connected to ScopeManager: " << m_lastConnectedRenderer->id();
@@ -279,6 +316,11 @@ void ScopeManager::checkActiveAudioScopes()
 
     KdenliveSettings::setMonitor_audio(audioStillRequested);
     pCore->monitorManager()->slotUpdateAudioMonitoring();
+    if (audioStillRequested) {
+        m_audioTimer.start();
+    } else {
+        m_audioTimer.stop();
+    }
 }
 
 void ScopeManager::checkActiveColourScopes()
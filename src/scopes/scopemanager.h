@@ -15,6 +15,7 @@
 #include "colorscopes/abstractgfxscopewidget.h"
 
 #include <QtCore/QList>
+#include <QTimer>
 
 class QDockWidget;
 class AbstractRender;
@@ -73,6 +74,14 @@ private:
 
     QSignalMapper *m_signalMapper;
 
+    /** @brief Polls the audio ring of the active renderer while audio scopes are active */
+    QTimer m_audioTimer;
+    /** @brief Number of audio frames written to the ring at the last poll */
+    quint64 m_lastAudioBlock;
+
+    /** @brief Sets the audio source of all audio scopes to the active renderer's ring */
+    void updateAudioSource();
+
     /**
       Checks whether there is any scope accepting audio data, or if all of them are hidden
       or if auto refresh is disabled.
@@ -97,6 +106,11 @@ private:
      */
     template <class T> void createScopeDock(T *scopeWidget, const QString &title, const QString &name);
 
+    /**
+      Passes @param image (a QImage or a SharedFrame) to the visible scopes that want it.
+     */
+    template <class T> void distributeFrame(const T &image);
+
 public slots:
     void slotCheckActiveScopes();
 
@@ -126,7 +140,11 @@ private slots:
     void checkActiveColourScopes();
 
     void slotDistributeFrame(const QImage &image);
-    void slotDistributeAudio(const audioShortVector &sampleData, int freq, int num_channels, int num_samples);
+    void slotDistributeSharedFrame(const SharedFrame &frame);
+    /**
+      Checks whether new audio was written to the active renderer's ring, and notifies the audio scopes.
+      */
+    void slotDistributeAudio();
     /**
       Allows a scope to explicitly request a new frame, even if the scope's autoRefresh is disabled.
       */
@@ -54,6 +54,60 @@ AbstractClipItem::AbstractClipItem(const ItemInfo &info, const QRectF &rect, dou
 
 AbstractClipItem::~AbstractClipItem()
 {
+    if (scene()) {
+        projectScene()->itemIndex().removeItem(this);
+        projectScene()->snapIndex().removePoints(this);
+    }
+}
+
+void AbstractClipItem::setItemRect(const QRectF &rect)
+{
+    QGraphicsRectItem::setRect(rect);
+    updateIndex();
+}
+
+void AbstractClipItem::setItemRect(qreal x, qreal y, qreal w, qreal h)
+{
+    setItemRect(QRectF(x, y, w, h));
+}
+
+void AbstractClipItem::updateIndex()
+{
+    if (scene()) {
+        projectScene()->itemIndex().updateItem(this);
+        const int start = qRound(scenePos().x());
+        QVector<int> points = snapOffsets();
+        for (int i = 0; i < points.count(); ++i) {
+            points[i] += start;
+        }
+        projectScene()->snapIndex().setPoints(this, points);
+    }
+}
+
+QVector<int> AbstractClipItem::snapOffsets() const
+{
+    return QVector<int>() << 0 << qRound(rect().width());
+}
+
+QVariant AbstractClipItem::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    switch (change) {
+    case ItemSceneChange:
+        // Leaving the scene
+        if (scene()) {
+            projectScene()->itemIndex().removeItem(this);
+            projectScene()->snapIndex().removePoints(this);
+        }
+        break;
+    case ItemSceneHasChanged:
+    case ItemPositionHasChanged:
+    case ItemParentHasChanged:
+        updateIndex();
+        break;
+    default:
+        break;
+    }
+    return QGraphicsRectItem::itemChange(change, value);
 }
 
 void AbstractClipItem::doUpdate(const QRectF &r)
@@ -171,6 +225,8 @@ GenTime AbstractClipItem::cropDuration() const
 void AbstractClipItem::setCropStart(const GenTime &pos)
 {
     m_info.cropStart = pos;
+    // Clip markers are relative to the crop start
+    updateIndex();
 }
 
 void AbstractClipItem::updateItem(int track)
@@ -184,7 +240,7 @@ void AbstractClipItem::updateItem(int track)
 
 void AbstractClipItem::updateRectGeometry()
 {
-    setRect(0, 0, cropDuration().frames(m_fps) - 0.02, rect().height());
+    setItemRect(0, 0, cropDuration().frames(m_fps) - 0.02, rect().height());
 }
 
 void AbstractClipItem::resizeStart(int posx, bool hasSizeLimit, bool /*emitChange*/)
@@ -210,7 +266,7 @@ void AbstractClipItem::resizeStart(int posx, bool hasSizeLimit, bool /*emitChang
         }
     }
     m_info.cropDuration -= durationDiff;
-    setRect(0, 0, cropDuration().frames(m_fps) - 0.02, rect().height());
+    setItemRect(0, 0, cropDuration().frames(m_fps) - 0.02, rect().height());
     moveBy(durationDiff.frames(m_fps), 0);
 
     if (m_info.startPos != GenTime(posx, m_fps)) {
@@ -221,7 +277,7 @@ void AbstractClipItem::resizeStart(int posx, bool hasSizeLimit, bool /*emitChang
         }
 
         m_info.cropDuration -= diff;
-        setRect(0, 0, cropDuration().frames(m_fps) - 0.02, rect().height());
+        setItemRect(0, 0, cropDuration().frames(m_fps) - 0.02, rect().height());
     }
     // set crop from start to 0 (isn't relevant as this only happens for color clips, images)
     if (negCropStart) {
@@ -242,7 +298,7 @@ void AbstractClipItem::resizeEnd(int posx, bool /*emitChange*/)
     m_info.cropDuration += durationDiff;
     m_info.endPos += durationDiff;
 
-    setRect(0, 0, cropDuration().frames(m_fps) - 0.02, rect().height());
+    setItemRect(0, 0, cropDuration().frames(m_fps) - 0.02, rect().height());
     if (durationDiff > GenTime()) {
         QList<QGraphicsItem *> collisionList = collidingItems(Qt::IntersectsItemBoundingRect);
         bool fixItem = false;
@@ -260,7 +316,7 @@ void AbstractClipItem::resizeEnd(int posx, bool /*emitChange*/)
             }
         }
         if (fixItem) {
-            setRect(0, 0, cropDuration().frames(m_fps) - 0.02, rect().height());
+            setItemRect(0, 0, cropDuration().frames(m_fps) - 0.02, rect().height());
         }
     }
 }
@@ -400,55 +456,47 @@ int AbstractClipItem::posForTrack(int track)
     return pos;
 }
 
-void AbstractClipItem::attachKeyframeToEnd(const QDomElement &effect, bool attach)
+void AbstractClipItem::attachKeyframeToEnd(EffectParameters &effect, bool attach)
 {
-    QDomNodeList params = effect.elementsByTagName(QStringLiteral("parameter"));
-    for (int i = 0; i < params.count(); ++i) {
-        QDomElement e = params.item(i).toElement();
-        if (e.isNull()) {
-            continue;
-        }
-        QString paramName = e.attribute(QStringLiteral("name"));
-        if (m_keyframeView.activeParam(paramName) && e.attribute(QStringLiteral("type")) == QLatin1String("animated")) {
+    for (int i = 0; i < effect.count(); ++i) {
+        if (m_keyframeView.activeParam(effect.name(i)) && effect.xmlType(i) == QLatin1String("animated")) {
             m_keyframeView.attachKeyframeToEnd(attach);
-            e.setAttribute(QStringLiteral("value"), m_keyframeView.serialize());
+            effect.setText(i, m_keyframeView.serialize());
         }
     }
 }
 
-void AbstractClipItem::editKeyframeType(const QDomElement &effect, int type)
+void AbstractClipItem::editKeyframeType(EffectParameters &effect, int type)
 {
-    QDomNodeList params = effect.elementsByTagName(QStringLiteral("parameter"));
-    for (int i = 0; i < params.count(); ++i) {
-        QDomElement e = params.item(i).toElement();
-        if (e.isNull()) {
-            continue;
-        }
-        QString paramName = e.attribute(QStringLiteral("name"));
-        if (m_keyframeView.activeParam(paramName) && e.attribute(QStringLiteral("type")) == QLatin1String("animated")) {
+    for (int i = 0; i < effect.count(); ++i) {
+        if (m_keyframeView.activeParam(effect.name(i)) && effect.xmlType(i) == QLatin1String("animated")) {
             m_keyframeView.editKeyframeType(type);
-            e.setAttribute(QStringLiteral("value"), m_keyframeView.serialize());
+            effect.setText(i, m_keyframeView.serialize());
         }
     }
 }
 
-void AbstractClipItem::insertKeyframe(ProfileInfo profile, QDomElement effect, int pos, double val, bool defaultValue)
+void AbstractClipItem::serializeAnimations(EffectParameters &effect)
 {
-    if (effect.attribute(QStringLiteral("disable")) == QLatin1String("1")) {
+    for (int i = 0; i < effect.count(); ++i) {
+        const QString type = effect.xmlType(i);
+        if (type == QLatin1String("animated") || type == QLatin1String("animatedrect")) {
+            effect.setText(i, m_keyframeView.serialize(effect.name(i), type == QLatin1String("animatedrect")));
+        }
+    }
+}
+
+void AbstractClipItem::insertKeyframe(ProfileInfo profile, EffectParameters &effect, int pos, double val, bool defaultValue)
+{
+    if (effect.isDisabled()) {
         return;
     }
     QLocale locale;
     locale.setNumberOptions(QLocale::OmitGroupSeparator);
-    effect.setAttribute(QStringLiteral("active_keyframe"), pos);
-    QDomNodeList params = effect.elementsByTagName(QStringLiteral("parameter"));
-    for (int i = 0; i < params.count(); ++i) {
-        QDomElement e = params.item(i).toElement();
-        if (e.isNull()) {
-            continue;
-        }
-        QString paramName = e.attribute(QStringLiteral("name"));
-        if (e.attribute(QStringLiteral("type")) == QLatin1String("animated")) {
-            if (!m_keyframeView.activeParam(paramName)) {
+    effect.setActiveKeyframe(pos);
+    for (int i = 0; i < effect.count(); ++i) {
+        if (effect.xmlType(i) == QLatin1String("animated")) {
+            if (!m_keyframeView.activeParam(effect.name(i))) {
                 continue;
             }
             if (defaultValue) {
@@ -457,98 +505,51 @@ void AbstractClipItem::insertKeyframe(ProfileInfo profile, QDomElement effect, i
                 m_keyframeView.addKeyframe(pos, val, m_keyframeView.type(pos));
             }
             // inserting a keyframe touches all animated params
-            for (int j = 0; j < params.count(); ++j) {
-                QDomElement f = params.item(j).toElement();
-                if (f.attribute(QStringLiteral("type")) != QLatin1String("animated") && f.attribute(QStringLiteral("type")) != QLatin1String("animatedrect")) {
-                    continue;
-                }
-                f.setAttribute(QStringLiteral("value"), m_keyframeView.serialize(f.attribute(QStringLiteral("name")), f.attribute(QStringLiteral("type")) == QLatin1String("animatedrect")));
-            }
-        } else if (e.attribute(QStringLiteral("type")) == QLatin1String("keyframe")
-                   || e.attribute(QStringLiteral("type")) == QLatin1String("simplekeyframe")) {
-            QString kfr = e.attribute(QStringLiteral("keyframes"));
-            const QStringList keyframes = kfr.split(QLatin1Char(';'), QString::SkipEmptyParts);
-            QStringList newkfr;
-            bool added = false;
-            foreach (const QString &str, keyframes) {
-                int kpos = str.section(QLatin1Char('='), 0, 0).toInt();
-                double newval = locale.toDouble(str.section(QLatin1Char('='), 1, 1));
-                if (kpos < pos) {
-                    newkfr.append(str);
-                } else if (!added) {
-                    if (i == m_visibleParam) {
-                        newkfr.append(QString::number(pos) + QLatin1Char('=') + QString::number((int)val));
-                    } else {
-                        newkfr.append(QString::number(pos) + QLatin1Char('=') + locale.toString(newval));
-                    }
-                    if (kpos > pos) {
-                        newkfr.append(str);
-                    }
-                    added = true;
-                } else {
-                    newkfr.append(str);
-                }
-            }
-            if (!added) {
-                if (i == m_visibleParam) {
-                    newkfr.append(QString::number(pos) + QLatin1Char('=') + QString::number((int)val));
-                } else {
-                    newkfr.append(QString::number(pos) + QLatin1Char('=') + e.attribute(QStringLiteral("default")));
-                }
+            serializeAnimations(effect);
+        } else if (effect.type(i) == EffectParameters::Keyframes) {
+            QMap<int, double> keyframes = effect.keyframes(i);
+            QMap<int, double>::const_iterator next = keyframes.lowerBound(pos);
+            if (i == m_visibleParam) {
+                keyframes.insert(pos, (int) val);
+            } else if (next != keyframes.constEnd()) {
+                // Use the value of the following keyframe
+                keyframes.insert(pos, next.value());
+            } else {
+                keyframes.insert(pos, locale.toDouble(effect.defaultValue(i)));
             }
-            e.setAttribute(QStringLiteral("keyframes"), newkfr.join(QLatin1Char(';')));
+            effect.setKeyframes(i, keyframes);
         }
     }
 }
 
-void AbstractClipItem::movedKeyframe(QDomElement effect, int newpos, int oldpos, double value)
+void AbstractClipItem::movedKeyframe(EffectParameters &effect, int newpos, int oldpos, double value)
 {
-    if (effect.attribute(QStringLiteral("disable")) == QLatin1String("1")) {
+    if (effect.isDisabled()) {
         return;
     }
-    QLocale locale;
-    locale.setNumberOptions(QLocale::OmitGroupSeparator);
-    effect.setAttribute(QStringLiteral("active_keyframe"), newpos);
-    QDomNodeList params = effect.elementsByTagName(QStringLiteral("parameter"));
+    effect.setActiveKeyframe(newpos);
     int start = cropStart().frames(m_fps);
     int end = (cropStart() + cropDuration()).frames(m_fps) - 1;
-    for (int i = 0; i < params.count(); ++i) {
-        QDomElement e = params.item(i).toElement();
-        if (e.isNull()) {
-            continue;
-        }
-        QString paramName = e.attribute(QStringLiteral("name"));
-        if (e.attribute(QStringLiteral("type")).startsWith(QLatin1String("animated"))) {
-            if (m_keyframeView.activeParam(paramName)) {
+    for (int i = 0; i < effect.count(); ++i) {
+        const QString type = effect.xmlType(i);
+        if (type.startsWith(QLatin1String("animated"))) {
+            if (m_keyframeView.activeParam(effect.name(i))) {
                 // inserting a keyframe touches all animated params
-                for (int j = 0; j < params.count(); ++j) {
-                    QDomElement f = params.item(j).toElement();
-                    if (f.attribute(QStringLiteral("type")) != QLatin1String("animated") && f.attribute(QStringLiteral("type")) != QLatin1String("animatedrect")) {
-                        continue;
-                    }
-                    f.setAttribute(QStringLiteral("value"), m_keyframeView.serialize(f.attribute(QStringLiteral("name")), f.attribute(QStringLiteral("type")) == QLatin1String("animatedrect")));
-                }
+                serializeAnimations(effect);
             }
-        } else if ((e.attribute(QStringLiteral("type")) == QLatin1String("keyframe") || e.attribute(QStringLiteral("type")) == QLatin1String("simplekeyframe"))) {
-            QString kfr = e.attribute(QStringLiteral("keyframes"));
-            const QStringList keyframes = kfr.split(QLatin1Char(';'), QString::SkipEmptyParts);
-            QStringList newkfr;
-            foreach (const QString &str, keyframes) {
-                if (str.section(QLatin1Char('='), 0, 0).toInt() != oldpos) {
-                    newkfr.append(str);
-                } else if (newpos != -1) {
-                    newpos = qBound(start, newpos, end);
-                    if (i == m_visibleParam) {
-                        newkfr.append(QString::number(newpos) + QLatin1Char('=') + locale.toString(value));
-                    } else {
-                        newkfr.append(QString::number(newpos) + QLatin1Char('=') + str.section(QLatin1Char('='), 1, 1));
-                    }
-                }
+        } else if (effect.type(i) == EffectParameters::Keyframes) {
+            QMap<int, double> keyframes = effect.keyframes(i);
+            if (!keyframes.contains(oldpos)) {
+                continue;
+            }
+            double current = keyframes.take(oldpos);
+            if (newpos != -1) {
+                newpos = qBound(start, newpos, end);
+                keyframes.insert(newpos, i == m_visibleParam ? value : current);
             }
-            e.setAttribute(QStringLiteral("keyframes"), newkfr.join(QLatin1Char(';')));
-        } else if (e.attribute(QStringLiteral("type")) == QLatin1String("geometry")) {
-            QString kfr = e.attribute(QStringLiteral("value"));
-            const QStringList keyframes = kfr.split(QLatin1Char(';'), QString::SkipEmptyParts);
+            effect.setKeyframes(i, keyframes);
+        } else if (type == QLatin1String("geometry")) {
+            const QStringList keyframes = effect.text(i).split(QLatin1Char(';'), QString::SkipEmptyParts);
             QStringList newkfr;
             for (const QString &str : keyframes) {
                 if (str.section(QLatin1Char('='), 0, 0).toInt() != oldpos) {
@@ -558,60 +559,40 @@ void AbstractClipItem::movedKeyframe(QDomElement effect, int newpos, int oldpos,
                     newkfr.append(QString::number(newpos) + QLatin1Char('=') + str.section(QLatin1Char('='), 1, 1));
                 }
             }
-            e.setAttribute(QStringLiteral("value"), newkfr.join(QLatin1Char(';')));
+            effect.setText(i, newkfr.join(QLatin1Char(';')));
         }
     }
-
-    updateKeyframes(effect);
     update();
 }
 
-void AbstractClipItem::removeKeyframe(QDomElement effect, int frame)
+void AbstractClipItem::removeKeyframe(EffectParameters &effect, int frame)
 {
-    if (effect.attribute(QStringLiteral("disable")) == QLatin1String("1")) {
+    if (effect.isDisabled()) {
         return;
     }
-    effect.setAttribute(QStringLiteral("active_keyframe"), 0);
-    QDomNodeList params = effect.elementsByTagName(QStringLiteral("parameter"));
-    for (int i = 0; i < params.count(); ++i) {
-        QDomElement e = params.item(i).toElement();
-        if (e.isNull()) {
-            continue;
-        }
-        if ((e.attribute(QStringLiteral("type")) == QLatin1String("keyframe") || e.attribute(QStringLiteral("type")) == QLatin1String("simplekeyframe"))) {
-            QString kfr = e.attribute(QStringLiteral("keyframes"));
-            const QStringList keyframes = kfr.split(QLatin1Char(';'), QString::SkipEmptyParts);
-            QStringList newkfr;
-            for (const QString &str : keyframes) {
-                if (str.section(QLatin1Char('='), 0, 0).toInt() != frame) {
-                    newkfr.append(str);
-                }
+    effect.setActiveKeyframe(0);
+    for (int i = 0; i < effect.count(); ++i) {
+        const QString type = effect.xmlType(i);
+        if (effect.type(i) == EffectParameters::Keyframes) {
+            QMap<int, double> keyframes = effect.keyframes(i);
+            if (keyframes.remove(frame) > 0) {
+                effect.setKeyframes(i, keyframes);
             }
-            e.setAttribute(QStringLiteral("keyframes"), newkfr.join(QLatin1Char(';')));
-        } else if (e.attribute(QStringLiteral("type")) == QLatin1String("geometry")) {
-            QString kfr = e.attribute(QStringLiteral("value"));
-            const QStringList keyframes = kfr.split(QLatin1Char(';'), QString::SkipEmptyParts);
+        } else if (type == QLatin1String("geometry")) {
+            const QStringList keyframes = effect.text(i).split(QLatin1Char(';'), QString::SkipEmptyParts);
             QStringList newkfr;
-            foreach (const QString &str, keyframes) {
+            for (const QString &str : keyframes) {
                 if (str.section(QLatin1Char('='), 0, 0).toInt() != frame) {
                     newkfr.append(str);
                 }
             }
-            e.setAttribute(QStringLiteral("value"), newkfr.join(QLatin1Char(';')));
-        } else if (e.attribute(QStringLiteral("type")) == QLatin1String("animated")) {
+            effect.setText(i, newkfr.join(QLatin1Char(';')));
+        } else if (type == QLatin1String("animated")) {
             m_keyframeView.removeKeyframe(frame);
             // inserting a keyframe touches all animated params
-            for (int j = 0; j < params.count(); ++j) {
-                QDomElement f = params.item(j).toElement();
-                if (f.attribute(QStringLiteral("type")) != QLatin1String("animated") && f.attribute(QStringLiteral("type")) != QLatin1String("animatedrect")) {
-                    continue;
-                }
-                f.setAttribute(QStringLiteral("value"), m_keyframeView.serialize(f.attribute(QStringLiteral("name")), f.attribute(QStringLiteral("type")) == QLatin1String("animatedrect")));
-            }
+            serializeAnimations(effect);
         }
     }
-
-    updateKeyframes(effect);
     update();
 }
 
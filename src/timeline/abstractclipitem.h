@@ -22,6 +22,7 @@
 #define ABSTRACTCLIPITEM_H
 
 #include "keyframeview.h"
+#include "effectslist/effectparameters.h"
 #include "definitions.h"
 #include "gentime.h"
 
@@ -31,6 +32,7 @@
 #include <QGraphicsRectItem>
 #include <QGraphicsWidget>
 #include <QTimer>
+#include <QVector>
 
 class CustomTrackScene;
 class QGraphicsSceneMouseEvent;
@@ -38,7 +40,7 @@ class QGraphicsSceneMouseEvent;
 class AbstractClipItem : public QObject, public QGraphicsRectItem
 {
     Q_OBJECT
-    Q_PROPERTY(QRectF rect READ rect WRITE setRect)
+    Q_PROPERTY(QRectF rect READ rect WRITE setItemRect)
     Q_PROPERTY(qreal opacity READ opacity WRITE setOpacity)
 
 public:
@@ -49,12 +51,17 @@ public:
     CustomTrackScene *projectScene();
     void updateRectGeometry();
     void updateItem(int track);
+    /** @brief Set the item's rect and update its entries in the scene's indexes.
+     *  QGraphicsRectItem::setRect is not virtual and sends no item change, so use this instead */
+    void setItemRect(const QRectF &rect);
+    void setItemRect(qreal x, qreal y, qreal w, qreal h);
+    /** @brief Update the item's entries in the scene's TrackItemIndex and SnapIndex after a geometry or marker change */
+    void updateIndex();
     void setItemLocked(bool locked);
     bool isItemLocked() const;
     void closeAnimation();
 
     virtual OperationType operationMode(const QPointF &pos, Qt::KeyboardModifiers modifiers) = 0;
-    virtual void updateKeyframes(const QDomElement &effect) = 0;
     virtual GenTime startPos() const;
     virtual GenTime endPos() const;
     virtual int track() const;
@@ -78,8 +85,8 @@ public:
     double editedKeyFrameValue();
     double getKeyFrameClipHeight(const double y);
     QAction *parseKeyframeActions(const QList<QAction *> &list);
-    void editKeyframeType(const QDomElement &effect, int type);
-    void attachKeyframeToEnd(const QDomElement &effect, bool attach);
+    void editKeyframeType(EffectParameters &effect, int type);
+    void attachKeyframeToEnd(EffectParameters &effect, bool attach);
     bool isAttachedToEnd() const;
 
     /** @brief Resizes the clip from the end.
@@ -95,9 +102,10 @@ public:
     /** @brief Is this clip selected as the main clip. */
     bool isMainSelectedClip();
 
-    void insertKeyframe(ProfileInfo profile, QDomElement effect, int pos, double val, bool defaultValue = false);
-    void movedKeyframe(QDomElement effect, int newpos, int oldpos = -1, double value = -1);
-    void removeKeyframe(QDomElement effect, int frame);
+    /** @brief Keyframe edits from the timeline, they only change effect, which the caller has to apply */
+    void insertKeyframe(ProfileInfo profile, EffectParameters &effect, int pos, double val, bool defaultValue = false);
+    void movedKeyframe(EffectParameters &effect, int newpos, int oldpos = -1, double value = -1);
+    void removeKeyframe(EffectParameters &effect, int frame);
 
 private slots:
     void doUpdate(const QRectF &r);
@@ -117,11 +125,16 @@ protected:
     void mousePressEvent(QGraphicsSceneMouseEvent *event) Q_DECL_OVERRIDE;
     void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) Q_DECL_OVERRIDE;
     void mouseMoveEvent(QGraphicsSceneMouseEvent *event) Q_DECL_OVERRIDE;
+    QVariant itemChange(GraphicsItemChange change, const QVariant &value) Q_DECL_OVERRIDE;
+    /** @brief The snap points of the item in frames, relative to its start (default: its start and end) */
+    virtual QVector<int> snapOffsets() const;
     int trackForPos(int position);
     int posForTrack(int track);
     bool resizeGeometries(QDomElement effect, int width, int height, int previousDuration, int start, int duration, int cropstart);
     QString resizeAnimations(QDomElement effect, int previousDuration, int start, int duration, int cropstart);
     bool switchKeyframes(QDomElement param, int in, int oldin, int out, int oldout);
+    /** @brief Store the animations edited in m_keyframeView in effect */
+    void serializeAnimations(EffectParameters &effect);
 
 signals:
     void selectItem(AbstractClipItem *);
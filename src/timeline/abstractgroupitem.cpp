@@ -435,9 +435,24 @@ QVariant AbstractGroupItem::itemChange(GraphicsItemChange change, const QVariant
         }
         return newPos;
     }
+    if (change == ItemPositionHasChanged) {
+        updateChildrenIndex(this);
+    }
     return QGraphicsItemGroup::itemChange(change, value);
 }
 
+void AbstractGroupItem::updateChildrenIndex(QGraphicsItem *group)
+{
+    const QList<QGraphicsItem *> children = group->childItems();
+    for (QGraphicsItem *child : children) {
+        if (child->type() == AVWidget || child->type() == TransitionWidget) {
+            static_cast<AbstractClipItem *>(child)->updateIndex();
+        } else if (child->type() == GroupWidget) {
+            updateChildrenIndex(child);
+        }
+    }
+}
+
 //virtual
 void AbstractGroupItem::dropEvent(QGraphicsSceneDragDropEvent *event)
 {
@@ -76,6 +76,8 @@ protected:
 private:
     QPainterPath groupShape(GraphicsRectItem type, const QPointF &offset) const;
     QPainterPath spacerGroupShape(GraphicsRectItem type, const QPointF &offset) const;
+    /** @brief Update the TrackItemIndex entries of the clips and transitions in the group after it moved */
+    static void updateChildrenIndex(QGraphicsItem *group);
 };
 
 #endif
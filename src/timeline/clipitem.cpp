@@ -27,6 +27,7 @@
 #include "kdenlivesettings.h"
 #include "doc/kthumb.h"
 #include "bin/projectclip.h"
+#include "mltcontroller/clipcontroller.h"
 #include "mltcontroller/effectscontroller.h"
 #include "onmonitoritems/rotoscoping/rotowidget.h"
 #include "utils/KoIconUtils.h"
@@ -57,12 +58,14 @@ ClipItem::ClipItem(ProjectClip *clip, const ItemInfo &info, double fps, double s
     //m_hover(false),
     m_speed(speed),
     m_strobe(strobe),
-    m_framePixelWidth(0)
+    m_audioThumbPrioritized(false),
+    m_framePixelWidth(0),
+    m_effectsPending(false)
 {
     setZValue(2);
     m_effectList = EffectsList(true);
     FRAME_SIZE = frame_width;
-    setRect(0, 0, (info.endPos - info.startPos).frames(m_fps) - 0.02, (double) itemHeight());
+    setItemRect(0, 0, (info.endPos - info.startPos).frames(m_fps) - 0.02, (double) itemHeight());
     // set speed independent info
     if (m_speed <= 0 && m_speed > -1) {
         m_speed = -1.0;
@@ -139,7 +142,7 @@ ClipItem *ClipItem::clone(const ItemInfo &info) const
             duplicate->slotSetEndThumb(m_endPix);
         }
     }
-    duplicate->setEffectList(m_effectList);
+    duplicate->setEffectList(effects());
     duplicate->setState(m_clipState);
     duplicate->setFades(fadeIn(), fadeOut());
     //duplicate->setSpeed(m_speed);
@@ -148,16 +151,17 @@ ClipItem *ClipItem::clone(const ItemInfo &info) const
 
 void ClipItem::setEffectList(const EffectsList &effectList)
 {
-    m_effectList.clone(effectList);
-    m_effectNames = m_effectList.effectNames().join(QStringLiteral(" / "));
+    m_effectParameters.clear();
+    effects().clone(effectList);
+    m_effectNames = effects().effectNames().join(QStringLiteral(" / "));
     m_startFade = 0;
     m_endFade = 0;
-    if (!m_effectList.isEmpty()) {
+    if (!effects().isEmpty()) {
         // If we only have one fade in /ou effect, always display it in timeline
-        for (int i = 0; i < m_effectList.count(); ++i) {
+        for (int i = 0; i < effects().count(); ++i) {
             bool startFade = false;
             bool endFade = false;
-            QDomElement effect = m_effectList.at(i);
+            QDomElement effect = effects().at(i);
             QString effectId = effect.attribute(QStringLiteral("id"));
             // check if it is a fade effect
             int fade = 0;
@@ -188,6 +192,22 @@ void ClipItem::setEffectList(const EffectsList &effectList)
 
 const EffectsList ClipItem::effectList() const
 {
+    return effects();
+}
+
+void ClipItem::setEffectsPending(bool pending)
+{
+    m_effectsPending = pending;
+}
+
+EffectsList &ClipItem::effects() const
+{
+    if (m_effectsPending) {
+        // Let the timeline parse the effects before anyone uses them
+        m_effectsPending = false;
+        ClipItem *self = const_cast<ClipItem *>(this);
+        emit self->requestEffects(self);
+    }
     return m_effectList;
 }
 
@@ -198,13 +218,15 @@ int ClipItem::selectedEffectIndex() const
 
 void ClipItem::initEffect(ProfileInfo pInfo, const QDomElement &effect, int diff, int offset)
 {
-    EffectsController::initEffect(m_info, pInfo, m_effectList, m_binClip->getProducerProperty(QStringLiteral("proxy")), effect, diff, offset);
+    m_effectParameters.clear();
+    EffectsController::initEffect(m_info, pInfo, effects(), m_binClip->getProducerProperty(QStringLiteral("proxy")), effect, diff, offset);
 }
 
 bool ClipItem::checkKeyFrames(int width, int height, int previousDuration, int cutPos)
 {
     bool clipEffectsModified = false;
-    int effectsCount = m_effectList.count();
+    int effectsCount = effects().count();
+    m_effectParameters.clear();
     if (effectsCount == 0) {
         // reset keyframes
         m_keyframeView.reset();
@@ -212,7 +234,7 @@ bool ClipItem::checkKeyFrames(int width, int height, int previousDuration, int c
     // go through all effects this clip has
     for (int ix = 0; ix < effectsCount; ++ix) {
         // Check geometry params
-        QDomElement effect = m_effectList.at(ix);
+        QDomElement effect = effects().at(ix);
         clipEffectsModified = resizeGeometries(effect, width, height, previousDuration, cutPos == -1 ? 0 : cutPos, cropDuration().frames(m_fps) - 1, cropStart().frames(m_fps));
         QString newAnimation = resizeAnimations(effect, previousDuration, cutPos == -1 ? 0 : cutPos, cropDuration().frames(m_fps) - 1, cropStart().frames(m_fps));
         if (!newAnimation.isEmpty()) {
@@ -229,7 +251,7 @@ bool ClipItem::checkKeyFrames(int width, int height, int previousDuration, int c
 
 void ClipItem::setKeyframes(const int ix)
 {
-    QDomElement effect = m_effectList.at(ix);
+    QDomElement effect = effects().at(ix);
     if (effect.attribute(QStringLiteral("disable")) == QLatin1String("1")) {
         return;
     }
@@ -259,8 +281,8 @@ void ClipItem::setSelectedEffect(const int ix)
         QString effectId = effect.attribute(QStringLiteral("id"));
 
         // Check for fades to display in timeline
-        int startFade1 = m_effectList.hasEffect(QString(), QStringLiteral("fadein"));
-        int startFade2 = m_effectList.hasEffect(QString(), QStringLiteral("fade_from_black"));
+        int startFade1 = effects().hasEffect(QString(), QStringLiteral("fadein"));
+        int startFade2 = effects().hasEffect(QString(), QStringLiteral("fade_from_black"));
 
         if (startFade1 >= 0 && startFade2 >= 0) {
             // We have 2 fade ins, only display if effect is selected
@@ -279,8 +301,8 @@ void ClipItem::setSelectedEffect(const int ix)
         }
 
         // Check for fades out to display in timeline
-        int endFade1 = m_effectList.hasEffect(QString(), QStringLiteral("fadeout"));
-        int endFade2 = m_effectList.hasEffect(QString(), QStringLiteral("fade_to_black"));
+        int endFade1 = effects().hasEffect(QString(), QStringLiteral("fadeout"));
+        int endFade2 = effects().hasEffect(QString(), QStringLiteral("fade_to_black"));
 
         if (endFade1 >= 0 && endFade2 >= 0) {
             // We have 2 fade ins, only display if effect is selected
@@ -314,7 +336,7 @@ void ClipItem::setSelectedEffect(const int ix)
 QStringList ClipItem::keyframes(const int index)
 {
     QStringList result;
-    QDomElement effect = m_effectList.at(index);
+    QDomElement effect = effects().at(index);
     QDomNodeList params = effect.elementsByTagName(QStringLiteral("parameter"));
 
     for (int i = 0; i < params.count(); ++i) {
@@ -334,7 +356,7 @@ QStringList ClipItem::keyframes(const int index)
 
 QDomElement ClipItem::selectedEffect()
 {
-    if (m_selectedEffect == -1 || m_effectList.isEmpty()) {
+    if (m_selectedEffect == -1 || effects().isEmpty()) {
         return QDomElement();
     }
     return effectAtIndex(m_selectedEffect);
@@ -577,6 +599,8 @@ void ClipItem::paint(QPainter *painter,
                      const QStyleOptionGraphicsItem *option,
                      QWidget *)
 {
+    // Visible clips need their fades and effect names
+    effects();
     QPalette palette = scene()->palette();
     QColor paintColor = m_paintColor;
     QColor textColor;
@@ -671,8 +695,13 @@ void ClipItem::paint(QPainter *painter,
             }
         }
     }
+    if (!m_audioThumbReady && !m_audioThumbPrioritized && KdenliveSettings::audiothumbnails() && (m_clipType == AV || m_clipType == Audio || m_clipType == Playlist)) {
+        // Clip is visible, create its audio thumbnail before the other ones. If it is not queued yet, retry on next paint
+        m_audioThumbPrioritized = m_binClip->prioritizeAudioThumbs();
+    }
     // draw audio thumbnails
     if (KdenliveSettings::audiothumbnails() && m_speed == 1.0 && m_clipState != PlaylistState::VideoOnly && m_originalClipState != PlaylistState::VideoOnly && (((m_clipType == AV || m_clipType == Playlist) && (exposed.bottom() > (rect().height() / 2) || m_originalClipState == PlaylistState::AudioOnly || m_clipState == PlaylistState::AudioOnly)) || m_clipType == Audio) && m_audioThumbReady && !m_binClip->audioFrameCache.isEmpty()) {
+        const AudioLevels audioLevels = m_binClip->audioFrameCache;
         int startpixel = qMax(0, (int) exposed.left());
         int endpixel = qMax(0, (int)(exposed.right() + 0.5) + 1);
         QRectF mappedRect = mapped;
@@ -681,7 +710,7 @@ void ClipItem::paint(QPainter *painter,
         }
 
         double scale = transformation.m11();
-        int channels = m_binClip->audioChannels();
+        int channels = audioLevels.channels();
         int cropLeft = m_info.cropStart.frames(m_fps);
         double startx = transformation.map(QPoint(startpixel, 0)).x();
         double endx = transformation.map(QPoint(endpixel, 0)).x();
@@ -689,7 +718,8 @@ void ClipItem::paint(QPainter *painter,
         if (scale < 1) {
             offset = (int)(1.0 / scale);
         }
-        int audioLevelCount = m_binClip->audioFrameCache.count() - 1;
+        // Read peaks from the reduced levels matching our zoom
+        int pyramidLevel = audioLevels.pyramidLevel(offset);
         if (!KdenliveSettings::displayallchannels()) {
             // simplified audio
             int channelHeight = mappedRect.height();
@@ -700,10 +730,7 @@ void ClipItem::paint(QPainter *painter,
                 QPainterPath positiveChannelPath;
                 positiveChannelPath.moveTo(startx, mappedRect.bottom());
                 for (; i < endpixel + cropLeft + offset; i += offset) {
-                    double value = m_binClip->audioFrameCache.at(qMin(i * channels, audioLevelCount)).toDouble() / 256;
-                    for (int channel = 1; channel < channels; channel ++) {
-                        value = qMax(value, m_binClip->audioFrameCache.at(qMin(i * channels + channel, audioLevelCount)).toDouble() / 256);
-                    }
+                    double value = audioLevels.maxLevel(i, pyramidLevel) / 256.0;
                     positiveChannelPath.lineTo(startx + (i - startOffset) * scale, mappedRect.bottom() - (value * channelHeight));
                 }
                 positiveChannelPath.lineTo(startx + (i - startOffset) * scale, mappedRect.bottom());
@@ -716,10 +743,7 @@ void ClipItem::paint(QPainter *painter,
                 i = startx;
                 for (; i < endx; i++) {
                     int framePos = startOffset + ((i - startx) / scale);
-                    double value = m_binClip->audioFrameCache.at(qMin(framePos * channels, audioLevelCount)).toDouble() / 256;
-                    for (int channel = 1; channel < channels; channel ++) {
-                        value = qMax(value, m_binClip->audioFrameCache.at(qMin(framePos * channels + channel, audioLevelCount)).toDouble() / 256);
-                    }
+                    double value = audioLevels.maxLevel(framePos) / 256.0;
                     painter->drawLine(i, mappedRect.bottom() - (value * channelHeight), i, mappedRect.bottom());
                 }
             }
@@ -741,7 +765,7 @@ void ClipItem::paint(QPainter *painter,
                     i = startOffset;
                     painter->drawLine(startx, mappedRect.bottom() - y, endx, mappedRect.bottom() - y);
                     for (; i < endpixel + cropLeft + offset; i += offset) {
-                        value = m_binClip->audioFrameCache.at(qMin(i * channels + channel, audioLevelCount)).toDouble() / 256 * channelHeight / 2;
+                        value = audioLevels.level(i, channel, pyramidLevel) / 256.0 * channelHeight / 2;
                         positiveChannelPaths[channel].lineTo(startx + (i - startOffset) * scale, mappedRect.bottom() - y - value);
                         negativeChannelPaths[channel].lineTo(startx + (i - startOffset) * scale, mappedRect.bottom() - y + value);
                     }
@@ -768,7 +792,7 @@ void ClipItem::paint(QPainter *painter,
                     int framePos = startOffset + ((i - startx) / scale);
                     for (int channel = 0; channel < channels; channel ++) {
                         int y = channelHeight * channel + channelHeight / 2;
-                        value = m_binClip->audioFrameCache.at(qMin(framePos * channels + channel, audioLevelCount)).toDouble() / 256 * channelHeight / 2;
+                        value = audioLevels.level(framePos, channel) / 256.0 * channelHeight / 2;
                         painter->drawLine(i, mappedRect.bottom() - value - y, i, mappedRect.bottom() - y + value);
                     }
                 }
@@ -1056,6 +1080,15 @@ void ClipItem::resetFrameWidth(int width)
 }
 
 QList<GenTime> ClipItem::snapMarkers(const QList< GenTime > &markers) const
+{
+    QList< GenTime > snaps = markerOffsets(markers);
+    for (int i = 0; i < snaps.size(); ++i) {
+        snaps[i] += startPos();
+    }
+    return snaps;
+}
+
+QList<GenTime> ClipItem::markerOffsets(const QList< GenTime > &markers) const
 {
     QList< GenTime > snaps;
     GenTime pos;
@@ -1066,13 +1099,26 @@ QList<GenTime> ClipItem::snapMarkers(const QList< GenTime > &markers) const
             if (pos > cropDuration()) {
                 break;
             } else {
-                snaps.append(pos + startPos());
+                snaps.append(pos);
             }
         }
     }
     return snaps;
 }
 
+QVector<int> ClipItem::snapOffsets() const
+{
+    QVector<int> offsets = AbstractClipItem::snapOffsets();
+    ClipController *controller = m_binClip ? m_binClip->controller() : nullptr;
+    if (controller) {
+        const QList<GenTime> markers = markerOffsets(controller->snapMarkers());
+        for (int i = 0; i < markers.size(); ++i) {
+            offsets.append(qRound(markers.at(i).frames(m_fps)));
+        }
+    }
+    return offsets;
+}
+
 QList<CommentedTime> ClipItem::commentedSnapMarkers() const
 {
     QList< CommentedTime > snaps;
@@ -1097,11 +1143,13 @@ QList<CommentedTime> ClipItem::commentedSnapMarkers() const
 
 int ClipItem::fadeIn() const
 {
+    effects();
     return m_startFade;
 }
 
 int ClipItem::fadeOut() const
 {
+    effects();
     return m_endFade;
 }
 
@@ -1336,7 +1384,7 @@ QVariant ClipItem::itemChange(GraphicsItemChange change, const QVariant &value)
             m_paintColor = m_baseColor;
         }
     }
-    return QGraphicsItem::itemChange(change, value);
+    return AbstractClipItem::itemChange(change, value);
 }
 
 int ClipItem::effectsCounter()
@@ -1346,47 +1394,71 @@ int ClipItem::effectsCounter()
 
 int ClipItem::effectsCount()
 {
-    return m_effectList.count();
+    return effects().count();
 }
 
 int ClipItem::hasEffect(const QString &tag, const QString &id) const
 {
-    return m_effectList.hasEffect(tag, id);
+    return effects().hasEffect(tag, id);
 }
 
 QStringList ClipItem::effectNames()
 {
-    return m_effectList.effectNames();
+    return effects().effectNames();
 }
 
 QDomElement ClipItem::effect(int ix) const
 {
-    if (ix >= m_effectList.count() || ix < 0) {
+    if (ix >= effects().count() || ix < 0) {
         return QDomElement();
     }
-    return m_effectList.at(ix).cloneNode().toElement();
+    return effects().at(ix).cloneNode().toElement();
 }
 
 QDomElement ClipItem::effectAtIndex(int ix) const
 {
-    if (ix > m_effectList.count() || ix <= 0) {
+    if (ix > effects().count() || ix <= 0) {
         return QDomElement();
     }
-    return m_effectList.itemFromIndex(ix).cloneNode().toElement();
+    return effects().itemFromIndex(ix).cloneNode().toElement();
 }
 
 QDomElement ClipItem::getEffectAtIndex(int ix) const
 {
-    if (ix > m_effectList.count() || ix <= 0) {
+    if (ix > effects().count() || ix <= 0) {
         return QDomElement();
     }
-    return m_effectList.itemFromIndex(ix);
+    // The caller may edit the xml
+    m_effectParameters.remove(ix);
+    return effects().itemFromIndex(ix);
+}
+
+EffectParameters &ClipItem::effectParameters(int ix)
+{
+    QMap<int, EffectParameters>::iterator it = m_effectParameters.find(ix);
+    if (it == m_effectParameters.end()) {
+        QDomElement effect;
+        if (ix > 0 && ix <= effects().count()) {
+            effect = effects().itemFromIndex(ix);
+        }
+        it = m_effectParameters.insert(ix, EffectParameters(effect));
+    }
+    return *it;
+}
+
+void ClipItem::writeEffectParameters(int ix)
+{
+    QMap<int, EffectParameters>::iterator it = m_effectParameters.find(ix);
+    if (it != m_effectParameters.end() && it->isModified()) {
+        it->writeTo(effects().itemFromIndex(ix));
+    }
 }
 
 void ClipItem::updateEffect(const QDomElement &effect)
 {
-    m_effectList.updateEffect(effect);
-    m_effectNames = m_effectList.effectNames().join(QStringLiteral(" / "));
+    m_effectParameters.remove(effect.attribute(QStringLiteral("kdenlive_ix")).toInt());
+    effects().updateEffect(effect);
+    m_effectNames = effects().effectNames().join(QStringLiteral(" / "));
     QString id = effect.attribute(QStringLiteral("id"));
     if (id == QLatin1String("fadein") || id == QLatin1String("fadeout") || id == QLatin1String("fade_from_black") || id == QLatin1String("fade_to_black")) {
         update();
@@ -1399,18 +1471,20 @@ void ClipItem::updateEffect(const QDomElement &effect)
 
 bool ClipItem::enableEffects(const QList<int> &indexes, bool disable)
 {
-    return m_effectList.enableEffects(indexes, disable);
+    m_effectParameters.clear();
+    return effects().enableEffects(indexes, disable);
 }
 
 bool ClipItem::moveEffect(QDomElement effect, int ix)
 {
-    if (ix <= 0 || ix > (m_effectList.count()) || effect.isNull()) {
+    if (ix <= 0 || ix > (effects().count()) || effect.isNull()) {
         return false;
     }
-    m_effectList.removeAt(effect.attribute(QStringLiteral("kdenlive_ix")).toInt());
+    m_effectParameters.clear();
+    effects().removeAt(effect.attribute(QStringLiteral("kdenlive_ix")).toInt());
     effect.setAttribute(QStringLiteral("kdenlive_ix"), ix);
-    m_effectList.insert(effect);
-    m_effectNames = m_effectList.effectNames().join(QStringLiteral(" / "));
+    effects().insert(effect);
+    m_effectNames = effects().effectNames().join(QStringLiteral(" / "));
     QString id = effect.attribute(QStringLiteral("id"));
     if (id == QLatin1String("fadein") || id == QLatin1String("fadeout") || id == QLatin1String("fade_from_black") || id == QLatin1String("fade_to_black")) {
         update();
@@ -1424,6 +1498,8 @@ bool ClipItem::moveEffect(QDomElement effect, int ix)
 
 EffectsParameterList ClipItem::addEffect(ProfileInfo info, QDomElement effect, bool animate)
 {
+    // Inserting an effect shifts the indexes of the following ones
+    m_effectParameters.clear();
     bool needRepaint = false;
     QLocale locale;
     locale.setNumberOptions(QLocale::OmitGroupSeparator);
@@ -1441,11 +1517,11 @@ EffectsParameterList ClipItem::addEffect(ProfileInfo info, QDomElement effect, b
         ix = 1;
         effect.setAttribute(QStringLiteral("kdenlive_ix"), QStringLiteral("1"));
     }
-    if (!m_effectList.isEmpty() && ix <= m_effectList.count()) {
+    if (!effects().isEmpty() && ix <= effects().count()) {
         needRepaint = true;
-        insertedEffect = m_effectList.insert(effect);
+        insertedEffect = effects().insert(effect);
     } else {
-        insertedEffect = m_effectList.append(effect);
+        insertedEffect = effects().append(effect);
     }
 
     // Update index to the real one
@@ -1491,37 +1567,37 @@ EffectsParameterList ClipItem::addEffect(ProfileInfo info, QDomElement effect, b
     // check if it is a fade effect
     if (effectId == QLatin1String("fadein")) {
         needRepaint = true;
-        if (m_effectList.hasEffect(QString(), QStringLiteral("fade_from_black")) == -1) {
+        if (effects().hasEffect(QString(), QStringLiteral("fade_from_black")) == -1) {
             fade = effectOut - effectIn;
         }/* else {
-        QDomElement fadein = m_effectList.getEffectByTag(QString(), "fade_from_black");
+        QDomElement fadein = effects().getEffectByTag(QString(), "fade_from_black");
             if (fadein.attribute("name") == "out") fade += fadein.attribute("value").toInt();
             else if (fadein.attribute("name") == "in") fade -= fadein.attribute("value").toInt();
         }*/
     } else if (effectId == QLatin1String("fade_from_black")) {
         needRepaint = true;
-        if (m_effectList.hasEffect(QString(), QStringLiteral("fadein")) == -1) {
+        if (effects().hasEffect(QString(), QStringLiteral("fadein")) == -1) {
             fade = effectOut - effectIn;
         }/* else {
-        QDomElement fadein = m_effectList.getEffectByTag(QString(), "fadein");
+        QDomElement fadein = effects().getEffectByTag(QString(), "fadein");
             if (fadein.attribute("name") == "out") fade += fadein.attribute("value").toInt();
             else if (fadein.attribute("name") == "in") fade -= fadein.attribute("value").toInt();
         }*/
     } else if (effectId == QLatin1String("fadeout")) {
         needRepaint = true;
-        if (m_effectList.hasEffect(QString(), QStringLiteral("fade_to_black")) == -1) {
+        if (effects().hasEffect(QString(), QStringLiteral("fade_to_black")) == -1) {
             fade = effectIn - effectOut;
         } /*else {
-        QDomElement fadeout = m_effectList.getEffectByTag(QString(), "fade_to_black");
+        QDomElement fadeout = effects().getEffectByTag(QString(), "fade_to_black");
             if (fadeout.attribute("name") == "out") fade -= fadeout.attribute("value").toInt();
             else if (fadeout.attribute("name") == "in") fade += fadeout.attribute("value").toInt();
         }*/
     } else if (effectId == QLatin1String("fade_to_black")) {
         needRepaint = true;
-        if (m_effectList.hasEffect(QString(), QStringLiteral("fadeout")) == -1) {
+        if (effects().hasEffect(QString(), QStringLiteral("fadeout")) == -1) {
             fade = effectIn - effectOut;
         }/* else {
-        QDomElement fadeout = m_effectList.getEffectByTag(QString(), "fadeout");
+        QDomElement fadeout = effects().getEffectByTag(QString(), "fadeout");
             if (fadeout.attribute("name") == "out") fade -= fadeout.attribute("value").toInt();
             else if (fadeout.attribute("name") == "in") fade += fadeout.attribute("value").toInt();
         }*/
@@ -1584,7 +1660,7 @@ EffectsParameterList ClipItem::addEffect(ProfileInfo info, QDomElement effect, b
         parameters.addParam(QStringLiteral("out"), QString::number((int)(cropStart() + cropDuration()).frames(m_fps) - 1));
         parameters.addParam(QStringLiteral("kdenlive:sync_in_out"), QStringLiteral("1"));
     }
-    m_effectNames = m_effectList.effectNames().join(QStringLiteral(" / "));
+    m_effectNames = effects().effectNames().join(QStringLiteral(" / "));
     if (fade > 0) {
         m_startFade = fade;
     } else if (fade < 0) {
@@ -1613,9 +1689,10 @@ EffectsParameterList ClipItem::addEffect(ProfileInfo info, QDomElement effect, b
 
 bool ClipItem::deleteEffect(int ix)
 {
+    m_effectParameters.clear();
     bool needRepaint = false;
     bool isVideoEffect = false;
-    QDomElement effect = m_effectList.itemFromIndex(ix);
+    QDomElement effect = effects().itemFromIndex(ix);
     if (effect.attribute(QStringLiteral("type")) != QLatin1String("audio")) {
         isVideoEffect = true;
     }
@@ -1631,13 +1708,13 @@ bool ClipItem::deleteEffect(int ix)
     } else if (EffectsList::hasKeyFrames(effect)) {
         needRepaint = true;
     }
-    m_effectList.removeAt(ix);
-    m_effectNames = m_effectList.effectNames().join(QStringLiteral(" / "));
+    effects().removeAt(ix);
+    m_effectNames = effects().effectNames().join(QStringLiteral(" / "));
 
-    if (m_effectList.isEmpty() || m_selectedEffect == ix) {
+    if (effects().isEmpty() || m_selectedEffect == ix) {
         // Current effect was removed
-        if (ix > m_effectList.count()) {
-            setSelectedEffect(m_effectList.count());
+        if (ix > effects().count()) {
+            setSelectedEffect(effects().count());
         } else {
             setSelectedEffect(ix);
         }
@@ -1649,7 +1726,7 @@ bool ClipItem::deleteEffect(int ix)
         //r.setHeight(20);
         update(r);
     }
-    if (!m_effectList.isEmpty()) {
+    if (!effects().isEmpty()) {
         flashClip();
     }
     return isVideoEffect;
@@ -1674,6 +1751,7 @@ void ClipItem::setSpeed(const double speed, const int strobe)
     m_strobe = strobe;
     m_info.cropStart = GenTime((int)(m_speedIndependantInfo.cropStart.frames(m_fps) / qAbs(m_speed) + 0.5), m_fps);
     m_info.cropDuration = GenTime((int)(m_speedIndependantInfo.cropDuration.frames(m_fps) / qAbs(m_speed) + 0.5), m_fps);
+    updateIndex();
     //update();
 }
 
@@ -1700,8 +1778,8 @@ const ItemInfo ClipItem::speedIndependantInfo() const
 int ClipItem::nextFreeEffectGroupIndex() const
 {
     int freeGroupIndex = 0;
-    for (int i = 0; i < m_effectList.count(); ++i) {
-        QDomElement effect = m_effectList.at(i);
+    for (int i = 0; i < effects().count(); ++i) {
+        QDomElement effect = effects().at(i);
         EffectInfo effectInfo;
         effectInfo.fromString(effect.attribute(QStringLiteral("kdenlive_info")));
         if (effectInfo.groupIndex >= freeGroupIndex) {
@@ -1845,10 +1923,11 @@ void ClipItem::setState(PlaylistState::ClipState state)
 
 QMap<int, QDomElement> ClipItem::adjustEffectsToDuration(const ItemInfo &oldInfo)
 {
-    QMap<int, QDomElement> effects;
+    QMap<int, QDomElement> updatedEffects;
+    m_effectParameters.clear();
     //qCDebug(KDENLIVE_LOG)<<"Adjusting effect to duration: "<<oldInfo.cropStart.frames(25)<<" - "<<cropStart().frames(25);
-    for (int i = 0; i < m_effectList.count(); ++i) {
-        QDomElement effect = m_effectList.at(i);
+    for (int i = 0; i < effects().count(); ++i) {
+        QDomElement effect = effects().at(i);
 
         if (effect.attribute(QStringLiteral("id")).startsWith(QLatin1String("fade"))) {
             QString id = effect.attribute(QStringLiteral("id"));
@@ -1857,7 +1936,7 @@ QMap<int, QDomElement> ClipItem::adjustEffectsToDuration(const ItemInfo &oldInfo
             int clipEnd = (cropStart() + cropDuration()).frames(m_fps) - 1;
             if (id == QLatin1String("fade_from_black") || id == QLatin1String("fadein")) {
                 if (in != cropStart().frames(m_fps)) {
-                    effects[i] = effect.cloneNode().toElement();
+                    updatedEffects[i] = effect.cloneNode().toElement();
                     int duration = out - in;
                     in = cropStart().frames(m_fps);
                     out = in + duration;
@@ -1865,17 +1944,17 @@ QMap<int, QDomElement> ClipItem::adjustEffectsToDuration(const ItemInfo &oldInfo
                     EffectsList::setParameter(effect, QStringLiteral("out"), QString::number(out));
                 }
                 if (out > clipEnd) {
-                    if (!effects.contains(i)) {
-                        effects[i] = effect.cloneNode().toElement();
+                    if (!updatedEffects.contains(i)) {
+                        updatedEffects[i] = effect.cloneNode().toElement();
                     }
                     EffectsList::setParameter(effect, QStringLiteral("out"), QString::number(clipEnd));
                 }
-                if (effects.contains(i)) {
+                if (updatedEffects.contains(i)) {
                     setFadeIn(out - in);
                 }
             } else {
                 if (out != clipEnd) {
-                    effects[i] = effect.cloneNode().toElement();
+                    updatedEffects[i] = effect.cloneNode().toElement();
                     int diff = out - clipEnd;
                     in = qMax(in - diff, (int) cropStart().frames(m_fps));
                     out -= diff;
@@ -1883,18 +1962,18 @@ QMap<int, QDomElement> ClipItem::adjustEffectsToDuration(const ItemInfo &oldInfo
                     EffectsList::setParameter(effect, QStringLiteral("out"), QString::number(out));
                 }
                 if (in < cropStart().frames(m_fps)) {
-                    if (!effects.contains(i)) {
-                        effects[i] = effect.cloneNode().toElement();
+                    if (!updatedEffects.contains(i)) {
+                        updatedEffects[i] = effect.cloneNode().toElement();
                     }
                     EffectsList::setParameter(effect, QStringLiteral("in"), QString::number((int) cropStart().frames(m_fps)));
                 }
-                if (effects.contains(i)) {
+                if (updatedEffects.contains(i)) {
                     setFadeOut(out - in);
                 }
             }
             continue;
         } else if (effect.attribute(QStringLiteral("id")) == QLatin1String("freeze") && cropStart() != oldInfo.cropStart) {
-            effects[i] = effect.cloneNode().toElement();
+            updatedEffects[i] = effect.cloneNode().toElement();
             int diff = (oldInfo.cropStart - cropStart()).frames(m_fps);
             int frame = EffectsList::parameter(effect, QStringLiteral("frame")).toInt();
             EffectsList::setParameter(effect, QStringLiteral("frame"), QString::number(frame - diff));
@@ -1906,17 +1985,17 @@ QMap<int, QDomElement> ClipItem::adjustEffectsToDuration(const ItemInfo &oldInfo
             QDomElement param = params.item(j).toElement();
             QString type = param.attribute(QStringLiteral("type"));
             if (type == QLatin1String("geometry") && !param.hasAttribute(QStringLiteral("fixed"))) {
-                if (!effects.contains(i)) {
+                if (!updatedEffects.contains(i)) {
                     if (effect.attribute(QStringLiteral("sync_in_out")) == QLatin1String("1")) {
                         effect.setAttribute(QStringLiteral("in"), cropStart().frames(m_fps));
                         effect.setAttribute(QStringLiteral("out"), (cropStart() + cropDuration()).frames(m_fps) - 1);
                     }
-                    effects[i] = effect.cloneNode().toElement();
+                    updatedEffects[i] = effect.cloneNode().toElement();
                 }
                 //updateGeometryKeyframes(effect, j, oldInfo);
             } else if (type == QLatin1String("simplekeyframe") || type == QLatin1String("keyframe")) {
-                if (!effects.contains(i)) {
-                    effects[i] = effect.cloneNode().toElement();
+                if (!updatedEffects.contains(i)) {
+                    updatedEffects[i] = effect.cloneNode().toElement();
                 }
                 updateNormalKeyframes(param, oldInfo);
             } else if (type.startsWith(QLatin1String("animated"))) {
@@ -1926,10 +2005,10 @@ QMap<int, QDomElement> ClipItem::adjustEffectsToDuration(const ItemInfo &oldInfo
                 }
                 // Check if we have keyframes at in/out points
                 updateAnimatedKeyframes(i, param, oldInfo);
-                effects[i] = effect.cloneNode().toElement();
+                updatedEffects[i] = effect.cloneNode().toElement();
             } else if (type == QLatin1String("roto-spline")) {
-                if (!effects.contains(i)) {
-                    effects[i] = effect.cloneNode().toElement();
+                if (!updatedEffects.contains(i)) {
+                    updatedEffects[i] = effect.cloneNode().toElement();
                 }
                 QByteArray value = param.attribute(QStringLiteral("value")).toLatin1();
                 if (adjustRotoDuration(&value, cropStart().frames(m_fps), (cropStart() + cropDuration()).frames(m_fps) - 1)) {
@@ -1938,7 +2017,7 @@ QMap<int, QDomElement> ClipItem::adjustEffectsToDuration(const ItemInfo &oldInfo
             }
         }
     }
-    return effects;
+    return updatedEffects;
 }
 
 bool ClipItem::updateAnimatedKeyframes(int /*ix*/, const QDomElement &parameter, const ItemInfo &oldInfo)
@@ -2038,6 +2117,8 @@ bool ClipItem::updateNormalKeyframes(QDomElement parameter, const ItemInfo &oldI
 
 void ClipItem::slotRefreshClip()
 {
+    // Markers may have changed
+    updateIndex();
     update();
 }
 
@@ -2099,23 +2180,6 @@ void ClipItem::slotUpdateThumb(const QImage &img)
     update();
 }
 
-void ClipItem::updateKeyframes(const QDomElement &effect)
-{
-    QLocale locale;
-    locale.setNumberOptions(QLocale::OmitGroupSeparator);
-    // parse keyframes
-    QDomNodeList params = effect.elementsByTagName(QStringLiteral("parameter"));
-    QDomElement e = params.item(m_visibleParam).toElement();
-    if (e.isNull()) {
-        return;
-    }
-    if (e.attribute(QStringLiteral("intimeline")) != QLatin1String("1")) {
-        setSelectedEffect(m_selectedEffect);
-        return;
-    }
-    m_keyframeView.loadKeyframes(locale, e, cropStart().frames(m_fps), cropDuration().frames(m_fps));
-}
-
 bool ClipItem::hasVisibleVideo() const
 {
     return (m_clipType != Audio && m_clipState != PlaylistState::AudioOnly && m_clipState != PlaylistState::Disabled);
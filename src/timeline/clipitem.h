@@ -23,6 +23,7 @@
 #include "abstractclipitem.h"
 #include "gentime.h"
 #include "effectslist/effectslist.h"
+#include "effectslist/effectparameters.h"
 #include "mltcontroller/effectscontroller.h"
 
 #include <QTimeLine>
@@ -55,7 +56,6 @@ public:
     void resizeStart(int posx, bool size = true, bool emitChange = true) Q_DECL_OVERRIDE;
     void resizeEnd(int posx, bool emitChange = true) Q_DECL_OVERRIDE;
     OperationType operationMode(const QPointF &pos, Qt::KeyboardModifiers modifiers) Q_DECL_OVERRIDE;
-    void updateKeyframes(const QDomElement &effect) Q_DECL_OVERRIDE;
     static int itemHeight();
     ClipType clipType() const;
     const QString &getBinId() const;
@@ -66,6 +66,8 @@ public:
     QDomElement itemXml() const;
     ClipItem *clone(const ItemInfo &info) const;
     const EffectsList effectList() const;
+    /** @brief Defer the effects parsing: while pending, requestEffects() is emitted the first time the effects are needed. */
+    void setEffectsPending(bool pending);
     void setFadeOut(int pos);
     void setFadeIn(int pos);
     void setFades(int in, int out);
@@ -103,6 +105,14 @@ public:
     * @return The effect's xml */
     QDomElement getEffectAtIndex(int ix) const;
 
+    /** @brief Gets the typed parameters of an effect, parsed from its xml on first use.
+    * They are dropped whenever the effect xml changes by other means.
+    * @param ix The effect's index in effectlist (starting from 1) */
+    EffectParameters &effectParameters(int ix);
+    /** @brief Writes the modified parameters of an effect to its xml, without replacing the element.
+    * @param ix The effect's index in effectlist (starting from 1) */
+    void writeEffectParameters(int ix);
+
     /** @brief Replaces an effect.
     * @param ix The effect's index in effectlist
     * @param effect The new effect */
@@ -204,6 +214,8 @@ protected:
     //virtual void hoverEnterEvent(QGraphicsSceneHoverEvent *);
     //virtual void hoverLeaveEvent(QGraphicsSceneHoverEvent *);
     QVariant itemChange(GraphicsItemChange change, const QVariant &value) Q_DECL_OVERRIDE;
+    /** @brief Adds the clip markers to the start and end of the clip */
+    QVector<int> snapOffsets() const Q_DECL_OVERRIDE;
 
 private:
     ProjectClip *m_binClip;
@@ -231,11 +243,23 @@ private:
     double m_speed;
     int m_strobe;
 
-    EffectsList m_effectList;
+    /** @brief Never use directly, use effects() */
+    mutable EffectsList m_effectList;
     QList<Transition *> m_transitionsList;
     QMap<int, QPixmap> m_audioThumbCachePic;
     bool m_audioThumbReady;
+    /** @brief True once we asked to create our audio thumbnail first. */
+    bool m_audioThumbPrioritized;
     double m_framePixelWidth;
+    /** @brief True while the timeline did not parse the effects of this clip yet */
+    mutable bool m_effectsPending;
+    /** @brief Typed parameters of the effects being edited from the timeline, by effect index */
+    mutable QMap<int, EffectParameters> m_effectParameters;
+
+    /** @brief The effect list, loading the deferred effects first if needed */
+    EffectsList &effects() const;
+    /** @brief Gets the markers visible in the clip, relative to its start. */
+    QList<GenTime> markerOffsets(const QList<GenTime> &markers) const;
 
 private slots:
     void slotGetStartThumb();
@@ -258,6 +282,8 @@ public slots:
 
 signals:
     void updateRange();
+    /** @brief The effects of this clip were deferred and are now needed, see setEffectsPending() */
+    void requestEffects(ClipItem *item);
 };
 
 #endif
@@ -641,6 +641,11 @@ const QList<int> CustomRuler::getDirtyChunks() const
     return m_dirtyRenderingPreviews;
 }
 
+int CustomRuler::cursorPos() const
+{
+    return m_view->cursorPos();
+}
+
 bool CustomRuler::hasPreviewRange() const
 {
     return (!m_dirtyRenderingPreviews.isEmpty() || !m_renderingPreviews.isEmpty());
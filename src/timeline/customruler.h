@@ -65,6 +65,8 @@ public:
     /** @brief Refresh timeline preview range */
     void updatePreviewDisplay(int start, int end);
     bool isUnderPreview(int start, int end);
+    /** @brief Returns the current timeline cursor position, used to prioritize preview chunks */
+    int cursorPos() const;
     void hidePreview(bool hide);
 
 protected:
@@ -31,6 +31,8 @@ CustomTrackScene::CustomTrackScene(Timeline *timeline, QObject *parent) :
 
 CustomTrackScene::~CustomTrackScene()
 {
+    // Delete the items while the indexes they unregister from still exist
+    clear();
 }
 
 double CustomTrackScene::getSnapPointForPos(double pos, bool doSnap)
@@ -42,42 +44,33 @@ double CustomTrackScene::getSnapPointForPos(double pos, bool doSnap)
         } else {
             maximumOffset = 6 / m_scale.x();
         }
-        for (int i = 0; i < m_snapPoints.size(); ++i) {
-            if (qAbs((int)(pos - m_snapPoints.at(i).frames(m_timeline->fps()))) < maximumOffset) {
-                return m_snapPoints.at(i).frames(m_timeline->fps());
-            }
-            if (m_snapPoints.at(i).frames(m_timeline->fps()) > pos) {
-                break;
-            }
+        int snapPoint;
+        if (m_snapIndex.snap(pos, maximumOffset, snapPoint)) {
+            return snapPoint;
         }
     }
     return GenTime(pos, m_timeline->fps()).frames(m_timeline->fps());
 }
 
-void CustomTrackScene::setSnapList(const QList<GenTime> &snaps)
+void CustomTrackScene::setSnapContext(const QList<QGraphicsItem *> &excluded, const QList<GenTime> &offsets, const QList<GenTime> &points, const QList<GenTime> &fixedPoints)
 {
-    m_snapPoints = snaps;
+    m_snapIndex.setContext(excluded, toFrames(offsets), toFrames(points), toFrames(fixedPoints));
 }
 
 GenTime CustomTrackScene::previousSnapPoint(const GenTime &pos) const
 {
-    for (int i = 0; i < m_snapPoints.size(); ++i) {
-        if (m_snapPoints.at(i) >= pos) {
-            if (i == 0) {
-                return GenTime();
-            }
-            return m_snapPoints.at(i - 1);
-        }
+    int snapPoint;
+    if (m_snapIndex.previousPoint(qRound(pos.frames(m_timeline->fps())), snapPoint)) {
+        return GenTime(snapPoint, m_timeline->fps());
     }
     return GenTime();
 }
 
 GenTime CustomTrackScene::nextSnapPoint(const GenTime &pos) const
 {
-    foreach (const GenTime &seekPoint, m_snapPoints) {
-        if (seekPoint > pos) {
-            return seekPoint;
-        }
+    int snapPoint;
+    if (m_snapIndex.nextPoint(qRound(pos.frames(m_timeline->fps())), snapPoint)) {
+        return GenTime(snapPoint, m_timeline->fps());
     }
     return pos;
 }
@@ -114,3 +107,22 @@ TimelineMode::EditMode CustomTrackScene::editMode() const
     return m_editMode;
 }
 
+TrackItemIndex &CustomTrackScene::itemIndex()
+{
+    return m_itemIndex;
+}
+
+SnapIndex &CustomTrackScene::snapIndex()
+{
+    return m_snapIndex;
+}
+
+QVector<int> CustomTrackScene::toFrames(const QList<GenTime> &times) const
+{
+    QVector<int> frames;
+    frames.reserve(times.count());
+    for (const GenTime &time : times) {
+        frames.append(qRound(time.frames(m_timeline->fps())));
+    }
+    return frames;
+}
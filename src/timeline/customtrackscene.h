@@ -31,6 +31,8 @@
 
 #include "gentime.h"
 #include "definitions.h"
+#include "trackitemindex.h"
+#include "snapindex.h"
 
 class Timeline;
 class MltVideoProfile;
@@ -42,7 +44,8 @@ class CustomTrackScene : public QGraphicsScene
 public:
     explicit CustomTrackScene(Timeline *timeline, QObject *parent = nullptr);
     ~CustomTrackScene();
-    void setSnapList(const QList<GenTime> &snaps);
+    /** @brief Set the context of the snapping queries, see SnapIndex::setContext() */
+    void setSnapContext(const QList<QGraphicsItem *> &excluded, const QList<GenTime> &offsets, const QList<GenTime> &points, const QList<GenTime> &fixedPoints);
     GenTime previousSnapPoint(const GenTime &pos) const;
     GenTime nextSnapPoint(const GenTime &pos) const;
     double getSnapPointForPos(double pos, bool doSnap = true);
@@ -52,13 +55,19 @@ public:
     MltVideoProfile profile() const;
     void setEditMode(TimelineMode::EditMode mode);
     TimelineMode::EditMode editMode() const;
+    /** @brief Index of the clip and transition items per track, kept up to date by the items */
+    TrackItemIndex &itemIndex();
+    /** @brief Snap points of the clips, transitions and guides, kept up to date by the items */
+    SnapIndex &snapIndex();
     bool isZooming;
 
 private:
     Timeline *m_timeline;
     QPointF m_scale;
     TimelineMode::EditMode m_editMode;
-    QList<GenTime> m_snapPoints;
+    TrackItemIndex m_itemIndex;
+    SnapIndex m_snapIndex;
+    QVector<int> toFrames(const QList<GenTime> &times) const;
 };
 
 #endif
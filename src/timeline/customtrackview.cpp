@@ -378,13 +378,13 @@ bool CustomTrackView::checkTrackHeight(bool force)
         for (int i = 0; i < itemList.count(); ++i) {
             if (itemList.at(i)->type() == AVWidget) {
                 item = static_cast<ClipItem *>(itemList.at(i));
-                item->setRect(0, 0, item->rect().width(), m_tracksHeight - 1);
+                item->setItemRect(0, 0, item->rect().width(), m_tracksHeight - 1);
                 item->setPos((qreal) item->startPos().frames(m_document->fps()), getPositionFromTrack(item->track()) + 1);
                 m_scene->addItem(item);
                 item->resetFrameWidth(frameWidth);
             } else if (itemList.at(i)->type() == TransitionWidget) {
                 transitionitem = static_cast<Transition *>(itemList.at(i));
-                transitionitem->setRect(0, 0, transitionitem->rect().width(), m_tracksHeight / 3 * 2 - 1);
+                transitionitem->setItemRect(0, 0, transitionitem->rect().width(), m_tracksHeight / 3 * 2 - 1);
                 transitionitem->setPos((qreal) transitionitem->startPos().frames(m_document->fps()), getPositionFromTrack(transitionitem->track()) + transitionitem->itemOffset());
                 m_scene->addItem(transitionitem);
             }
@@ -862,7 +862,12 @@ void CustomTrackView::mousePressEvent(QMouseEvent *event)
         if (m_operationMode == KeyFrame) {
             if (m_dragItem->type() == AVWidget) {
                 ClipItem *item = static_cast<ClipItem *>(m_dragItem);
-                m_dragItem->insertKeyframe(m_document->getProfileInfo(), item->getEffectAtIndex(item->selectedEffectIndex()), m_dragItem->selectedKeyFramePos(), -1, true);
+                int ix = item->selectedEffectIndex();
+                // The undo command is pushed on release, with the keyframe move if any
+                m_keyframeEditEffect = item->selectedEffect();
+                item->insertKeyframe(m_document->getProfileInfo(), item->effectParameters(ix), item->selectedKeyFramePos(), -1, true);
+                commitEffectParameters(item, ix);
+                item->prepareKeyframeMove();
                 m_dragItem->update();
             }
         } else {
@@ -1489,18 +1494,17 @@ void CustomTrackView::mouseDoubleClickEvent(QMouseEvent *event)
         int single = m_dragItem->keyframesCount();
         double val = m_dragItem->getKeyFrameClipHeight(mapToScene(event->pos()).y() - m_dragItem->scenePos().y());
         ClipItem *item = static_cast <ClipItem *>(m_dragItem);
-        QDomElement oldEffect = item->selectedEffect().cloneNode().toElement();
+        int ix = item->selectedEffectIndex();
+        QDomElement oldEffect = item->selectedEffect();
         if (single == 1) {
-            item->insertKeyframe(m_document->getProfileInfo(), item->getEffectAtIndex(item->selectedEffectIndex()), (item->cropStart() + item->cropDuration()).frames(m_document->fps()) - 1, -1, true);
+            item->insertKeyframe(m_document->getProfileInfo(), item->effectParameters(ix), (item->cropStart() + item->cropDuration()).frames(m_document->fps()) - 1, -1, true);
         }
-        //QString previous = item->keyframes(item->selectedEffectIndex());
-        item->insertKeyframe(m_document->getProfileInfo(), item->getEffectAtIndex(item->selectedEffectIndex()), keyFramePos.frames(m_document->fps()), val);
-        //QString next = item->keyframes(item->selectedEffectIndex());
-        QDomElement newEffect = item->selectedEffect().cloneNode().toElement();
-        EditEffectCommand *command = new EditEffectCommand(this, item->track(), item->startPos(), oldEffect, newEffect, item->selectedEffectIndex(), false, false, true);
+        item->insertKeyframe(m_document->getProfileInfo(), item->effectParameters(ix), keyFramePos.frames(m_document->fps()), val);
+        commitEffectParameters(item, ix);
+        QDomElement newEffect = item->selectedEffect();
+        EditEffectCommand *command = new EditEffectCommand(this, item->track(), item->startPos(), oldEffect, newEffect, ix, false, false, true);
         m_commandStack->push(command);
-        updateEffect(item->track(), item->startPos(), item->selectedEffect());
-        emit clipItemSelected(item, item->selectedEffectIndex());
+        emit clipItemSelected(item, ix);
     } else if (m_dragItem && !m_dragItem->isItemLocked()) {
         editItemDuration();
     }
@@ -1643,26 +1647,28 @@ void CustomTrackView::displayKeyframesMenu(QPoint pos, AbstractClipItem *clip)
 void CustomTrackView::slotAttachKeyframeToEnd(bool attach)
 {
     ClipItem *item = static_cast <ClipItem *>(m_dragItem);
-    QDomElement oldEffect = item->selectedEffect().cloneNode().toElement();
-    item->attachKeyframeToEnd(item->getEffectAtIndex(item->selectedEffectIndex()), attach);
-    QDomElement newEffect = item->selectedEffect().cloneNode().toElement();
-    EditEffectCommand *command = new EditEffectCommand(this, item->track(), item->startPos(), oldEffect, newEffect, item->selectedEffectIndex(), false, false, false);
+    int ix = item->selectedEffectIndex();
+    QDomElement oldEffect = item->selectedEffect();
+    item->attachKeyframeToEnd(item->effectParameters(ix), attach);
+    commitEffectParameters(item, ix);
+    QDomElement newEffect = item->selectedEffect();
+    EditEffectCommand *command = new EditEffectCommand(this, item->track(), item->startPos(), oldEffect, newEffect, ix, false, false, false);
     m_commandStack->push(command);
-    updateEffect(item->track(), item->startPos(), item->selectedEffect());
-    emit clipItemSelected(item, item->selectedEffectIndex());
+    emit clipItemSelected(item, ix);
 }
 
 void CustomTrackView::slotEditKeyframeType(QAction *action)
 {
     int type = action->data().toInt();
     ClipItem *item = static_cast <ClipItem *>(m_dragItem);
-    QDomElement oldEffect = item->selectedEffect().cloneNode().toElement();
-    item->editKeyframeType(item->getEffectAtIndex(item->selectedEffectIndex()), type);
-    QDomElement newEffect = item->selectedEffect().cloneNode().toElement();
-    EditEffectCommand *command = new EditEffectCommand(this, item->track(), item->startPos(), oldEffect, newEffect, item->selectedEffectIndex(), false, false, false);
+    int ix = item->selectedEffectIndex();
+    QDomElement oldEffect = item->selectedEffect();
+    item->editKeyframeType(item->effectParameters(ix), type);
+    commitEffectParameters(item, ix);
+    QDomElement newEffect = item->selectedEffect();
+    EditEffectCommand *command = new EditEffectCommand(this, item->track(), item->startPos(), oldEffect, newEffect, ix, false, false, false);
     m_commandStack->push(command);
-    updateEffect(item->track(), item->startPos(), item->selectedEffect());
-    emit clipItemSelected(item, item->selectedEffectIndex());
+    emit clipItemSelected(item, ix);
 }
 
 void CustomTrackView::displayContextMenu(QPoint pos, AbstractClipItem *clip)
@@ -2562,6 +2568,42 @@ void CustomTrackView::updateEffect(int track, GenTime pos, const QDomElement &in
     }
 }
 
+QDomElement CustomTrackView::takeKeyframeEditEffect()
+{
+    QDomElement effect = m_keyframeEditEffect;
+    m_keyframeEditEffect = QDomElement();
+    return effect;
+}
+
+void CustomTrackView::commitEffectParameters(ClipItem *clip, int ix)
+{
+    EffectParameters &parameters = clip->effectParameters(ix);
+    if (!parameters.isModified()) {
+        return;
+    }
+    const bool rebuild = parameters.needsRebuild();
+    const bool refreshMonitor = clip->hasVisibleVideo() && !parameters.isAudio();
+    EffectsParameterList effectParams;
+    if (!rebuild) {
+        effectParams = parameters.modifiedArgs();
+    }
+    clip->writeEffectParameters(ix);
+    if (rebuild) {
+        effectParams = EffectsController::getEffectArgs(m_document->getProfileInfo(), clip->effectAtIndex(ix));
+    }
+    if (!m_timeline->track(clip->track())->editEffect(clip->startPos().seconds(), effectParams, false)) {
+        emit displayMessage(i18n("Problem editing effect"), ErrorMessage);
+        return;
+    }
+    if (ix == clip->selectedEffectIndex()) {
+        // make sure to update display of clip keyframes
+        clip->setSelectedEffect(ix);
+    }
+    if (refreshMonitor) {
+        monitorRefresh(clip->info(), true);
+    }
+}
+
 void CustomTrackView::updateEffectState(int track, GenTime pos, const QList<int> &effectIndexes, bool disable, bool updateEffectStack)
 {
     if (pos < GenTime()) {
@@ -3782,19 +3824,8 @@ void CustomTrackView::removeTrack(int ix)
         m_timeline->videoTarget--;
     }
 
-    //Delete composite transition
+    // Composite and mix transitions of the track are deleted with its other transitions below
     Mlt::Tractor *tractor = m_document->renderer()->lockService();
-    QScopedPointer<Mlt::Field> field(tractor->field());
-    if (m_timeline->getTrackInfo(ix).type == VideoTrack) {
-        QScopedPointer<Mlt::Transition> tr(m_timeline->transitionHandler->getTrackTransition(QStringList() << QStringLiteral("qtblend") << QStringLiteral("frei0r.cairoblend") << QStringLiteral("movit.overlay"), ix, -1));
-        if (tr) {
-            field->disconnect_service(*tr.data());
-        }
-        QScopedPointer<Mlt::Transition> mixTr(m_timeline->transitionHandler->getTrackTransition(QStringList() << QStringLiteral("mix"), ix, -1));
-        if (mixTr) {
-            field->disconnect_service(*mixTr.data());
-        }
-    }
     // Prepare groups for reload
     QDomDocument doc;
     doc.setContent(m_document->groupsXml());
@@ -4203,7 +4234,8 @@ void CustomTrackView::insertSpace(const QList<ItemInfo> &clipsToMove, const QLis
     foreach (AbstractGroupItem *grp, groupList) {
         rebuildGroup(grp);
     }
-    m_document->renderer()->mltInsertSpace(trackClipStartList, trackTransitionStartList, track, duration, offset);
+    m_timeline->transitionHandler->insertSpace(trackTransitionStartList, track, duration, offset);
+    m_document->renderer()->mltInsertSpace(trackClipStartList, track, duration, offset);
 }
 
 void CustomTrackView::deleteClip(const QString &clipId, QUndoCommand *deleteCommand)
@@ -4377,7 +4409,8 @@ void CustomTrackView::completeSpaceOperation(int track, GenTime &timeOffset, boo
             updateTrackDuration(track, command);
             m_commandStack->push(command);
             if (!fromStart) {
-                m_document->renderer()->mltInsertSpace(trackClipStartList, trackTransitionStartList, track, timeOffset, GenTime());
+                m_timeline->transitionHandler->insertSpace(trackTransitionStartList, track, timeOffset, GenTime());
+                m_document->renderer()->mltInsertSpace(trackClipStartList, track, timeOffset, GenTime());
             }
         }
     }
@@ -4394,6 +4427,18 @@ void CustomTrackView::mouseReleaseEvent(QMouseEvent *event)
 {
     if (event->button() != Qt::LeftButton) {
         QGraphicsView::mouseReleaseEvent(event);
+        if (!m_keyframeEditEffect.isNull() && m_dragItem && m_dragItem->type() == AVWidget) {
+            // Keyframe inserted with the middle button
+            ClipItem *item = static_cast<ClipItem *>(m_dragItem);
+            int ix = item->selectedEffectIndex();
+            if (item->selectedKeyFramePos() != item->originalKeyFramePos()) {
+                item->movedKeyframe(item->effectParameters(ix), item->selectedKeyFramePos(), item->originalKeyFramePos());
+                commitEffectParameters(item, ix);
+            }
+            EditEffectCommand *command = new EditEffectCommand(this, item->track(), item->startPos(), takeKeyframeEditEffect(), item->selectedEffect(), ix, false, false, true);
+            m_commandStack->push(command);
+        }
+        m_keyframeEditEffect = QDomElement();
         return;
     }
 
@@ -4423,6 +4468,7 @@ void CustomTrackView::mouseReleaseEvent(QMouseEvent *event)
         m_currentToolManager = m_toolManagers.value(AbstractToolManager::SelectType);
         m_currentToolManager->initTool(m_tracksHeight * m_scene->scale().y());
     }
+    m_keyframeEditEffect = QDomElement();
     m_moveOpMode = None;
 }
 
@@ -4973,46 +5019,38 @@ void CustomTrackView::slotUpdateClip(const QString &clipId, bool reload)
 ClipItem *CustomTrackView::getClipItemAtEnd(GenTime pos, int track)
 {
     int framepos = (int)(pos.frames(m_document->fps()));
-    QList<QGraphicsItem *> list = scene()->items(QPointF(framepos - 1, getPositionFromTrack(track) + m_tracksHeight / 2));
+    const QList<AbstractClipItem *> list = m_scene->itemIndex().itemsAt(AVWidget, framepos - 1, getPositionFromTrack(track) + m_tracksHeight / 2);
     ClipItem *clip = nullptr;
     for (int i = 0; i < list.size(); ++i) {
         if (!list.at(i)->isEnabled()) {
             continue;
         }
-        if (list.at(i)->type() == AVWidget) {
-            ClipItem *test = static_cast <ClipItem *>(list.at(i));
-            if (test->endPos() == pos) {
-                clip = test;
-            }
-            break;
+        ClipItem *test = static_cast <ClipItem *>(list.at(i));
+        if (test->endPos() == pos) {
+            clip = test;
         }
+        break;
     }
     return clip;
 }
 
 ClipItem *CustomTrackView::getClipItemAtStart(GenTime pos, int track, GenTime end)
 {
-    QList<QGraphicsItem *> list = scene()->items(QPointF(pos.frames(m_document->fps()), getPositionFromTrack(track) + m_tracksHeight / 2));
+    const QList<AbstractClipItem *> list = m_scene->itemIndex().itemsAt(AVWidget, pos.frames(m_document->fps()), getPositionFromTrack(track) + m_tracksHeight / 2);
     ClipItem *clip = nullptr;
     for (int i = 0; i < list.size(); ++i) {
         if (!list.at(i)->isEnabled()) {
-            /*ClipItem *test = static_cast <ClipItem *>(list.at(i));
-            qCDebug(KDENLIVE_LOG)<<" * * *DISABLED CLIP: "<<i<<", "<<test->startPos().frames(25);*/
             continue;
         }
-        if (list.at(i)->type() == AVWidget) {
-            ClipItem *test = static_cast <ClipItem *>(list.at(i));
-            //qCDebug(KDENLIVE_LOG)<<" * * *ENABLED CLIP: "<<i<<", "<<test->startPos().frames(25)<<" = "<<pos.frames(25);
-            if (test->startPos() == pos) {
-                if (end > GenTime()) {
-                    if (test->endPos() != end) {
-                        //qCDebug(KDENLIVE_LOG)<<" - - - -- - -NO END MATCH: "<<test->endPos().frames(25)<<" = "<< end.frames(25);
-                        continue;
-                    }
+        ClipItem *test = static_cast <ClipItem *>(list.at(i));
+        if (test->startPos() == pos) {
+            if (end > GenTime()) {
+                if (test->endPos() != end) {
+                    continue;
                 }
-                clip = test;
-                break;
             }
+            clip = test;
+            break;
         }
     }
     return clip;
@@ -5020,34 +5058,27 @@ ClipItem *CustomTrackView::getClipItemAtStart(GenTime pos, int track, GenTime en
 
 ClipItem *CustomTrackView::getMovedClipItem(const ItemInfo &info, GenTime offset, int trackOffset)
 {
-    QList<QGraphicsItem *> list = scene()->items(QPointF((info.startPos + offset).frames(m_document->fps()), getPositionFromTrack(info.track + trackOffset) + m_tracksHeight / 2));
+    const QList<AbstractClipItem *> list = m_scene->itemIndex().itemsAt(AVWidget, (info.startPos + offset).frames(m_document->fps()), getPositionFromTrack(info.track + trackOffset) + m_tracksHeight / 2);
     ClipItem *clip = nullptr;
     for (int i = 0; i < list.size(); ++i) {
-        //if (!list.at(i)->isEnabled()) continue;
-        if (list.at(i)->type() == AVWidget) {
-            ClipItem *test = static_cast <ClipItem *>(list.at(i));
-            if (test->startPos() == info.startPos) {
-                if (test->endPos() != info.endPos) {
-                    continue;
-                }
+        ClipItem *test = static_cast <ClipItem *>(list.at(i));
+        if (test->startPos() == info.startPos) {
+            if (test->endPos() != info.endPos) {
+                continue;
             }
-            clip = test;
-            break;
         }
+        clip = test;
+        break;
     }
     return clip;
 }
 
 ClipItem *CustomTrackView::getClipItemAtMiddlePoint(int pos, int track)
 {
-    const QPointF p(pos, getPositionFromTrack(track) + m_tracksHeight / 2);
-    QList<QGraphicsItem *> list = scene()->items(p);
+    const QList<AbstractClipItem *> list = m_scene->itemIndex().itemsAt(AVWidget, pos, getPositionFromTrack(track) + m_tracksHeight / 2);
     ClipItem *clip = nullptr;
     for (int i = 0; i < list.size(); ++i) {
-        if (!list.at(i)->isEnabled()) {
-            continue;
-        }
-        if (list.at(i)->type() == AVWidget) {
+        if (list.at(i)->isEnabled()) {
             clip = static_cast <ClipItem *>(list.at(i));
             break;
         }
@@ -5069,14 +5100,10 @@ ClipItem *CustomTrackView::getUpperClipItemAt(int pos)
 
 Transition *CustomTrackView::getTransitionItemAt(int pos, int track, bool alreadyMoved)
 {
-    const QPointF p(pos, getPositionFromTrack(track) + Transition::itemOffset() + 1);
-    QList<QGraphicsItem *> list = scene()->items(p);
+    const QList<AbstractClipItem *> list = m_scene->itemIndex().itemsAt(TransitionWidget, pos, getPositionFromTrack(track) + Transition::itemOffset() + 1);
     Transition *clip = nullptr;
     for (int i = 0; i < list.size(); ++i) {
-        if (!alreadyMoved && !list.at(i)->isEnabled()) {
-            continue;
-        }
-        if (list.at(i)->type() == TransitionWidget) {
+        if (alreadyMoved || list.at(i)->isEnabled()) {
             clip = static_cast <Transition *>(list.at(i));
             break;
         }
@@ -5092,40 +5119,34 @@ Transition *CustomTrackView::getTransitionItemAt(GenTime pos, int track, bool al
 Transition *CustomTrackView::getTransitionItemAtEnd(GenTime pos, int track)
 {
     int framepos = (int)(pos.frames(m_document->fps()));
-    const QPointF p(framepos - 1, getPositionFromTrack(track) + Transition::itemOffset() + 1);
-    QList<QGraphicsItem *> list = scene()->items(p);
+    const QList<AbstractClipItem *> list = m_scene->itemIndex().itemsAt(TransitionWidget, framepos - 1, getPositionFromTrack(track) + Transition::itemOffset() + 1);
     Transition *clip = nullptr;
     for (int i = 0; i < list.size(); ++i) {
         if (!list.at(i)->isEnabled()) {
             continue;
         }
-        if (list.at(i)->type() == TransitionWidget) {
-            Transition *test = static_cast <Transition *>(list.at(i));
-            if (test->endPos() == pos) {
-                clip = test;
-            }
-            break;
+        Transition *test = static_cast <Transition *>(list.at(i));
+        if (test->endPos() == pos) {
+            clip = test;
         }
+        break;
     }
     return clip;
 }
 
 Transition *CustomTrackView::getTransitionItemAtStart(GenTime pos, int track)
 {
-    const QPointF p(pos.frames(m_document->fps()), getPositionFromTrack(track) + Transition::itemOffset() + 1);
-    QList<QGraphicsItem *> list = scene()->items(p);
+    const QList<AbstractClipItem *> list = m_scene->itemIndex().itemsAt(TransitionWidget, pos.frames(m_document->fps()), getPositionFromTrack(track) + Transition::itemOffset() + 1);
     Transition *clip = nullptr;
     for (int i = 0; i < list.size(); ++i) {
         if (!list.at(i)->isEnabled()) {
             continue;
         }
-        if (list.at(i)->type() == TransitionWidget) {
-            Transition *test = static_cast <Transition *>(list.at(i));
-            if (test->startPos() == pos) {
-                clip = test;
-            }
-            break;
+        Transition *test = static_cast <Transition *>(list.at(i));
+        if (test->startPos() == pos) {
+            clip = test;
         }
+        break;
     }
     return clip;
 }
@@ -5852,142 +5873,29 @@ double CustomTrackView::getSnapPointForPos(double pos)
 
 void CustomTrackView::updateSnapPoints(AbstractClipItem *selected, QList<GenTime> offsetList, bool skipSelectedItems)
 {
-    QList<GenTime> snaps;
+    // Clips, transitions and guides keep their points in the scene's snap index,
+    // only the moved items and the points that are not items are set here
     if (selected && offsetList.isEmpty()) {
         offsetList.append(selected->cropDuration());
     }
-    QList<QGraphicsItem *> itemList = items();
-    for (int i = 0; i < itemList.count(); ++i) {
-        if (itemList.at(i) == selected) {
-            continue;
-        }
-        if (skipSelectedItems && itemList.at(i)->isSelected()) {
-            continue;
-        }
-        if (itemList.at(i)->type() == AVWidget) {
-            ClipItem *item = static_cast <ClipItem *>(itemList.at(i));
-            if (!item) {
-                continue;
-            }
-            GenTime start = item->startPos();
-            GenTime end = item->endPos();
-            if (!snaps.contains(start)) {
-                snaps.append(start);
-            }
-            if (!snaps.contains(end)) {
-                snaps.append(end);
-            }
-            if (!offsetList.isEmpty()) {
-                for (int j = 0; j < offsetList.size(); ++j) {
-                    GenTime offset = end - offsetList.at(j);
-                    if (offset > GenTime()) {
-                        if (!snaps.contains(offset)) {
-                            snaps.append(offset);
-                        }
-                        offset = start - offsetList.at(j);
-                        if (offset > GenTime() && !snaps.contains(offset)) {
-                            snaps.append(offset);
-                        }
-                    }
-                }
-            }
-            // Add clip markers
-            QList<GenTime> markers;
-            ClipController *controller = m_document->getClipController(item->getBinId());
-            if (controller) {
-                markers = item->snapMarkers(controller->snapMarkers());
-            } else {
-                qWarning("No controller!");
-            }
-            for (int j = 0; j < markers.size(); ++j) {
-                GenTime t = markers.at(j);
-                if (!snaps.contains(t)) {
-                    snaps.append(t);
-                }
-                if (!offsetList.isEmpty()) {
-                    for (int k = 0; k < offsetList.size(); ++k) {
-                        GenTime offset = t - offsetList.at(k);
-                        if (offset > GenTime() && !snaps.contains(offset)) {
-                            snaps.append(offset);
-                        }
-                    }
-                }
-            }
-        } else if (itemList.at(i)->type() == TransitionWidget) {
-            Transition *transition = static_cast <Transition *>(itemList.at(i));
-            if (!transition) {
-                continue;
-            }
-            GenTime start = transition->startPos();
-            GenTime end = transition->endPos();
-            if (!snaps.contains(start)) {
-                snaps.append(start);
-            }
-            if (!snaps.contains(end)) {
-                snaps.append(end);
-            }
-            if (!offsetList.isEmpty()) {
-                for (int j = 0; j < offsetList.size(); ++j) {
-                    GenTime offset = end - offsetList.at(j);
-                    if (offset > GenTime()) {
-                        if (!snaps.contains(offset)) {
-                            snaps.append(offset);
-                        }
-                        offset = start - offsetList.at(j);
-                        if (offset > GenTime() && !snaps.contains(offset)) {
-                            snaps.append(offset);
-                        }
-                    }
-                }
-            }
-        }
+    QList<QGraphicsItem *> excluded;
+    if (selected) {
+        excluded << selected;
     }
-
-    // add cursor position
-    GenTime pos = GenTime(m_cursorPos, m_document->fps());
-    if (!snaps.contains(pos)) {
-        snaps.append(pos);
-    }
-    if (!offsetList.isEmpty()) {
-        for (int j = 0; j < offsetList.size(); ++j) {
-            GenTime offset = pos - offsetList.at(j);
-            if (!snaps.contains(offset)) {
-                snaps.append(offset);
-            }
-        }
-    }
-
-    // add guides
-    for (int i = 0; i < m_guides.count(); ++i) {
-        GenTime cur_pos = m_guides.at(i)->position();
-        if (!snaps.contains(cur_pos)) {
-            snaps.append(cur_pos);
-        }
-        if (!offsetList.isEmpty()) {
-            for (int j = 0; j < offsetList.size(); ++j) {
-                GenTime offset = cur_pos - offsetList.at(j);
-                if (!snaps.contains(offset)) {
-                    snaps.append(offset);
-                }
-            }
-        }
+    if (skipSelectedItems) {
+        excluded << m_scene->selectedItems();
     }
+    // add cursor position
+    QList<GenTime> points;
+    points << GenTime(m_cursorPos, m_document->fps());
 
     // add render zone
     QPoint z = m_document->zone();
-    pos = GenTime(z.x(), m_document->fps());
-    if (!snaps.contains(pos)) {
-        snaps.append(pos);
-    }
-    pos = GenTime(z.y(), m_document->fps());
-    if (!snaps.contains(pos)) {
-        snaps.append(pos);
-    }
+    QList<GenTime> fixedPoints;
+    fixedPoints << GenTime(z.x(), m_document->fps()) << GenTime(z.y(), m_document->fps());
 
-    qSort(snaps);
-    m_scene->setSnapList(snaps);
-    //for (int i = 0; i < m_snapPoints.size(); ++i)
-    //    //qCDebug(KDENLIVE_LOG) << "SNAP POINT: " << m_snapPoints.at(i).frames(25);
+    // Snapping an edge of the moved items, at offset from their position, is checked for every offset
+    m_scene->setSnapContext(excluded, offsetList, points, fixedPoints);
 }
 
 void CustomTrackView::slotSeekToPreviousSnap()
@@ -7216,18 +7124,15 @@ void CustomTrackView::getClipAvailableSpace(AbstractClipItem *item, GenTime &min
 {
     minimum = GenTime();
     maximum = GenTime();
-    QList<QGraphicsItem *> selection;
-    selection = m_scene->items(QRectF(0, getPositionFromTrack(item->track()) + m_tracksHeight / 2, sceneRect().width(), 2));
+    QList<AbstractClipItem *> selection = m_scene->itemIndex().itemsIn(AVWidget, 0, sceneRect().width(), getPositionFromTrack(item->track()) + m_tracksHeight / 2);
     selection.removeAll(item);
     for (int i = 0; i < selection.count(); ++i) {
-        AbstractClipItem *clip = static_cast <AbstractClipItem *>(selection.at(i));
-        if (clip && clip->type() == AVWidget) {
-            if (clip->endPos() <= item->startPos() && clip->endPos() > minimum) {
-                minimum = clip->endPos();
-            }
-            if (clip->startPos() > item->startPos() && (clip->startPos() < maximum || maximum == GenTime())) {
-                maximum = clip->startPos();
-            }
+        AbstractClipItem *clip = selection.at(i);
+        if (clip->endPos() <= item->startPos() && clip->endPos() > minimum) {
+            minimum = clip->endPos();
+        }
+        if (clip->startPos() > item->startPos() && (clip->startPos() < maximum || maximum == GenTime())) {
+            maximum = clip->startPos();
         }
     }
 }
@@ -7236,18 +7141,16 @@ void CustomTrackView::getTransitionAvailableSpace(AbstractClipItem *item, GenTim
 {
     minimum = GenTime();
     maximum = GenTime();
-    QList<QGraphicsItem *> selection;
-    selection = m_scene->items(QRectF(0, getPositionFromTrack(item->track()) + m_tracksHeight, sceneRect().width(), 2));
+    // Transitions are indexed on the row of their track
+    QList<AbstractClipItem *> selection = m_scene->itemIndex().itemsIn(TransitionWidget, 0, sceneRect().width(), getPositionFromTrack(item->track()) + Transition::itemOffset() + 1);
     selection.removeAll(item);
     for (int i = 0; i < selection.count(); ++i) {
-        AbstractClipItem *clip = static_cast <AbstractClipItem *>(selection.at(i));
-        if (clip && clip->type() == TransitionWidget) {
-            if (clip->endPos() <= item->startPos() && clip->endPos() > minimum) {
-                minimum = clip->endPos();
-            }
-            if (clip->startPos() > item->startPos() && (clip->startPos() < maximum || maximum == GenTime())) {
-                maximum = clip->startPos();
-            }
+        AbstractClipItem *clip = selection.at(i);
+        if (clip->endPos() <= item->startPos() && clip->endPos() > minimum) {
+            minimum = clip->endPos();
+        }
+        if (clip->startPos() > item->startPos() && (clip->startPos() < maximum || maximum == GenTime())) {
+            maximum = clip->startPos();
         }
     }
 }
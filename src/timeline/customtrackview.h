@@ -91,6 +91,11 @@ public:
     void addEffect(int track, GenTime pos, const QDomElement &effect);
     void deleteEffect(int track, const GenTime &pos, const QDomElement &effect);
     void updateEffect(int track, GenTime pos, const QDomElement &insertedEffect, bool refreshEffectStack = false, bool replaceEffect = false, bool refreshMonitor = true);
+    /** @brief Apply the parameters of a clip effect edited through ClipItem::effectParameters() to MLT and to the effect xml.
+     *  Only the modified parameters are set on the MLT filter, unless the filter has to be rebuilt. */
+    void commitEffectParameters(ClipItem *clip, int ix);
+    /** @brief Returns and clears the xml of the selected effect saved before a keyframe was inserted on mouse press, so that the release pushes a single undo command. */
+    QDomElement takeKeyframeEditEffect();
     /** @brief Enable / disable a list of effects */
     void updateEffectState(int track, GenTime pos, const QList<int> &effectIndexes, bool disable, bool updateEffectStack);
     void moveEffect(int track, const GenTime &pos, const QList<int> &oldPos, const QList<int> &newPos);
@@ -450,6 +455,8 @@ private:
     /** @brief Currently running operation */
     OperationType m_moveOpMode;
     AbstractClipItem *m_dragItem;
+    /** @brief Selected effect of m_dragItem before a keyframe insertion on mouse press, the undo state of the edit completed on release */
+    QDomElement m_keyframeEditEffect;
     Guide *m_dragGuide;
     DocUndoStack *m_commandStack;
     QGraphicsItem *m_visualTip;
@@ -19,6 +19,7 @@
 
 #include "guide.h"
 #include "customtrackview.h"
+#include "customtrackscene.h"
 
 #include "kdenlivesettings.h"
 
@@ -55,6 +56,11 @@ Guide::Guide(CustomTrackView *view, const GenTime &pos, const QString &label, do
     prepareGeometryChange();
 }
 
+Guide::~Guide()
+{
+    removeSnapPoint();
+}
+
 QString Guide::label() const
 {
     return m_label;
@@ -74,6 +80,7 @@ void Guide::updateGuide(const GenTime &newPos, const QString &comment)
 {
     m_position = newPos;
     setPos(m_position.frames(m_view->fps()), 0);
+    updateSnapPoint();
     if (!comment.isEmpty()) {
         m_label = comment;
         setToolTip(m_label);
@@ -121,9 +128,29 @@ QVariant Guide::itemChange(GraphicsItemChange change, const QVariant &value)
         }
         return newPos;
     }
+    if (change == ItemSceneChange) {
+        // Leaving the scene
+        removeSnapPoint();
+    } else if (change == ItemSceneHasChanged) {
+        updateSnapPoint();
+    }
     return QGraphicsItem::itemChange(change, value);
 }
 
+void Guide::updateSnapPoint()
+{
+    if (scene()) {
+        static_cast<CustomTrackScene *>(scene())->snapIndex().setPoints(this, QVector<int>() << qRound(m_position.frames(m_view->fps())));
+    }
+}
+
+void Guide::removeSnapPoint()
+{
+    if (scene()) {
+        static_cast<CustomTrackScene *>(scene())->snapIndex().removePoints(this);
+    }
+}
+
 // virtual
 QRectF Guide::boundingRect() const
 {
@@ -35,6 +35,7 @@ class Guide : public QGraphicsLineItem
 
 public:
     Guide(CustomTrackView *view, const GenTime &pos, const QString &label, double height);
+    ~Guide();
     GenTime position() const;
     void updateGuide(const GenTime &newPos, const QString &comment = QString());
     QString label() const;
@@ -56,6 +57,9 @@ private:
     CustomTrackView *m_view;
     int m_width;
     QPen m_pen;
+    /** @brief Update the guide's point in the scene's SnapIndex */
+    void updateSnapPoint();
+    void removeSnapPoint();
 };
 
 #endif
@@ -22,10 +22,12 @@
 #include "kdenlivesettings.h"
 #include "doc/kdenlivedoc.h"
 
+#include <mlt++/Mlt.h>
 #include <KLocalizedString>
 #include <QtConcurrent>
 #include <QStandardPaths>
 #include <QProcess>
+#include <QThread>
 
 PreviewManager::PreviewManager(KdenliveDoc *doc, CustomRuler *ruler, Mlt::Tractor *tractor) : QObject()
     , m_doc(doc)
@@ -34,6 +36,10 @@ PreviewManager::PreviewManager(KdenliveDoc *doc, CustomRuler *ruler, Mlt::Tracto
     , m_previewTrack(nullptr)
     , m_initialized(false)
     , m_abortPreview(false)
+    , m_renderPosition(0)
+    , m_processedChunks(0)
+    , m_runningChunks(0)
+    , m_renderFailed(false)
 {
     m_previewGatherTimer.setSingleShot(true);
     m_previewGatherTimer.setInterval(200);
@@ -93,6 +99,7 @@ bool PreviewManager::initialize()
     m_previewTimer.setInterval(3000);
     connect(&m_previewTimer, &QTimer::timeout, this, &PreviewManager::startPreviewRender);
     connect(this, &PreviewManager::previewRender, this, &PreviewManager::gotPreviewRender);
+    connect(this, &PreviewManager::abortPreview, this, &PreviewManager::stopRenderConsumers, Qt::DirectConnection);
     connect(&m_previewGatherTimer, &QTimer::timeout, this, &PreviewManager::slotProcessDirtyChunks);
     m_initialized = true;
     return true;
@@ -348,6 +355,7 @@ void PreviewManager::addPreviewRange(bool add)
     if (add) {
         if (m_previewThread.isRunning()) {
             // just add required frames to current rendering job
+            QMutexLocker lock(&m_waitingMutex);
             m_waitingThumbs << toProcess;
         } else if (KdenliveSettings::autopreview()) {
             m_previewTimer.start();
@@ -401,67 +409,202 @@ void PreviewManager::startPreviewRender()
     if (!chunks.isEmpty()) {
         // Abort any rendering
         abortRendering();
-        m_waitingThumbs.clear();
         const QString sceneList = m_cacheDir.absoluteFilePath(QStringLiteral("preview.mlt"));
         m_doc->saveMltPlaylist(sceneList);
+        m_waitingMutex.lock();
         m_waitingThumbs = chunks;
+        m_renderPosition = m_ruler->cursorPos();
+        m_waitingMutex.unlock();
         m_previewThread = QtConcurrent::run(this, &PreviewManager::doPreviewRender, sceneList);
     }
 }
 
 void PreviewManager::doPreviewRender(const QString &scene)
 {
-    int progress;
-    int chunkSize = KdenliveSettings::timelinechunks();
     // initialize progress bar
     emit previewRender(0, QString(), 0);
-    int ct = 0;
-    qSort(m_waitingThumbs);
-    while (!m_waitingThumbs.isEmpty()) {
-        int i = m_waitingThumbs.takeFirst();
-        ct++;
-        QString fileName = QStringLiteral("%1.%2").arg(i).arg(m_extension);
-        if (m_waitingThumbs.isEmpty()) {
-            progress = 1000;
-        } else {
-            progress = (double)(ct) / (ct + m_waitingThumbs.count()) * 1000;
+    int threads = KdenliveSettings::previewthreads();
+    if (threads <= 0) {
+        threads = QThread::idealThreadCount();
+    }
+    m_waitingMutex.lock();
+    m_processedChunks = 0;
+    m_runningChunks = 0;
+    m_renderFailed = false;
+    threads = qBound(1, threads, m_waitingThumbs.count());
+    m_waitingMutex.unlock();
+    // This thread is the first worker, start the other ones in our pool
+    m_renderPool.setMaxThreadCount(qMax(1, threads - 1));
+    QList<QFuture<void> > workers;
+    for (int i = 1; i < threads; i++) {
+        workers << QtConcurrent::run(&m_renderPool, this, &PreviewManager::processChunks, scene);
+    }
+    processChunks(scene);
+    for (QFuture<void> &worker : workers) {
+        worker.waitForFinished();
+    }
+    //QFile::remove(scene);
+    m_abortPreview = false;
+}
+
+void PreviewManager::processChunks(const QString &scene)
+{
+    int chunkSize = KdenliveSettings::timelinechunks();
+    // Load the scene once for this worker and render all its chunks in process.
+    // Movit needs its own OpenGL context, so keep using melt processes with GPU processing
+    Mlt::Producer *sceneProducer = nullptr;
+    if (!KdenliveSettings::gpu_accel()) {
+        sceneProducer = new Mlt::Producer(*m_tractor->profile(), "xml", scene.toUtf8().constData());
+        if (!sceneProducer->is_valid()) {
+            delete sceneProducer;
+            sceneProducer = nullptr;
         }
-        if (m_cacheDir.exists(fileName)) {
-            // This chunk already exists
-            emit previewRender(i, m_cacheDir.absoluteFilePath(fileName), progress);
-            continue;
+    }
+    while (true) {
+        m_waitingMutex.lock();
+        if (m_waitingThumbs.isEmpty() || m_abortPreview) {
+            m_waitingMutex.unlock();
+            break;
         }
-        // Build rendering process
-        QStringList args;
-        args << scene;
-        args << QStringLiteral("in=") + QString::number(i);
-        args << QStringLiteral("out=") + QString::number(i + chunkSize - 1);
-        args << QStringLiteral("-consumer") << QStringLiteral("avformat:") + m_cacheDir.absoluteFilePath(fileName);
-        args << m_consumerParams;
-        QProcess previewProcess;
-        connect(this, &PreviewManager::abortPreview, &previewProcess, &QProcess::kill, Qt::DirectConnection);
-        previewProcess.start(KdenliveSettings::rendererpath(), args);
-        if (previewProcess.waitForStarted()) {
-            previewProcess.waitForFinished(-1);
-            if (previewProcess.exitStatus() != QProcess::NormalExit || previewProcess.exitCode() != 0) {
-                // Something went wrong
+        // Render chunks closest to the timeline cursor first
+        int index = 0;
+        int distance = qAbs(m_waitingThumbs.first() - m_renderPosition);
+        for (int j = 1; j < m_waitingThumbs.count(); j++) {
+            int dist = qAbs(m_waitingThumbs.at(j) - m_renderPosition);
+            if (dist < distance) {
+                distance = dist;
+                index = j;
+            }
+        }
+        int i = m_waitingThumbs.takeAt(index);
+        m_runningChunks++;
+        m_waitingMutex.unlock();
+
+        QString fileName = QStringLiteral("%1.%2").arg(i).arg(m_extension);
+        bool success = true;
+        QString errorMessage;
+        if (!m_cacheDir.exists(fileName)) {
+            if (sceneProducer) {
+                success = renderChunk(sceneProducer, i, i + chunkSize - 1, m_cacheDir.absoluteFilePath(fileName), errorMessage);
+            } else {
+                success = renderChunkProcess(scene, i, i + chunkSize - 1, m_cacheDir.absoluteFilePath(fileName), errorMessage);
+            }
+            if (!success) {
+                QFile::remove(m_cacheDir.absoluteFilePath(fileName));
+            }
+        }
+
+        m_waitingMutex.lock();
+        m_runningChunks--;
+        if (!success) {
+            // Stop other workers after their current chunk, only report the first failure
+            m_waitingThumbs.clear();
+            bool reported = m_renderFailed;
+            m_renderFailed = true;
+            m_waitingMutex.unlock();
+            if (!reported) {
                 if (m_abortPreview) {
                     emit previewRender(0, QString(), 1000);
                 } else {
-                    emit previewRender(i, previewProcess.readAllStandardError(), -1);
+                    emit previewRender(i, errorMessage, -1);
                 }
-                QFile::remove(m_cacheDir.absoluteFilePath(fileName));
-                break;
-            } else {
-                emit previewRender(i, m_cacheDir.absoluteFilePath(fileName), progress);
             }
-        } else {
-            emit previewRender(i, QString(), -1);
             break;
         }
+        if (m_renderFailed) {
+            // The chunk stays in the cache, but don't hide the error with a completed progress
+            m_waitingMutex.unlock();
+            break;
+        }
+        m_processedChunks++;
+        int progress;
+        if (m_waitingThumbs.isEmpty() && m_runningChunks == 0) {
+            progress = 1000;
+        } else {
+            progress = (double)(m_processedChunks) / (m_processedChunks + m_runningChunks + m_waitingThumbs.count()) * 1000;
+        }
+        m_waitingMutex.unlock();
+        emit previewRender(i, m_cacheDir.absoluteFilePath(fileName), progress);
+    }
+    delete sceneProducer;
+}
+
+bool PreviewManager::renderChunk(Mlt::Producer *sceneProducer, int in, int out, const QString &dest, QString &errorMessage)
+{
+    Mlt::Consumer *consumer = new Mlt::Consumer(*m_tractor->profile(), "avformat", dest.toUtf8().constData());
+    if (!consumer->is_valid()) {
+        delete consumer;
+        errorMessage = i18n("Cannot create consumer %1.", QStringLiteral("avformat"));
+        return false;
+    }
+    consumer->set("terminate_on_pause", 1);
+    consumer->set("real_time", -1);
+    for (const QString &param : m_consumerParams) {
+        consumer->set(param.section(QLatin1Char('='), 0, 0).toUtf8().constData(), param.section(QLatin1Char('='), 1).toUtf8().constData());
+    }
+    Mlt::Producer *cut = sceneProducer->cut(in, out);
+    consumer->connect(*cut);
+    m_waitingMutex.lock();
+    m_renderConsumers << consumer;
+    m_waitingMutex.unlock();
+    if (consumer->get_int("_kdenlive_aborted") == 0) {
+        consumer->run();
+    }
+    m_waitingMutex.lock();
+    m_renderConsumers.removeAll(consumer);
+    m_waitingMutex.unlock();
+    bool aborted = consumer->get_int("_kdenlive_aborted") == 1;
+    bool written = QFile::exists(dest);
+    if (!aborted && !written) {
+        // The avformat consumer only logs its errors, report the encoding it was asked for
+        QStringList settings;
+        for (const char *name : {"f", "vcodec", "acodec"}) {
+            if (consumer->get(name)) {
+                settings << QStringLiteral("%1=%2").arg(name, consumer->get(name));
+            }
+        }
+        errorMessage = i18n("Consumer %1 did not write %2 (%3).", QString(consumer->get("mlt_service")), dest, settings.join(QLatin1Char(' ')));
+    }
+    delete consumer;
+    delete cut;
+    if (aborted) {
+        errorMessage = i18n("Rendering aborted");
+        return false;
+    }
+    return written;
+}
+
+bool PreviewManager::renderChunkProcess(const QString &scene, int in, int out, const QString &dest, QString &errorMessage)
+{
+    // Build rendering process
+    QStringList args;
+    args << scene;
+    args << QStringLiteral("in=") + QString::number(in);
+    args << QStringLiteral("out=") + QString::number(out);
+    args << QStringLiteral("-consumer") << QStringLiteral("avformat:") + dest;
+    args << m_consumerParams;
+    QProcess previewProcess;
+    connect(this, &PreviewManager::abortPreview, &previewProcess, &QProcess::kill, Qt::DirectConnection);
+    previewProcess.start(KdenliveSettings::rendererpath(), args);
+    if (!previewProcess.waitForStarted()) {
+        return false;
+    }
+    previewProcess.waitForFinished(-1);
+    if (previewProcess.exitStatus() != QProcess::NormalExit || previewProcess.exitCode() != 0) {
+        // Something went wrong
+        errorMessage = previewProcess.readAllStandardError();
+        return false;
+    }
+    return true;
+}
+
+void PreviewManager::stopRenderConsumers()
+{
+    QMutexLocker lock(&m_waitingMutex);
+    for (Mlt::Consumer *consumer : m_renderConsumers) {
+        consumer->set("_kdenlive_aborted", 1);
+        consumer->stop();
     }
-    //QFile::remove(scene);
-    m_abortPreview = false;
 }
 
 void PreviewManager::slotProcessDirtyChunks()
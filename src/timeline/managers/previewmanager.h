@@ -26,6 +26,7 @@
 #include <QMutex>
 #include <QTimer>
 #include <QFuture>
+#include <QThreadPool>
 
 class KdenliveDoc;
 class CustomRuler;
@@ -34,6 +35,8 @@ namespace Mlt
 {
 class Tractor;
 class Playlist;
+class Producer;
+class Consumer;
 }
 
 /**
@@ -99,9 +102,28 @@ private:
     bool m_initialized;
     bool m_abortPreview;
     QList<int> m_waitingThumbs;
+    /** @brief: Protects m_waitingThumbs and the chunk counters shared by the render workers. */
+    QMutex m_waitingMutex;
     QFuture <void> m_previewThread;
+    /** @brief: Thread pool running the additional chunk render workers. */
+    QThreadPool m_renderPool;
+    /** @brief: Timeline position around which chunks are rendered first. */
+    int m_renderPosition;
+    /** @brief: Number of chunks processed / currently rendering in this render session. */
+    int m_processedChunks;
+    int m_runningChunks;
+    /** @brief: A chunk failed in this render session, its error was already reported. */
+    bool m_renderFailed;
     /** @brief: After an undo/redo, if we have preview history, use it. */
     void reloadChunks(const QList<int> &chunks);
+    /** @brief: Render worker, takes chunks from the waiting list until it is empty. */
+    void processChunks(const QString &scene);
+    /** @brief: Consumers currently rendering a chunk in process, stopped on abort. */
+    QList<Mlt::Consumer *> m_renderConsumers;
+    /** @brief: Render one chunk with an in-process avformat consumer from an already loaded scene. */
+    bool renderChunk(Mlt::Producer *sceneProducer, int in, int out, const QString &dest, QString &errorMessage);
+    /** @brief: Render one chunk with an external melt process. */
+    bool renderChunkProcess(const QString &scene, int in, int out, const QString &dest, QString &errorMessage);
 
 private slots:
     /** @brief: To avoid filling the hard drive, remove preview undo history after 5 steps. */
@@ -112,6 +134,8 @@ private slots:
     void slotRemoveInvalidUndo(int ix);
     /** @brief: When the timer collecting invalid zones is done, process. */
     void slotProcessDirtyChunks();
+    /** @brief: Stop all in-process chunk renderings. */
+    void stopRenderConsumers();
 
 public slots:
     /** @brief: Prepare and start rendering. */
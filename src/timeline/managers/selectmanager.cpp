@@ -260,7 +260,12 @@ void SelectManager::mouseRelease(QMouseEvent *event, GenTime pos)
     } else if (moveType == KeyFrame && dragItem && m_dragMoved) {
         // update the MLT effect
         ClipItem *item = static_cast <ClipItem *>(dragItem);
-        QDomElement oldEffect = item->selectedEffect().cloneNode().toElement();
+        int ix = item->selectedEffectIndex();
+        // Undo the keyframe inserted on press too, if any
+        QDomElement oldEffect = m_view->takeKeyframeEditEffect();
+        if (oldEffect.isNull()) {
+            oldEffect = item->selectedEffect();
+        }
 
         // check if we want to remove keyframe
         double val = m_view->mapToScene(event->pos()).toPoint().y();
@@ -272,16 +277,16 @@ void SelectManager::mouseRelease(QMouseEvent *event, GenTime pos)
 
         if ((val < -50 || val > 150) && item->selectedKeyFramePos() != start && item->selectedKeyFramePos() != end && item->keyframesCount() > 1) {
             //delete keyframe
-            item->removeKeyframe(item->getEffectAtIndex(item->selectedEffectIndex()), item->selectedKeyFramePos());
+            item->removeKeyframe(item->effectParameters(ix), item->selectedKeyFramePos());
         } else {
-            item->movedKeyframe(item->getEffectAtIndex(item->selectedEffectIndex()), item->selectedKeyFramePos(), item->originalKeyFramePos());
+            item->movedKeyframe(item->effectParameters(ix), item->selectedKeyFramePos(), item->originalKeyFramePos());
         }
+        // Only the edited parameters are sent to MLT
+        m_view->commitEffectParameters(item, ix);
+        QDomElement newEffect = item->selectedEffect();
 
-        QDomElement newEffect = item->selectedEffect().cloneNode().toElement();
-
-        EditEffectCommand *command = new EditEffectCommand(m_view, item->track(), item->startPos(), oldEffect, newEffect, item->selectedEffectIndex(), false, false, true);
+        EditEffectCommand *command = new EditEffectCommand(m_view, item->track(), item->startPos(), oldEffect, newEffect, ix, false, false, true);
         m_commandStack->push(command);
-        m_view->updateEffect(item->track(), item->startPos(), item->selectedEffect());
         m_view->clipItemSelected(item);
     } else if (moveType == KeyFrame && dragItem) {
         m_view->setActiveKeyframe(dragItem->selectedKeyFramePos());
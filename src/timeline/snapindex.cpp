@@ -0,0 +1,216 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent (agent@local)                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#include "snapindex.h"
+
+#include <QtGlobal>
+#include <cmath>
+
+void SnapIndex::setPoints(QGraphicsItem *owner, const QVector<int> &points)
+{
+    QHash<QGraphicsItem *, QVector<int> >::iterator it = m_owners.find(owner);
+    if (it != m_owners.end()) {
+        if (*it == points) {
+            return;
+        }
+        remove(m_points, *it);
+        *it = points;
+    } else {
+        m_owners.insert(owner, points);
+    }
+    add(m_points, points);
+}
+
+void SnapIndex::removePoints(QGraphicsItem *owner)
+{
+    QHash<QGraphicsItem *, QVector<int> >::iterator it = m_owners.find(owner);
+    if (it == m_owners.end()) {
+        return;
+    }
+    remove(m_points, *it);
+    m_owners.erase(it);
+}
+
+void SnapIndex::setContext(const QList<QGraphicsItem *> &excluded, const QVector<int> &offsets, const QVector<int> &points, const QVector<int> &fixedPoints)
+{
+    m_excluded.clear();
+    for (QGraphicsItem *item : excluded) {
+        QHash<QGraphicsItem *, QVector<int> >::const_iterator it = m_owners.constFind(item);
+        if (it != m_owners.constEnd()) {
+            add(m_excluded, *it);
+        }
+    }
+    // The moved position itself is always checked first
+    m_offsets.clear();
+    m_offsets.append(0);
+    for (int offset : offsets) {
+        if (!m_offsets.contains(offset)) {
+            m_offsets.append(offset);
+        }
+    }
+    m_contextPoints.clear();
+    add(m_contextPoints, points);
+    m_fixedPoints.clear();
+    add(m_fixedPoints, fixedPoints);
+}
+
+bool SnapIndex::snap(double pos, double range, int &result) const
+{
+    bool found = false;
+    double bestDistance = 0;
+    int point;
+    for (int offset : m_offsets) {
+        // An edge of the moved items, at pos + offset, is on a point
+        for (int pass = 0; pass < 2; ++pass) {
+            const bool indexed = pass == 0;
+            if (!nearest(indexed ? m_points : m_contextPoints, pos + offset, range, indexed, point)) {
+                continue;
+            }
+            const int candidate = point - offset;
+            if (offset != 0 && candidate <= 0) {
+                continue;
+            }
+            const double distance = qAbs(pos - candidate);
+            if (!found || distance < bestDistance) {
+                found = true;
+                bestDistance = distance;
+                result = candidate;
+            }
+        }
+    }
+    if (nearest(m_fixedPoints, pos, range, false, point)) {
+        if (!found || qAbs(pos - point) < bestDistance) {
+            found = true;
+            result = point;
+        }
+    }
+    return found;
+}
+
+bool SnapIndex::previousPoint(int pos, int &result) const
+{
+    bool found = false;
+    Points::const_iterator it = m_points.lowerBound(pos);
+    while (it != m_points.constBegin()) {
+        --it;
+        if (isValid(it)) {
+            result = it.key();
+            found = true;
+            break;
+        }
+    }
+    const Points *others[2] = { &m_contextPoints, &m_fixedPoints };
+    for (const Points *points : others) {
+        it = points->lowerBound(pos);
+        if (it != points->constBegin()) {
+            --it;
+            if (!found || it.key() > result) {
+                result = it.key();
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+bool SnapIndex::nextPoint(int pos, int &result) const
+{
+    bool found = false;
+    Points::const_iterator it = m_points.upperBound(pos);
+    while (it != m_points.constEnd()) {
+        if (isValid(it)) {
+            result = it.key();
+            found = true;
+            break;
+        }
+        ++it;
+    }
+    const Points *others[2] = { &m_contextPoints, &m_fixedPoints };
+    for (const Points *points : others) {
+        it = points->upperBound(pos);
+        if (it != points->constEnd() && (!found || it.key() < result)) {
+            result = it.key();
+            found = true;
+        }
+    }
+    return found;
+}
+
+void SnapIndex::clear()
+{
+    m_points.clear();
+    m_owners.clear();
+    m_excluded.clear();
+    m_offsets.clear();
+    m_contextPoints.clear();
+    m_fixedPoints.clear();
+}
+
+void SnapIndex::add(Points &points, const QVector<int> &values)
+{
+    for (int value : values) {
+        ++points[value];
+    }
+}
+
+void SnapIndex::remove(Points &points, const QVector<int> &values)
+{
+    for (int value : values) {
+        Points::iterator it = points.find(value);
+        if (it != points.end() && --(*it) <= 0) {
+            points.erase(it);
+        }
+    }
+}
+
+bool SnapIndex::isValid(Points::const_iterator it) const
+{
+    return it.value() > m_excluded.value(it.key(), 0);
+}
+
+bool SnapIndex::nearest(const Points &points, double pos, double range, bool checkExcluded, int &result) const
+{
+    bool found = false;
+    const Points::const_iterator first = points.lowerBound((int) std::ceil(pos));
+    // First valid point at or after pos
+    for (Points::const_iterator it = first; it != points.constEnd(); ++it) {
+        if (qAbs((int)(pos - it.key())) >= range) {
+            break;
+        }
+        if (!checkExcluded || isValid(it)) {
+            result = it.key();
+            found = true;
+            break;
+        }
+    }
+    // Last valid point before pos, if it is closer
+    Points::const_iterator it = first;
+    while (it != points.constBegin()) {
+        --it;
+        if (qAbs((int)(pos - it.key())) >= range || (found && pos - it.key() >= result - pos)) {
+            break;
+        }
+        if (!checkExcluded || isValid(it)) {
+            result = it.key();
+            found = true;
+            break;
+        }
+    }
+    return found;
+}
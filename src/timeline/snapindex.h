@@ -0,0 +1,81 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent (agent@local)                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef SNAPINDEX_H
+#define SNAPINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QVector>
+
+class QGraphicsItem;
+
+/**
+ * @class SnapIndex
+ * @brief Sorted index of the timeline snap points, in frames.
+ *
+ * Each point is counted once per item (clip, transition, guide) providing it,
+ * so that items can add, move and remove their points independently. The items
+ * update their points whenever their geometry or markers change, so starting a
+ * drag only has to set the query context (items being moved, move offsets,
+ * cursor and zone points) and the queries are binary searches.
+ */
+class SnapIndex
+{
+public:
+    /** @brief Replace the points of owner. */
+    void setPoints(QGraphicsItem *owner, const QVector<int> &points);
+    /** @brief Remove the points of owner, does nothing if it has none. */
+    void removePoints(QGraphicsItem *owner);
+    /** @brief Set the context of the following queries.
+     *  @param excluded the items whose points are ignored (the moved items)
+     *  @param offsets the distances from the moved position to the other edges of the moved items
+     *  @param points points that are not provided by an item, like the timeline cursor
+     *  @param fixedPoints points to which offsets don't apply, like the render zone */
+    void setContext(const QList<QGraphicsItem *> &excluded, const QVector<int> &offsets, const QVector<int> &points, const QVector<int> &fixedPoints);
+    /** @brief Find the snap position nearest to pos, ie. a position at which pos or pos plus an offset is a point.
+     *  @return true and set result if one is closer than range */
+    bool snap(double pos, double range, int &result) const;
+    /** @brief Find the last point before pos, returns false if there is none. */
+    bool previousPoint(int pos, int &result) const;
+    /** @brief Find the first point after pos, returns false if there is none. */
+    bool nextPoint(int pos, int &result) const;
+    void clear();
+
+private:
+    /** @brief Number of items providing each point */
+    typedef QMap<int, int> Points;
+    Points m_points;
+    QHash<QGraphicsItem *, QVector<int> > m_owners;
+    /** @brief Points of the excluded items, with the same counting as m_points */
+    Points m_excluded;
+    QVector<int> m_offsets;
+    Points m_contextPoints;
+    Points m_fixedPoints;
+
+    static void add(Points &points, const QVector<int> &values);
+    static void remove(Points &points, const QVector<int> &values);
+    /** @brief Whether the point at it is still provided once the excluded items are ignored */
+    bool isValid(Points::const_iterator it) const;
+    /** @brief Find the valid point of points nearest to pos, closer than range */
+    bool nearest(const Points &points, double pos, double range, bool checkExcluded, int &result) const;
+};
+
+#endif
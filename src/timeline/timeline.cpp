@@ -80,6 +80,8 @@ Timeline::Timeline(KdenliveDoc *doc, const QList<QAction *> &actions, const QLis
     , m_usePreview(false)
 {
     m_trackActions << actions;
+    m_effectsTimer.setInterval(0);
+    connect(&m_effectsTimer, &QTimer::timeout, this, &Timeline::slotLoadPendingEffects);
     setupUi(this);
     splitter->setStretchFactor(1, 2);
     connect(splitter, &QSplitter::splitterMoved, this, &Timeline::storeHeaderSize);
@@ -482,6 +484,8 @@ void Timeline::getTransitions()
             service = mlt_service_producer(service);
         }
     }
+    // Invalid transitions were removed or moved to another track
+    transitionHandler->invalidateIndex();
     m_doc->updateCompositionMode(compositeMode);
 }
 
@@ -1075,7 +1079,7 @@ int Timeline::loadTrack(int ix, int offset, Mlt::Playlist &playlist, int start,
         //qCDebug(KDENLIVE_LOG)<<"// Loading clip: "<<clipinfo.startPos.frames(25)<<" / "<<clipinfo.endPos.frames(25)<<"\n++++++++++++++++++++++++";
         ClipItem *item = new ClipItem(binclip, clipinfo, fps, slowInfo.speed, slowInfo.strobe, m_trackview->getFrameWidth(), true);
         connect(item, &AbstractClipItem::selectItem, m_trackview, &CustomTrackView::slotSelectItem);
-        item->setPos(clipinfo.startPos.frames(fps), KdenliveSettings::trackheight() * (visibleTracksCount() - clipinfo.track) + 1 + item->itemOffset());
+        item->setPos(info->start, KdenliveSettings::trackheight() * (visibleTracksCount() - clipinfo.track) + 1 + item->itemOffset());
         //qCDebug(KDENLIVE_LOG)<<" * * Loaded clip on tk: "<<clipinfo.track<< ", POS: "<<clipinfo.startPos.frames(fps);
         item->updateState(idString, info->producer->get_int("audio_index"), info->producer->get_int("video_index"), originalState);
         m_scene->addItem(item);
@@ -1088,12 +1092,88 @@ int Timeline::loadTrack(int ix, int offset, Mlt::Playlist &playlist, int start,
             EffectsList::setParameter(speedeffect, QStringLiteral("strobe"), QString::number(slowInfo.strobe));
             item->addEffect(m_doc->getProfileInfo(), speedeffect, false);
         }
-        // parse clip effects
-        getEffects(*clip, item);
+        // parse clip effects when they are first needed (usually when the clip is painted)
+        removeUnknownEffects(*clip);
+        if (clip->filter_count() > 0) {
+            deferEffects(item, *clip);
+        }
     }
     return playlist.get_length();
 }
 
+void Timeline::removeUnknownEffects(Mlt::Service &service)
+{
+    for (int ix = 0; ix < service.filter_count(); ++ix) {
+        QScopedPointer<Mlt::Filter> effect(service.filter(ix));
+        if (getEffectByTag(effect->get("tag"), effect->get("kdenlive_id")).isNull()) {
+            m_documentErrors.append(i18n("Effect %1:%2 not found in MLT, it was removed from this project\n", effect->get("tag"), effect->get("kdenlive_id")));
+            service.detach(*effect);
+            --ix;
+        }
+    }
+}
+
+void Timeline::deferEffects(ClipItem *item, Mlt::Producer &cut)
+{
+    m_pendingEffects.insert(item, new Mlt::Producer(cut));
+    item->setEffectsPending(true);
+    connect(item, &ClipItem::requestEffects, this, &Timeline::slotLoadClipEffects);
+    connect(item, &QObject::destroyed, this, &Timeline::slotPendingItemDestroyed);
+    if (!m_effectsTimer.isActive()) {
+        m_effectsTimer.start();
+    }
+}
+
+void Timeline::slotLoadClipEffects(ClipItem *item)
+{
+    Mlt::Producer *cut = m_pendingEffects.take(item);
+    if (cut == nullptr) {
+        return;
+    }
+    disconnect(item, &ClipItem::requestEffects, this, &Timeline::slotLoadClipEffects);
+    disconnect(item, &QObject::destroyed, this, &Timeline::slotPendingItemDestroyed);
+    item->setEffectsPending(false);
+    getEffects(*cut, item);
+    delete cut;
+}
+
+void Timeline::slotLoadPendingEffects()
+{
+    // Keep each batch short so that the timeline stays responsive
+    const int batchSize = 20;
+    QList<ClipItem *> batch;
+    const QRectF visible = m_trackview->mapToScene(m_trackview->viewport()->rect()).boundingRect();
+    const QList<QGraphicsItem *> visibleItems = m_scene->items(visible);
+    for (int i = 0; i < visibleItems.count() && batch.count() < batchSize; ++i) {
+        if (visibleItems.at(i)->type() == AVWidget) {
+            ClipItem *item = static_cast<ClipItem *>(visibleItems.at(i));
+            if (m_pendingEffects.contains(item)) {
+                batch << item;
+            }
+        }
+    }
+    QHash<QObject *, Mlt::Producer *>::const_iterator it = m_pendingEffects.constBegin();
+    while (batch.count() < batchSize && it != m_pendingEffects.constEnd()) {
+        ClipItem *item = static_cast<ClipItem *>(it.key());
+        if (!batch.contains(item)) {
+            batch << item;
+        }
+        ++it;
+    }
+    for (ClipItem *item : batch) {
+        slotLoadClipEffects(item);
+        item->update();
+    }
+    if (m_pendingEffects.isEmpty()) {
+        m_effectsTimer.stop();
+    }
+}
+
+void Timeline::slotPendingItemDestroyed(QObject *item)
+{
+    delete m_pendingEffects.take(item);
+}
+
 void Timeline::loadGuides(const QMap<double, QString> &guidesData)
 {
     QMapIterator<double, QString> i(guidesData);
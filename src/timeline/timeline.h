@@ -34,6 +34,7 @@
 #include <QGraphicsScene>
 #include <QGraphicsLineItem>
 #include <QDomElement>
+#include <QTimer>
 
 #include <mlt++/Mlt.h>
 
@@ -231,12 +232,20 @@ private:
     PreviewManager *m_timelinePreview;
     bool m_usePreview;
     QAction *m_disablePreview;
+    /** @brief Clip items whose effects are not parsed yet, with the MLT cut holding the effects */
+    QHash<QObject *, Mlt::Producer *> m_pendingEffects;
+    /** @brief Parses the pending effects in small batches when idle */
+    QTimer m_effectsTimer;
 
     void adjustTrackHeaders();
 
     void parseDocument(const QDomDocument &doc);
     int loadTrack(int ix, int offset, Mlt::Playlist &playlist, int start = 0, int end = -1, bool updateReferences = true);
     void getEffects(Mlt::Service &service, ClipItem *clip, int track = 0);
+    /** @brief Detach the effects that are not available anymore from service, without parsing the others */
+    void removeUnknownEffects(Mlt::Service &service);
+    /** @brief Postpone the parsing of the effects of cut until item needs them or the timeline is idle */
+    void deferEffects(ClipItem *item, Mlt::Producer &cut);
     void adjustDouble(QDomElement &e, const QString &value);
 
     /** @brief Adjust kdenlive effect xml parameters to the MLT value*/
@@ -280,6 +289,11 @@ private slots:
     void resizeRuler(int height);
     /** @brief The timeline track headers were resized, store width. */
     void storeHeaderSize(int pos, int index);
+    /** @brief Parse the deferred effects of a clip item, see deferEffects(). */
+    void slotLoadClipEffects(ClipItem *item);
+    /** @brief Parse a batch of deferred effects, visible clips first. */
+    void slotLoadPendingEffects();
+    void slotPendingItemDestroyed(QObject *item);
 
 signals:
     void mousePosition(int);
@@ -0,0 +1,149 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent (agent@local)                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#include "trackitemindex.h"
+#include "abstractclipitem.h"
+#include "kdenlivesettings.h"
+
+#include <algorithm>
+#include <cmath>
+
+void TrackItemIndex::updateItem(AbstractClipItem *item)
+{
+    QHash<int, Row> *rows = rowsForType(item->type());
+    if (rows == nullptr) {
+        return;
+    }
+    removeItem(item);
+    const QPointF pos = item->scenePos();
+    Location location;
+    location.type = item->type();
+    location.row = rowForPos(pos.y());
+    location.start = pos.x();
+    location.length = item->rect().width();
+    Entry entry;
+    entry.end = location.start + location.length;
+    entry.item = item;
+    Row &row = (*rows)[location.row];
+    row.entries.insert(location.start, entry);
+    row.lengths[location.length]++;
+    m_locations.insert(item, location);
+}
+
+void TrackItemIndex::removeItem(AbstractClipItem *item)
+{
+    // Don't use item->type() here, it may be called from the item's destructor
+    QHash<AbstractClipItem *, Location>::iterator location = m_locations.find(item);
+    if (location == m_locations.end()) {
+        return;
+    }
+    QHash<int, Row> *rows = rowsForType(location->type);
+    QHash<int, Row>::iterator row = rows->find(location->row);
+    if (row != rows->end()) {
+        QMultiMap<double, Entry>::iterator it = row->entries.find(location->start);
+        while (it != row->entries.end() && it.key() == location->start && it->item != item) {
+            ++it;
+        }
+        if (it != row->entries.end() && it.key() == location->start) {
+            row->entries.erase(it);
+            QMap<double, int>::iterator length = row->lengths.find(location->length);
+            if (length != row->lengths.end() && --length.value() == 0) {
+                row->lengths.erase(length);
+            }
+        }
+        if (row->entries.isEmpty()) {
+            rows->erase(row);
+        }
+    }
+    m_locations.erase(location);
+}
+
+QList<AbstractClipItem *> TrackItemIndex::itemsAt(int type, double x, double y) const
+{
+    return itemsIn(type, x, x, y);
+}
+
+QList<AbstractClipItem *> TrackItemIndex::itemsIn(int type, double start, double end, double y) const
+{
+    const QHash<int, Row> *rows = rowsForType(type);
+    if (rows == nullptr) {
+        return QList<AbstractClipItem *>();
+    }
+    QHash<int, Row>::const_iterator row = rows->constFind(rowForPos(y));
+    if (row == rows->constEnd()) {
+        return QList<AbstractClipItem *>();
+    }
+    QList<AbstractClipItem *> result = find(*row, start, end);
+    if (result.count() > 1) {
+        std::stable_sort(result.begin(), result.end(), [](AbstractClipItem * a, AbstractClipItem * b) {
+            return a->zValue() > b->zValue();
+        });
+    }
+    return result;
+}
+
+void TrackItemIndex::clear()
+{
+    m_clipRows.clear();
+    m_transitionRows.clear();
+    m_locations.clear();
+}
+
+QHash<int, TrackItemIndex::Row> *TrackItemIndex::rowsForType(int type)
+{
+    if (type == AVWidget) {
+        return &m_clipRows;
+    }
+    if (type == TransitionWidget) {
+        return &m_transitionRows;
+    }
+    return nullptr;
+}
+
+const QHash<int, TrackItemIndex::Row> *TrackItemIndex::rowsForType(int type) const
+{
+    if (type == AVWidget) {
+        return &m_clipRows;
+    }
+    if (type == TransitionWidget) {
+        return &m_transitionRows;
+    }
+    return nullptr;
+}
+
+int TrackItemIndex::rowForPos(double y)
+{
+    return (int) std::floor(y / KdenliveSettings::trackheight());
+}
+
+QList<AbstractClipItem *> TrackItemIndex::find(const Row &row, double start, double end)
+{
+    QList<AbstractClipItem *> result;
+    if (row.lengths.isEmpty()) {
+        return result;
+    }
+    // Entries starting before start - longest length cannot reach start
+    QMultiMap<double, Entry>::const_iterator it = row.entries.lowerBound(start - row.lengths.lastKey());
+    for (; it != row.entries.constEnd() && it.key() <= end; ++it) {
+        if (it->end >= start) {
+            result << it->item;
+        }
+    }
+    return result;
+}
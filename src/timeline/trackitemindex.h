@@ -0,0 +1,85 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent (agent@local)                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef TRACKITEMINDEX_H
+#define TRACKITEMINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+
+class AbstractClipItem;
+
+/**
+ * @class TrackItemIndex
+ * @brief Interval index of the clip and transition items of the timeline scene.
+ *
+ * Items are grouped by type (AVWidget or TransitionWidget) and by track row,
+ * the row being the track height slot containing the top of the item in the
+ * scene. In each group, the horizontal ranges of the items are kept in a map
+ * sorted by start, along with the count of items of each length. Inserting or
+ * removing an item is logarithmic, and the items intersecting a range are
+ * found by scanning the starts between (range start - longest item) and range end.
+ *
+ * The items update their entry whenever their scene geometry changes, see
+ * AbstractClipItem::updateIndex().
+ */
+class TrackItemIndex
+{
+public:
+    /** @brief Insert item, or move it if its geometry changed. */
+    void updateItem(AbstractClipItem *item);
+    /** @brief Remove item from the index, does nothing if it is not indexed. */
+    void removeItem(AbstractClipItem *item);
+    /** @brief Returns the items of type whose row contains the scene ordinate y and whose range contains x,
+     *  topmost first (like QGraphicsScene::items()). */
+    QList<AbstractClipItem *> itemsAt(int type, double x, double y) const;
+    /** @brief Returns the items of type whose row contains y and whose range intersects [start, end], topmost first. */
+    QList<AbstractClipItem *> itemsIn(int type, double start, double end, double y) const;
+    void clear();
+
+private:
+    struct Entry {
+        double end;
+        AbstractClipItem *item;
+    };
+    struct Row {
+        /** @brief Entries keyed by their start */
+        QMultiMap<double, Entry> entries;
+        /** @brief Number of entries of each length, the last key is the longest item */
+        QMap<double, int> lengths;
+    };
+    struct Location {
+        int type;
+        int row;
+        double start;
+        double length;
+    };
+    QHash<int, Row> m_clipRows;
+    QHash<int, Row> m_transitionRows;
+    QHash<AbstractClipItem *, Location> m_locations;
+
+    QHash<int, Row> *rowsForType(int type);
+    const QHash<int, Row> *rowsForType(int type) const;
+    static int rowForPos(double y);
+    /** @brief Collect the items of row intersecting [start, end] */
+    static QList<AbstractClipItem *> find(const Row &row, double start, double end);
+};
+
+#endif
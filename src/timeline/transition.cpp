@@ -43,7 +43,7 @@ Transition::Transition(const ItemInfo &info, int transitiontrack, double fps, co
     m_info.cropDuration = info.endPos - info.startPos;
     if (QApplication::style()->styleHint(QStyle::SH_Widget_Animate, nullptr, QApplication::activeWindow())) {
         // animation disabled
-        setRect(0, 0, m_info.cropDuration.frames(fps) - 0.02, (qreal) itemHeight());
+        setItemRect(0, 0, m_info.cropDuration.frames(fps) - 0.02, (qreal) itemHeight());
     } else {
         QPropertyAnimation *startAnimation = new QPropertyAnimation(this, "rect");
         startAnimation->setDuration(200);
@@ -343,7 +343,7 @@ QVariant Transition::itemChange(GraphicsItemChange change, const QVariant &value
         ////qCDebug(KDENLIVE_LOG)<<"// ITEM NEW POS: "<<newPos.x()<<", mapped: "<<mapToScene(newPos.x(), 0).x();
         return newPos;
     }
-    return QGraphicsItem::itemChange(change, value);
+    return AbstractClipItem::itemChange(change, value);
 }
 
 OperationType Transition::operationMode(const QPointF &pos, Qt::KeyboardModifiers)
@@ -508,10 +508,6 @@ bool Transition::updateKeyframes(const ItemInfo &oldInfo, const ItemInfo &newInf
     return true;
 }
 
-void Transition::updateKeyframes(const QDomElement &/*effect*/)
-{
-}
-
 //virtual
 void Transition::dragEnterEvent(QGraphicsSceneDragDropEvent *event)
 {
@@ -55,7 +55,6 @@ public:
     QString transitionTag() const;
     QStringList transitionInfo() const;
     OperationType operationMode(const QPointF &pos, Qt::KeyboardModifiers modifiers) Q_DECL_OVERRIDE;
-    void updateKeyframes(const QDomElement &effect) Q_DECL_OVERRIDE;
     static int itemHeight();
     static int itemOffset();
     //const QMap< QString, QString > transitionParameters() const;
@@ -202,6 +202,7 @@ void TransitionHandler::plantTransition(Mlt::Field *field, Mlt::Transition &tr,
             //new_trans_props.inherit(trans_props);
             cloneProperties(new_trans_props, trans_props);
             trList.append(cp);
+            m_index.remove(transition);
             field->disconnect_service(transition);
         }
         //else qCDebug(KDENLIVE_LOG) << "// FOUND TRANS OK, "<<resource<< ", A_: " << aTrack << ", B_ "<<bTrack;
@@ -214,11 +215,13 @@ void TransitionHandler::plantTransition(Mlt::Field *field, Mlt::Transition &tr,
         resource = mlt_properties_get(properties, "mlt_service");
     }
     field->plant_transition(tr, a_track, b_track);
+    m_index.add(tr);
 
     // re-add upper transitions
     for (int i = trList.count() - 1; i >= 0; --i) {
         ////qCDebug(KDENLIVE_LOG)<< "REPLANT ON TK: "<<trList.at(i)->get_a_track()<<", "<<trList.at(i)->get_b_track();
         field->plant_transition(*trList.at(i), trList.at(i)->get_a_track(), trList.at(i)->get_b_track());
+        m_index.add(*trList.at(i));
     }
     qDeleteAll(trList);
 }
@@ -253,23 +256,17 @@ void TransitionHandler::updateTransitionParams(const QString &type, int a_track,
 {
     QScopedPointer<Mlt::Field> field(m_tractor->field());
     field->lock();
+    ensureIndex();
     double fps = m_tractor->get_fps();
-    mlt_service nextservice = mlt_service_get_producer(field->get_service());
-    mlt_properties properties = MLT_SERVICE_PROPERTIES(nextservice);
-    QString resource = mlt_properties_get(properties, "mlt_service");
     int in_pos = (int) in.frames(fps);
     int out_pos = (int) out.frames(fps) - 1;
 
-    mlt_service_type mlt_type = mlt_service_identify(nextservice);
-    while (mlt_type == transition_type) {
-        mlt_transition tr = (mlt_transition) nextservice;
-        int currentTrack = mlt_transition_get_b_track(tr);
-        int currentBTrack = mlt_transition_get_a_track(tr);
-        int currentIn = (int) mlt_transition_get_in(tr);
-        int currentOut = (int) mlt_transition_get_out(tr);
-
-        // //qCDebug(KDENLIVE_LOG)<<"Looking for transition : " << currentIn <<'x'<<currentOut<< ", OLD oNE: "<<in_pos<<'x'<<out_pos;
-        if (resource == type && b_track == currentTrack && currentIn == in_pos && currentOut == out_pos) {
+    const QList<TransitionIndex::Entry> candidates = m_index.at(b_track, in_pos);
+    for (const TransitionIndex::Entry &entry : candidates) {
+        // //qCDebug(KDENLIVE_LOG)<<"Looking for transition : " << entry.in <<'x'<<entry.out<< ", OLD oNE: "<<in_pos<<'x'<<out_pos;
+        if (entry.service == type && entry.in == in_pos && entry.out == out_pos) {
+            mlt_transition tr = entry.transition->get_transition();
+            int currentBTrack = mlt_transition_get_a_track(tr);
             QMap<QString, QString> map = getTransitionParamsFromXml(xml);
             QMap<QString, QString>::Iterator it;
             QString key;
@@ -305,13 +302,6 @@ void TransitionHandler::updateTransitionParams(const QString &type, int a_track,
             }
             break;
         }
-        nextservice = mlt_service_producer(nextservice);
-        if (nextservice == nullptr) {
-            break;
-        }
-        properties = MLT_SERVICE_PROPERTIES(nextservice);
-        mlt_type = mlt_service_identify(nextservice);
-        resource = mlt_properties_get(properties, "mlt_service");
     }
     field->unlock();
     //askForRefresh();
@@ -322,34 +312,20 @@ bool TransitionHandler::deleteTransition(const QString &tag, int /*a_track*/, in
 {
     QScopedPointer<Mlt::Field> field(m_tractor->field());
     field->lock();
-    mlt_service nextservice = mlt_service_get_producer(field->get_service());
-    mlt_properties properties = MLT_SERVICE_PROPERTIES(nextservice);
-    QString resource = mlt_properties_get(properties, "mlt_service");
+    ensureIndex();
     double fps = m_tractor->get_fps();
     const int old_pos = (int)((in + out).frames(fps) / 2);
     bool found = false;
     ////qCDebug(KDENLIVE_LOG) << " del trans pos: " << in.frames(25) << '-' << out.frames(25);
 
-    mlt_service_type mlt_type = mlt_service_identify(nextservice);
-    while (mlt_type == transition_type) {
-        mlt_transition tr = (mlt_transition) nextservice;
-        int currentTrack = mlt_transition_get_b_track(tr);
-        int currentIn = (int) mlt_transition_get_in(tr);
-        int currentOut = (int) mlt_transition_get_out(tr);
-        ////qCDebug(KDENLIVE_LOG) << "// FOUND EXISTING TRANS, IN: " << currentIn << ", OUT: " << currentOut << ", TRACK: " << currentTrack;
-
-        if (resource == tag && b_track == currentTrack && currentIn <= old_pos && currentOut >= old_pos) {
+    const QList<TransitionIndex::Entry> candidates = m_index.at(b_track, old_pos);
+    for (const TransitionIndex::Entry &entry : candidates) {
+        if (entry.service == tag) {
             found = true;
-            mlt_field_disconnect_service(field->get_field(), nextservice);
+            m_index.remove(*entry.transition);
+            field->disconnect_service(*entry.transition);
             break;
         }
-        nextservice = mlt_service_producer(nextservice);
-        if (nextservice == nullptr) {
-            break;
-        }
-        properties = MLT_SERVICE_PROPERTIES(nextservice);
-        mlt_type = mlt_service_identify(nextservice);
-        resource = mlt_properties_get(properties, "mlt_service");
     }
     field->unlock();
     //askForRefresh();
@@ -360,19 +336,10 @@ bool TransitionHandler::deleteTransition(const QString &tag, int /*a_track*/, in
 void TransitionHandler::deleteTrackTransitions(int ix)
 {
     QScopedPointer<Mlt::Field> field(m_tractor->field());
-    mlt_service nextservice = mlt_service_get_producer(field->get_service());
-    mlt_service_type type = mlt_service_identify(nextservice);
-    while (type == transition_type) {
-        Mlt::Transition transition((mlt_transition) nextservice);
-        nextservice = mlt_service_producer(nextservice);
-        int currentTrack = transition.get_b_track();
-        if (ix == currentTrack) {
-            field->disconnect_service(transition);
-        }
-        if (nextservice == nullptr) {
-            break;
-        }
-        type = mlt_service_identify(nextservice);
+    ensureIndex();
+    const TransitionIndex::Track transitions = m_index.takeTransitions(ix);
+    for (const TransitionIndex::Entry &entry : transitions) {
+        field->disconnect_service(*entry.transition);
     }
 }
 
@@ -389,21 +356,15 @@ bool TransitionHandler::moveTransition(const QString &type, int startTrack, int
 
     QScopedPointer<Mlt::Field> field(m_tractor->field());
     field->lock();
-    mlt_service nextservice = mlt_service_get_producer(field->get_service());
-    mlt_properties properties = MLT_SERVICE_PROPERTIES(nextservice);
-    QString resource = mlt_properties_get(properties, "mlt_service");
+    ensureIndex();
     int old_pos = (int)(old_in + old_out) / 2;
     bool found = false;
-    mlt_service_type mlt_type = mlt_service_identify(nextservice);
-    while (mlt_type == transition_type) {
-        Mlt::Transition transition((mlt_transition) nextservice);
-        nextservice = mlt_service_producer(nextservice);
-        int currentTrack = transition.get_b_track();
-        int currentIn = (int) transition.get_in();
-        int currentOut = (int) transition.get_out();
-
-        if (resource == type && startTrack == currentTrack && currentIn <= old_pos && currentOut >= old_pos) {
+    const QList<TransitionIndex::Entry> candidates = m_index.at(startTrack, old_pos);
+    for (const TransitionIndex::Entry &entry : candidates) {
+        if (entry.service == type) {
             found = true;
+            Mlt::Transition &transition = *entry.transition;
+            m_index.remove(transition);
             if (newTrack - startTrack != 0) {
                 Mlt::Properties trans_props(transition.get_properties());
                 Mlt::Transition new_transition(*m_tractor->profile(), transition.get("mlt_service"));
@@ -415,15 +376,10 @@ bool TransitionHandler::moveTransition(const QString &type, int startTrack, int
                 plantTransition(field.data(), new_transition, newTransitionTrack, newTrack);
             } else {
                 transition.set_in_and_out(new_in, new_out);
+                m_index.add(transition);
             }
             break;
         }
-        if (nextservice == nullptr) {
-            break;
-        }
-        properties = MLT_SERVICE_PROPERTIES(nextservice);
-        mlt_type = mlt_service_identify(nextservice);
-        resource = mlt_properties_get(properties, "mlt_service");
     }
     field->unlock();
     //if (m_isBlocked == 0) m_mltConsumer->set("refresh", 1);
@@ -432,46 +388,60 @@ bool TransitionHandler::moveTransition(const QString &type, int startTrack, int
 
 Mlt::Transition *TransitionHandler::getTransition(const QString &name, int b_track, int a_track, bool internalTransition) const
 {
-    QScopedPointer<Mlt::Service> service(m_tractor->field());
-    while (service && service->is_valid()) {
-        if (service->type() == transition_type) {
-            Mlt::Transition t((mlt_transition) service->get_service());
-            if (name == t.get("mlt_service") && t.get_b_track() == b_track) {
-                if (a_track == -1 || t.get_a_track() == a_track) {
-                    int internal = t.get_int("internal_added");
-                    if (internal == 0) {
-                        if (!internalTransition) {
-                            return new Mlt::Transition(t);
-                        }
-                    } else if (internalTransition) {
+    ensureIndex();
+    const TransitionIndex::Track transitions = m_index.transitions(b_track);
+    for (const TransitionIndex::Entry &entry : transitions) {
+        if (name == entry.service) {
+            Mlt::Transition &t = *entry.transition;
+            if (a_track == -1 || t.get_a_track() == a_track) {
+                int internal = t.get_int("internal_added");
+                if (internal == 0) {
+                    if (!internalTransition) {
                         return new Mlt::Transition(t);
                     }
+                } else if (internalTransition) {
+                    return new Mlt::Transition(t);
                 }
             }
         }
-        service.reset(service->producer());
     }
     return nullptr;
 }
 
 Mlt::Transition *TransitionHandler::getTrackTransition(const QStringList &names, int b_track, int a_track) const
 {
-    QScopedPointer<Mlt::Service> service(m_tractor->field());
-    while (service && service->is_valid()) {
-        if (service->type() == transition_type) {
-            Mlt::Transition t((mlt_transition) service->get_service());
-            int internal = t.get_int("internal_added");
-            if (internal >= 200) {
-                if (names.contains(t.get("mlt_service")) && t.get_b_track() == b_track && (a_track == -1 || t.get_a_track() == a_track)) {
-                    return new Mlt::Transition(t);
-                }
+    ensureIndex();
+    const TransitionIndex::Track transitions = m_index.transitions(b_track);
+    for (const TransitionIndex::Entry &entry : transitions) {
+        Mlt::Transition &t = *entry.transition;
+        int internal = t.get_int("internal_added");
+        if (internal >= 200) {
+            if (names.contains(entry.service) && (a_track == -1 || t.get_a_track() == a_track)) {
+                return new Mlt::Transition(t);
             }
         }
-        service.reset(service->producer());
     }
     return nullptr;
 }
 
+void TransitionHandler::insertSpace(const QMap<int, int> &trackTransitionStartList, int track, const GenTime &duration, const GenTime &timeOffset)
+{
+    double fps = m_tractor->get_fps();
+    int diff = duration.frames(fps);
+    int offset = timeOffset.frames(fps);
+    QScopedPointer<Mlt::Field> field(m_tractor->field());
+    field->lock();
+    ensureIndex();
+    const QList<int> tracks = track != -1 ? QList<int>() << track : m_index.tracks();
+    for (int ix : tracks) {
+        int insertPos = trackTransitionStartList.value(ix);
+        if (insertPos != -1) {
+            m_index.shift(ix, insertPos + offset, diff);
+        }
+    }
+    field->unlock();
+}
+
 void TransitionHandler::duplicateTransitionOnPlaylist(int in, int out, const QString &tag, const QDomElement &xml, int a_track, int b_track, Mlt::Field *field)
 {
     QMap<QString, QString> args = getTransitionParamsFromXml(xml);
@@ -593,6 +563,8 @@ void TransitionHandler::enableMultiTrack(bool enable)
         }
     }
     field->unlock();
+    // The split view transitions were planted directly in the field
+    m_index.invalidate();
     emit refresh();
 }
 
@@ -637,6 +609,8 @@ void TransitionHandler::rebuildTransitions(int mode, const QList<int> &videoTrac
         }
         service.reset(service->producer());
     }
+    // The compositing transitions are planted directly in the field
+    m_index.invalidate();
     // Rebuild audio mix
     for (int i = 1; i < maxTrack; i++) {
         Mlt::Transition transition(*m_tractor->profile(), "mix");
@@ -680,3 +654,16 @@ void TransitionHandler::rebuildTransitions(int mode, const QList<int> &videoTrac
     field->unlock();
     delete field;
 }
+
+void TransitionHandler::invalidateIndex()
+{
+    m_index.invalidate();
+}
+
+void TransitionHandler::ensureIndex() const
+{
+    if (!m_index.isValid()) {
+        QScopedPointer<Mlt::Field> field(m_tractor->field());
+        m_index.build(*field);
+    }
+}
@@ -27,6 +27,7 @@
 #define TRANSITIONHANDLER_H
 
 #include "definitions.h"
+#include "transitionindex.h"
 #include <mlt++/Mlt.h>
 
 class TransitionHandler : public QObject
@@ -47,6 +48,9 @@ public:
     void deleteTrackTransitions(int ix);
     bool moveTransition(const QString &type, int startTrack,  int newTrack, int newTransitionTrack, GenTime oldIn, GenTime oldOut, GenTime newIn, GenTime newOut);
     QList<TransitionInfo> mltInsertTrack(int ix, const QString &name, bool videoTrack);
+    /** @brief Move the transitions after the insert positions of trackTransitionStartList when inserting or removing space.
+     *  @param track the track where space is inserted, or -1 for all tracks */
+    void insertSpace(const QMap<int, int> &trackTransitionStartList, int track, const GenTime &duration, const GenTime &timeOffset);
     void duplicateTransitionOnPlaylist(int in, int out, const QString &tag, const QDomElement &xml, int a_track, int b_track, Mlt::Field *field);
     /** @brief Get a transition with tag name. */
     Mlt::Transition *getTransition(const QString &name, int b_track, int a_track = -1, bool internalTransition = false) const;
@@ -60,9 +64,15 @@ public:
     static const QString compositeTransition();
     /** @brief Initialize transition settings. */
     void initTransition(const QDomElement &xml);
+    /** @brief Discard the transition index, to be called after changing the timeline transitions without the handler. */
+    void invalidateIndex();
 
 private:
     Mlt::Tractor *m_tractor;
+    /** @brief Transitions of the timeline field, built on first use */
+    mutable TransitionIndex m_index;
+    /** @brief Build the transition index if it was invalidated. */
+    void ensureIndex() const;
 
 signals:
     void refresh();
@@ -0,0 +1,182 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent (agent@local)                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#include "transitionindex.h"
+
+#include <algorithm>
+
+static bool entryBefore(const TransitionIndex::Entry &a, const TransitionIndex::Entry &b)
+{
+    return a.in < b.in;
+}
+
+TransitionIndex::TransitionIndex() :
+    m_valid(false)
+{
+}
+
+bool TransitionIndex::isValid() const
+{
+    return m_valid;
+}
+
+void TransitionIndex::build(Mlt::Field &field)
+{
+    m_tracks.clear();
+    mlt_service nextservice = mlt_service_get_producer(field.get_service());
+    while (nextservice != nullptr && mlt_service_identify(nextservice) == transition_type) {
+        Mlt::Transition transition((mlt_transition) nextservice);
+        m_tracks[transition.get_b_track()].append(entry(transition));
+        nextservice = mlt_service_producer(nextservice);
+    }
+    // Keep the chain order for transitions starting at the same frame
+    for (QHash<int, Track>::iterator it = m_tracks.begin(); it != m_tracks.end(); ++it) {
+        std::stable_sort(it->begin(), it->end(), entryBefore);
+        updateMaxOut(*it, 0);
+    }
+    m_valid = true;
+}
+
+void TransitionIndex::invalidate()
+{
+    m_tracks.clear();
+    m_valid = false;
+}
+
+void TransitionIndex::add(Mlt::Transition &transition)
+{
+    if (!m_valid) {
+        return;
+    }
+    const Entry newEntry = entry(transition);
+    Track &track = m_tracks[transition.get_b_track()];
+    const int index = std::upper_bound(track.constBegin(), track.constEnd(), newEntry, entryBefore) - track.constBegin();
+    track.insert(index, newEntry);
+    updateMaxOut(track, index);
+}
+
+void TransitionIndex::remove(Mlt::Transition &transition)
+{
+    if (!m_valid) {
+        return;
+    }
+    const mlt_transition service = transition.get_transition();
+    QHash<int, Track>::iterator track = m_tracks.find(transition.get_b_track());
+    if (track != m_tracks.end()) {
+        int index = std::lower_bound(track->constBegin(), track->constEnd(), transition.get_in(), [](const Entry & entry, int value) {
+            return entry.in < value;
+        }) - track->constBegin();
+        while (index < track->count() && track->at(index).transition->get_transition() != service) {
+            ++index;
+        }
+        if (index == track->count()) {
+            // The range changed since the transition was indexed
+            index = 0;
+            while (index < track->count() && track->at(index).transition->get_transition() != service) {
+                ++index;
+            }
+        }
+        if (index < track->count()) {
+            track->remove(index);
+            updateMaxOut(*track, index);
+            if (track->isEmpty()) {
+                m_tracks.erase(track);
+            }
+        }
+    }
+}
+
+QList<TransitionIndex::Entry> TransitionIndex::at(int track, int pos) const
+{
+    QList<Entry> result;
+    const Track current = m_tracks.value(track);
+    for (int i = firstEndingFrom(current, pos); i < current.count() && current.at(i).in <= pos; ++i) {
+        if (current.at(i).out >= pos) {
+            result << current.at(i);
+        }
+    }
+    return result;
+}
+
+TransitionIndex::Track TransitionIndex::transitions(int track) const
+{
+    return m_tracks.value(track);
+}
+
+TransitionIndex::Track TransitionIndex::takeTransitions(int track)
+{
+    return m_tracks.take(track);
+}
+
+QList<int> TransitionIndex::tracks() const
+{
+    return m_tracks.keys();
+}
+
+void TransitionIndex::shift(int track, int pos, int diff)
+{
+    QHash<int, Track>::iterator current = m_tracks.find(track);
+    if (current == m_tracks.end()) {
+        return;
+    }
+    const int first = firstEndingFrom(*current, pos + 1);
+    for (int i = first; i < current->count(); ++i) {
+        Entry &candidate = (*current)[i];
+        // Audio mixes cover the whole track
+        if (candidate.out > pos && candidate.service != QLatin1String("mix")) {
+            candidate.in += diff;
+            candidate.out += diff;
+            candidate.transition->set_in_and_out(candidate.in, candidate.out);
+        }
+    }
+    // Overlapping transitions may have passed each other
+    if (!std::is_sorted(current->constBegin() + qMax(0, first - 1), current->constEnd(), entryBefore)) {
+        std::stable_sort(current->begin(), current->end(), entryBefore);
+        updateMaxOut(*current, 0);
+    } else {
+        updateMaxOut(*current, first);
+    }
+}
+
+TransitionIndex::Entry TransitionIndex::entry(Mlt::Transition &transition)
+{
+    Entry result;
+    result.in = transition.get_in();
+    result.out = transition.get_out();
+    result.maxOut = result.out;
+    result.service = QString(transition.get("mlt_service"));
+    result.transition = QSharedPointer<Mlt::Transition>(new Mlt::Transition(transition));
+    return result;
+}
+
+void TransitionIndex::updateMaxOut(Track &track, int index)
+{
+    for (int i = index; i < track.count(); ++i) {
+        Entry &current = track[i];
+        current.maxOut = i > 0 ? qMax(track.at(i - 1).maxOut, current.out) : current.out;
+    }
+}
+
+int TransitionIndex::firstEndingFrom(const Track &track, int pos)
+{
+    // The running maximum of the out points is sorted
+    return std::lower_bound(track.constBegin(), track.constEnd(), pos, [](const Entry & entry, int value) {
+        return entry.maxOut < value;
+    }) - track.constBegin();
+}
@@ -0,0 +1,89 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by agent (agent@local)                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef TRANSITIONINDEX_H
+#define TRANSITIONINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+#include <mlt++/Mlt.h>
+
+/**
+ * @class TransitionIndex
+ * @brief Index of the MLT transitions planted in the timeline field.
+ *
+ * Transitions are grouped by b_track and kept sorted by in point with the
+ * running maximum of their out points, so that the transitions at a position
+ * or ending after a position are found with binary searches instead of
+ * walking the whole service chain.
+ *
+ * The index is built from the field on first use and then maintained by
+ * TransitionHandler, which plants and disconnects the transitions. Code
+ * changing the field directly has to invalidate it.
+ */
+class TransitionIndex
+{
+public:
+    struct Entry {
+        int in;
+        int out;
+        /** @brief Maximum out of this entry and all the entries before it */
+        int maxOut;
+        QString service;
+        QSharedPointer<Mlt::Transition> transition;
+    };
+    typedef QVector<Entry> Track;
+
+    TransitionIndex();
+    bool isValid() const;
+    /** @brief Index all the transitions of field. */
+    void build(Mlt::Field &field);
+    /** @brief Drop all entries, the index has to be built again before use. */
+    void invalidate();
+    /** @brief Add a transition just planted in the field. */
+    void add(Mlt::Transition &transition);
+    /** @brief Remove a transition, before it is disconnected or its range or track changes. */
+    void remove(Mlt::Transition &transition);
+    /** @brief Returns the transitions of track whose range contains pos, sorted by in point. */
+    QList<Entry> at(int track, int pos) const;
+    /** @brief Returns the transitions of track, sorted by in point. */
+    Track transitions(int track) const;
+    /** @brief Remove and return all the transitions of track. */
+    Track takeTransitions(int track);
+    /** @brief Returns the tracks having transitions. */
+    QList<int> tracks() const;
+    /** @brief Move the transitions of track ending after pos by diff frames, except the audio mixes. */
+    void shift(int track, int pos, int diff);
+
+private:
+    QHash<int, Track> m_tracks;
+    bool m_valid;
+
+    static Entry entry(Mlt::Transition &transition);
+    /** @brief Recompute the running maximum of the out points from index */
+    static void updateMaxOut(Track &track, int index);
+    /** @brief Returns the position of the first entry of track that may end at or after pos */
+    static int firstEndingFrom(const Track &track, int pos);
+};
+
+#endif
@@ -20,6 +20,8 @@
 #include "kdenlivesettings.h"
 #include "doc/kthumb.h"
 #include "renderer.h"
+#include "monitor/scopes/sharedframe.h"
+#include "scopes/colorscopes/scopekernels.h"
 #include "KoSliderCombo.h"
 #include "utils/KoIconUtils.h"
 
@@ -205,6 +207,7 @@ TitleWidget::TitleWidget(const QUrl &url, const Timecode &tc, const QString &pro
     connect(origin_y_top, &QAbstractButton::clicked, this, &TitleWidget::slotOriginYClicked);
 
     connect(render, &AbstractRender::frameUpdated, this, &TitleWidget::slotGotBackground);
+    connect(render, &AbstractRender::sharedFrameUpdated, this, &TitleWidget::slotGotSharedBackground);
 
     // Position and size
     m_signalMapper = new QSignalMapper(this);
@@ -867,6 +870,17 @@ void TitleWidget::slotGotBackground(const QImage &img)
     emit requestBackgroundFrame(m_clipId, false);
 }
 
+void TitleWidget::slotGotSharedBackground(const SharedFrame &frame)
+{
+    const YuvPlanes planes(frame);
+    if (!planes.isValid()) {
+        return;
+    }
+    QImage img;
+    planes.toRgb(img);
+    slotGotBackground(img);
+}
+
 void TitleWidget::initAnimation()
 {
     align_box->setEnabled(false);
@@ -28,6 +28,7 @@
 #include <QSignalMapper>
 
 class Render;
+class SharedFrame;
 
 class TitleTemplate
 {
@@ -240,6 +241,8 @@ public slots:
     /** Load a title from a title file */
     void loadTitle(QUrl url = QUrl());
     void slotGotBackground(const QImage &img);
+    /** @brief Background frame sent by the monitor as yuv420p planes (when not using GPU accel) */
+    void slotGotSharedBackground(const SharedFrame &frame);
 
 private slots:
 